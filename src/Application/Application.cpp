@@ -4,14 +4,21 @@
 #include <polyscope/polyscope.h>
 #include <polyscope/surface_mesh.h>
 
+#include <algorithm>
 #include <iostream>
 
+#include "../Engine/PolyscopeVisualizationEngine.h"
 #include "../Examples/ExampleLoader.h"
+#include "../IO/Checkpoint.h"
+#include "../IO/MeshImporter.h"
 #include "../Scene/SceneObject.h"
 #include "../Utils/Helpers.h"
+#include "../Utils/Log.h"
+#include "../Utils/Profiler.h"
 
 namespace {  // Anonymous namespace for file-local scope
 Application* g_appInstance = nullptr;
+constexpr std::size_t kLogQueueCapacity = 4096;  // Messages per frame before the oldest are dropped
 
 void PolyscopeCallback() {
     if (g_appInstance) {
@@ -28,7 +35,12 @@ Application::Application() {
 }
 
 Application::~Application() {
+    m_evalWorker.reset();        // Joins any running evaluation before the scene goes away
+    m_checkpointWorker.reset();  // Finishes a save in progress
+    m_recorder.reset();          // Writes the queued frames and the index
     g_appInstance = nullptr;
+    Log::stopQueue();  // Delivers what is left while Polyscope is still up
+    Log::setSink(nullptr);
     polyscope::shutdown();
 }
 
@@ -36,11 +48,37 @@ void Application::Initialize(int argc, char** argv) {
     polyscope::options::programName = "TPE Interactive";
     polyscope::options::verbosity = m_config.Debug.verbosity;
     polyscope::init();
+    m_initialMeshPaths.assign(argv + std::min(argc, 1), argv + argc);
+
+    // Core modules log through Log; route them into Polyscope's console so verbosity is handled in one place.
+    // Messages are queued and drained once per frame on this thread, since Polyscope's console is not thread-safe
+    // and pool or background workers may log.
+    Log::setSink([](Log::Level level, const std::string& message) {
+        switch (level) {
+        case Log::Level::Debug:
+            polyscope::info(1, message);  // Shown at Polyscope verbosity 2
+            break;
+        case Log::Level::Info:
+            polyscope::info(message);
+            break;
+        case Log::Level::Warning:
+            polyscope::warning(message);
+            break;
+        case Log::Level::Error:
+            polyscope::error(message);
+            break;
+        }
+    });
+    Log::setVerbosity(m_config.Debug.verbosity);
+    Log::startQueue(kLogQueueCapacity);
+    Profiler::setEnabled(m_config.Debug.profiling);
 
     m_repulsorEngine = std::make_unique<RepulsorEngine>(m_config);
-    m_vizEngine = std::make_unique<VisualizationEngine>(m_config);
+    m_vizEngine = std::make_unique<PolyscopeVisualizationEngine>(m_config);
     m_sceneManager = std::make_unique<SceneManager>(*m_repulsorEngine, *m_vizEngine, m_config);
     m_uiManager = std::make_unique<UIManager>(m_config, *m_sceneManager, *this);
+    m_evalWorker = std::make_unique<Utils::BackgroundWorker>();
+    m_checkpointWorker = std::make_unique<Utils::BackgroundWorker>();
 
     SetupPolyscope();
     LoadInitialScene();
@@ -51,7 +89,11 @@ void Application::SetupPolyscope() {
 }
 
 void Application::LoadInitialScene() {
-    RequestExampleLoad(m_currentExample);
+    if (m_initialMeshPaths.empty()) {
+        RequestExampleLoad(m_currentExample);
+    } else {
+        RequestMeshLoad(m_initialMeshPaths);
+    }
 }
 
 void Application::Run() {
@@ -59,8 +101,97 @@ void Application::Run() {
 }
 
 void Application::MainLoopIteration() {
+    Log::drain();
     m_uiManager->DrawUI();
     CheckGizmoInteraction();
+    ProcessPendingSceneUpdates();
+    TPE_PROFILE_END_FRAME();
+}
+
+void Application::ProcessPendingSceneUpdates() {
+    PublishAsyncVectorFields();
+
+    // Playback only shows recorded frames; the Repulsor state catches up once it is closed.
+    if (m_player) {
+        AdvancePlayback();
+        return;
+    }
+
+    // While a background evaluation runs it owns the Repulsor state; transform changes keep accumulating
+    // and are flushed together once it is done.
+    if (m_evalWorker->IsBusy()) {
+        return;
+    }
+
+    // Every transform change seen since the last flush is applied at once, followed by at most one recalculation.
+    if (m_sceneManager->HasPendingUpdates()) {
+        m_sceneManager->FlushPendingUpdates();
+        if (m_config.Interactivity.realTimeDiff) {
+            RecalculateRealTimeVectorFieldsInternal();
+        }
+        m_vizEngine->RequestRedraw();
+    }
+
+    if (m_asyncRequested) {
+        m_asyncRequested = false;
+        StartAsyncVectorFields();
+    }
+}
+
+void Application::StartAsyncVectorFields() {
+    m_asyncJob.version = m_sceneVersion;
+    m_asyncJob.what = m_config.Interactivity.realTimeGrad ? EvalFlags::Differential | EvalFlags::Gradient
+                                                          : EvalFlags::Differential;
+    m_asyncJob.objects = m_sceneManager->GetSimulatedObjects();
+    m_asyncJob.frames.clear();
+    for (SceneObject* object : m_asyncJob.objects) {
+        m_asyncJob.frames.push_back(object->GetCurrentTransform());
+    }
+    m_asyncJob.results.clear();
+    m_asyncJob.done = false;
+
+    // The job only touches m_asyncJob and the flushed Repulsor state; everything else stays on this thread.
+    m_evalWorker->Submit([this] {
+        try {
+            m_asyncJob.results =
+                m_sceneManager->EvaluateCurrentState(m_asyncJob.objects, m_asyncJob.what, m_asyncJob.frames);
+        } catch (const std::exception& e) {
+            m_asyncJob.results.assign(m_asyncJob.objects.size(), BatchResult<EvaluationResult>());
+            for (auto& result : m_asyncJob.results) {
+                result.error = e.what();
+            }
+        }
+        m_asyncJob.done = true;
+    });
+}
+
+void Application::PublishAsyncVectorFields() {
+    // IsBusy() synchronizes with the end of the job, so m_asyncJob may only be read after it returns false.
+    if (m_evalWorker->IsBusy() || !m_asyncJob.done) {
+        return;
+    }
+    m_asyncJob.done = false;
+
+    // Latest wins: results for a scene state that has since changed are dropped; a newer request is already queued.
+    if (m_asyncJob.version != m_sceneVersion) {
+        TPE_LOG_DEBUG("Application: Dropped stale real-time vector fields.");
+        return;
+    }
+
+    StoreVectorFieldResults(m_asyncJob.objects, m_asyncJob.results, m_asyncJob.what);
+    UpdateDifferentialVisualsInternal();
+    if (HasFlag(m_asyncJob.what, EvalFlags::Gradient)) {
+        UpdateGradientVisualsInternal();
+    }
+}
+
+void Application::WaitForAsyncEvaluation() {
+    m_evalWorker->Wait();
+}
+
+void Application::MarkSceneChanged() {
+    ++m_sceneVersion;
+    InvalidateCalculationCache();
 }
 
 void Application::CheckGizmoInteraction() {
@@ -82,17 +213,7 @@ void Application::CheckGizmoInteraction() {
         if (!Utils::matricesAreClose(currentGizmoTransform, activeObj->GetCurrentTransform())) {
 
             m_sceneManager->UpdateObjectTransform(activeObjId, currentGizmoTransform);
-            InvalidateCalculationCache();
-
-            if (m_config.Interactivity.realTimeDiff) {
-                CalculateAllDifferentialsInternal();
-                UpdateDifferentialVisualsInternal();
-                if (m_config.Interactivity.realTimeGrad) {
-                    CalculateAllGradientsInternal();
-                    UpdateGradientVisualsInternal();
-                }
-            }
-            m_vizEngine->RequestRedraw();
+            MarkSceneChanged();
         }
     }
 }
@@ -100,10 +221,25 @@ void Application::CheckGizmoInteraction() {
 void Application::RequestExampleLoad(ExampleId exampleId) {
     polyscope::info("Application: Requesting load for example ID: " + std::to_string(static_cast<int>(exampleId)));
     m_currentExample = exampleId;
+    LoadSceneFrom([exampleId] { return ExampleLoader::LoadExample(exampleId); });
+}
+
+void Application::RequestMeshLoad(const std::vector<std::string>& paths) {
+    polyscope::info("Application: Requesting load of " + std::to_string(paths.size()) + " mesh file(s)");
+    LoadSceneFrom([&] { return IO::createMeshScene(paths, m_config.TPE.threadBudget); });
+}
+
+void Application::LoadSceneFrom(const std::function<SceneDefinition()>& buildScene) {
+    WaitForAsyncEvaluation();  // The job references objects of the scene about to be unloaded
+    RequestRecordingStop();    // So do the recording and the playback
+    m_player.reset();
+    m_playbackPlaying = false;
+    MarkSceneChanged();
+    m_asyncRequested = false;
+    Profiler::reset();  // Object ids are reused by the next scene
     try {
         m_vizEngine->RemoveAllObjects();
-        InvalidateCalculationCache();
-        SceneDefinition sceneDef = ExampleLoader::LoadExample(exampleId);
+        SceneDefinition sceneDef = buildScene();
         m_vizEngine->SetCameraView(sceneDef.initialCameraPosition, sceneDef.initialCameraLookAt, sceneDef.upDir,
                                    sceneDef.frontDir);
         bool loaded = m_sceneManager->LoadScene(sceneDef);
@@ -113,7 +249,7 @@ void Application::RequestExampleLoad(ExampleId exampleId) {
             polyscope::info("Application: Scene loaded successfully.");
         }
     } catch (const std::exception& e) {
-        polyscope::error("Application: Exception during example load: " + std::string(e.what()));
+        polyscope::error("Application: Exception during scene load: " + std::string(e.what()));
         m_sceneManager->UnloadScene();
     }
     m_vizEngine->RequestRedraw();
@@ -123,28 +259,39 @@ void Application::RequestPhysicsStep(int iterations) {
     if (iterations <= 0) {
         return;
     }
-    InvalidateCalculationCache();
-    m_sceneManager->ApplyPhysicsStep(iterations);
+    RequestPlaybackClose();  // Steps continue from the frame shown
+    WaitForAsyncEvaluation();
+    MarkSceneChanged();
+    const unsigned long long stepsBefore = m_sceneManager->GetCompletedSteps();
+    const bool recordFields = m_recorder && m_config.Recording.recordFields;
+    if (m_recorder) {
+        // One step at a time, so that every step becomes a frame
+        for (int iter = 0; iter < iterations && m_recorder; ++iter) {
+            if (!m_sceneManager->ApplyPhysicsStep(1)) {
+                break;
+            }
+            RecordTrajectoryFrame();
+        }
+    } else {
+        m_sceneManager->ApplyPhysicsStep(iterations);
+    }
+
+    const int autosaveSteps = m_config.Checkpoint.autosaveSteps;
+    if (autosaveSteps > 0 && m_sceneManager->GetCompletedSteps() / autosaveSteps != stepsBefore / autosaveSteps) {
+        RequestCheckpointSave();
+    }
 
     bool visuals_updated = false;
-    if (m_config.Interactivity.realTimeDiff) {
-        polyscope::info("Application: Recalculating Differential after physics step (real-time enabled)...");
-        CalculateAllDifferentialsInternal();
+    if (m_config.Interactivity.realTimeDiff && recordFields) {
+        // The last recorded frame already evaluated the current state
         UpdateDifferentialVisualsInternal();
-        visuals_updated = true;
-
         if (m_config.Interactivity.realTimeGrad) {
-            polyscope::info("Application: Recalculating Gradient after physics step (real-time enabled)...");
-            if (m_globalDiffValid) {
-                CalculateAllGradientsInternal();
-                UpdateGradientVisualsInternal();
-            } else {
-                polyscope::warning("Application: Skipping post-step gradient calculation as differential failed.");
-                UpdateGradientVisualsInternal();  // This will remove visuals if m_globalGradValid
-                                                  // is false
-            }
-            visuals_updated = true;
+            UpdateGradientVisualsInternal();
         }
+        visuals_updated = true;
+    } else if (m_config.Interactivity.realTimeDiff) {
+        RecalculateRealTimeVectorFieldsInternal();
+        visuals_updated = true;
     }
 
     if (!visuals_updated) {
@@ -152,41 +299,318 @@ void Application::RequestPhysicsStep(int iterations) {
     }
 }
 
+void Application::RequestCheckpointSave() {
+    if (IsCheckpointSaving()) {
+        polyscope::warning("Application: The previous checkpoint is still being written; not saving.");
+        return;
+    }
+    // The snapshot owns copies of the vertices, so steps may continue while the file is written
+    auto checkpoint = std::make_shared<IO::Checkpoint>();
+    checkpoint->config = m_config;
+    checkpoint->completedSteps = m_sceneManager->GetCompletedSteps();
+    checkpoint->scene = m_sceneManager->SnapshotScene();
+    if (checkpoint->scene.objectDefs.empty()) {
+        polyscope::warning("Application: No scene to checkpoint.");
+        return;
+    }
+
+    const std::string path = m_config.Checkpoint.path;
+    polyscope::info("Application: Saving checkpoint at step " + std::to_string(checkpoint->completedSteps) +
+                    " to " + path);
+    m_checkpointWorker->Submit([checkpoint, path] {
+        try {
+            IO::writeCheckpoint(path, *checkpoint);
+            Log::info("Checkpoint saved to " + path);
+        } catch (const std::exception& e) {
+            Log::error("Checkpoint save failed: " + std::string(e.what()));
+        }
+    });
+}
+
+void Application::RequestCheckpointRestore() {
+    const std::string path = m_config.Checkpoint.path;
+    polyscope::info("Application: Restoring checkpoint " + path);
+    m_checkpointWorker->Wait();  // A save in progress may be writing the same file
+
+    IO::Checkpoint checkpoint;
+    try {
+        checkpoint = IO::readCheckpoint(path, m_config);
+    } catch (const std::exception& e) {
+        polyscope::error("Application: " + std::string(e.what()));
+        return;
+    }
+
+    WaitForAsyncEvaluation();  // The job reads the settings replaced here
+    m_config = checkpoint.config;
+    LoadSceneFrom([&] {
+        m_repulsorEngine->UpdateEngineParameters();  // Meshes are created with the restored parameters
+        return std::move(checkpoint.scene);
+    });
+    m_sceneManager->SetCompletedSteps(checkpoint.completedSteps);
+    polyscope::info("Application: Resumed at step " + std::to_string(checkpoint.completedSteps));
+}
+
+void Application::RequestRecordingStart() {
+    if (m_recorder) {
+        return;
+    }
+    if (m_player) {
+        polyscope::warning("Application: Close playback before recording.");
+        return;
+    }
+    std::vector<IO::TrajectoryObject> objects;
+    for (const auto& objPtr : m_sceneManager->GetObjects()) {
+        objects.push_back({objPtr->GetId(), objPtr->GetInitialVertices().size()});
+    }
+    if (objects.empty()) {
+        polyscope::warning("Application: No scene to record.");
+        return;
+    }
+
+    IO::TrajectoryOptions options;
+    options.recordFields = m_config.Recording.recordFields;
+    options.quantum = m_config.Recording.quantum;
+    options.keyframeInterval = m_config.Recording.keyframeInterval;
+    options.queueFrames = m_config.Recording.queueFrames;
+    try {
+        m_recorder = std::make_unique<IO::TrajectoryRecorder>(m_config.Recording.path, std::move(objects), options);
+    } catch (const std::exception& e) {
+        polyscope::error("Application: " + std::string(e.what()));
+        return;
+    }
+    polyscope::info("Application: Recording to " + m_config.Recording.path);
+    RecordTrajectoryFrame();  // The state the recording starts from
+}
+
+void Application::RequestRecordingStop() {
+    if (!m_recorder) {
+        return;
+    }
+    m_recorder->Close();
+    polyscope::info("Application: Recorded " + std::to_string(m_recorder->GetRecordedFrames()) + " frame(s) (" +
+                    std::to_string(m_recorder->GetDroppedFrames()) + " dropped, " +
+                    std::to_string(m_recorder->GetBytesWritten() / 1024) + " KiB) to " + m_recorder->GetPath());
+    m_recorder.reset();
+}
+
+void Application::RecordTrajectoryFrame() {
+    if (m_config.Recording.recordFields) {
+        CalculateAllVectorFieldsInternal();
+    }
+
+    m_recordedObjects.clear();
+    for (const auto& objPtr : m_sceneManager->GetObjects()) {
+        IO::RecordedObject object;
+        object.vertices = objPtr->GetInitialVertices();
+        object.transform = objPtr->GetCurrentTransform();
+        auto it = m_vizCache.find(objPtr->GetId());
+        if (it != m_vizCache.end()) {
+            object.differential = it->second.diff_valid ? &it->second.diff_glm : nullptr;
+            object.gradient = it->second.grad_valid ? &it->second.grad_glm : nullptr;
+        }
+        m_recordedObjects.push_back(object);
+    }
+
+    try {
+        m_recorder->Record(m_sceneManager->GetCompletedSteps(), m_recordedObjects);
+    } catch (const std::exception& e) {
+        polyscope::error("Application: " + std::string(e.what()));
+    }
+    if (m_recorder->HasFailed()) {
+        polyscope::error("Application: Writing " + m_recorder->GetPath() + " failed; recording stopped.");
+        RequestRecordingStop();
+    }
+}
+
+void Application::RequestPlaybackOpen() {
+    if (m_recorder) {
+        polyscope::warning("Application: Stop recording before playing back.");
+        return;
+    }
+    const std::string path = m_config.Recording.path;
+    std::unique_ptr<IO::TrajectoryReader> player;
+    try {
+        player = std::make_unique<IO::TrajectoryReader>(path);
+    } catch (const std::exception& e) {
+        polyscope::error("Application: " + std::string(e.what()));
+        return;
+    }
+    if (player->GetFrameCount() == 0) {
+        polyscope::warning("Application: " + path + " holds no frames.");
+        return;
+    }
+    for (const IO::TrajectoryObject& object : player->GetObjects()) {
+        SceneObject* sceneObject = m_sceneManager->GetObjectById(object.id);
+        if (!sceneObject || sceneObject->GetInitialVertices().size() != object.vertexCount) {
+            polyscope::error("Application: " + path + " was recorded on another scene (no match for object " +
+                             std::to_string(object.id) + ").");
+            return;
+        }
+    }
+
+    WaitForAsyncEvaluation();  // Frames replace vertices the job may be reading
+    m_player = std::move(player);
+    m_playbackPlaying = false;
+    polyscope::info("Application: Playing back " + std::to_string(m_player->GetFrameCount()) + " frame(s) of " +
+                    path + ", steps " + std::to_string(m_player->GetStep(0)) + " to " +
+                    std::to_string(m_player->GetStep(m_player->GetFrameCount() - 1)));
+    ShowPlaybackFrame(0);
+}
+
+void Application::RequestPlaybackClose() {
+    if (!m_player) {
+        return;
+    }
+    m_sceneManager->SetCompletedSteps(m_player->GetStep(m_playbackFrame));
+    m_player.reset();
+    m_playbackPlaying = false;
+    polyscope::info("Application: Playback closed; resuming from step " +
+                    std::to_string(m_sceneManager->GetCompletedSteps()));
+}
+
+void Application::RequestPlaybackSeek(int frame) {
+    if (!m_player) {
+        return;
+    }
+    const int lastFrame = static_cast<int>(m_player->GetFrameCount()) - 1;
+    ShowPlaybackFrame(static_cast<std::size_t>(std::clamp(frame, 0, lastFrame)));
+    m_playbackClock = std::chrono::steady_clock::now();
+}
+
+void Application::SetPlaybackPlaying(bool playing) {
+    if (!m_player) {
+        return;
+    }
+    if (playing && m_playbackFrame + 1 == m_player->GetFrameCount()) {
+        ShowPlaybackFrame(0);  // Play again from the start
+    }
+    m_playbackPlaying = playing;
+    m_playbackClock = std::chrono::steady_clock::now();
+}
+
+void Application::AdvancePlayback() {
+    if (!m_playbackPlaying) {
+        return;
+    }
+    // Frames are due at a fixed rate; when drawing is slower than that, frames are skipped rather than slowed down
+    const std::chrono::duration<double> frameTime(1.0 / std::max(m_config.Recording.playbackFps, 1.0f));
+    const auto now = std::chrono::steady_clock::now();
+    const auto dueFrames = static_cast<std::size_t>((now - m_playbackClock) / frameTime);
+    if (dueFrames == 0) {
+        return;
+    }
+    m_playbackClock += std::chrono::duration_cast<std::chrono::steady_clock::duration>(frameTime * dueFrames);
+
+    const std::size_t lastFrame = m_player->GetFrameCount() - 1;
+    const std::size_t frame = std::min(m_playbackFrame + dueFrames, lastFrame);
+    if (frame == lastFrame) {
+        m_playbackPlaying = false;
+    }
+    ShowPlaybackFrame(frame);
+}
+
+void Application::ShowPlaybackFrame(std::size_t frame) {
+    const IO::TrajectoryFrame* recorded = nullptr;
+    try {
+        recorded = &m_player->Seek(frame);
+    } catch (const std::exception& e) {
+        polyscope::error("Application: " + std::string(e.what()));
+        m_playbackPlaying = false;
+        return;
+    }
+    m_playbackFrame = frame;
+    MarkSceneChanged();
+
+    const bool hasFields = m_player->HasFields();
+    const std::vector<IO::TrajectoryObject>& objects = m_player->GetObjects();
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        const IO::TrajectoryObject& object = objects[i];
+        Utils::VertexSpan vertices(recorded->vertices.data() + offset, object.vertexCount);
+        m_sceneManager->SetObjectState(object.id, vertices, recorded->transforms[i]);
+
+        const SceneObject* sceneObject = m_sceneManager->GetObjectById(object.id);
+        if (hasFields && sceneObject && sceneObject->IsSimulated()) {
+            VizCalculationCache& cache = m_vizCache[object.id];
+            cache.diff_glm.assign(recorded->differential.begin() + offset,
+                                  recorded->differential.begin() + offset + object.vertexCount);
+            cache.grad_glm.assign(recorded->gradient.begin() + offset,
+                                  recorded->gradient.begin() + offset + object.vertexCount);
+            cache.diff_valid = true;
+            cache.grad_valid = true;
+        }
+        offset += object.vertexCount;
+    }
+    m_globalDiffValid = hasFields;
+    m_globalGradValid = hasFields;
+    UpdateDifferentialVisualsInternal();  // Without recorded fields, this removes arrows of another state
+    UpdateGradientVisualsInternal();
+}
+
 void Application::RequestRepulsorParamUpdate() {
     polyscope::info("Application: Repulsor parameter update requested.");
-    InvalidateCalculationCache();
+    WaitForAsyncEvaluation();
+    MarkSceneChanged();
     m_sceneManager->UpdateEngineParametersForAllObjects();
 
     if (m_config.Interactivity.realTimeDiff) {
-        polyscope::info("Application: Recalculating Differential after physics step (real-time enabled)...");
+        RecalculateRealTimeVectorFieldsInternal();
+    }
+}
+
+void Application::RequestObstacleUpdate() {
+    polyscope::info("Application: Obstacle update requested.");
+    WaitForAsyncEvaluation();
+    MarkSceneChanged();
+    m_sceneManager->RefreshObstacles();
+
+    if (m_config.Interactivity.realTimeDiff) {
+        RecalculateRealTimeVectorFieldsInternal();
+    }
+}
+
+void Application::RecalculateRealTimeVectorFieldsInternal() {
+    if (m_config.Interactivity.asyncRealTime) {
+        m_asyncRequested = true;  // Started by ProcessPendingSceneUpdates once the worker is free
+        return;
+    }
+    if (m_config.Interactivity.realTimeGrad) {
+        TPE_LOG_DEBUG("Application: Recalculating Differential and Gradient (real-time enabled)...");
+        CalculateAllVectorFieldsInternal();
+        UpdateDifferentialVisualsInternal();
+        UpdateGradientVisualsInternal();  // Removes gradient visuals if the evaluation failed
+    } else {
+        TPE_LOG_DEBUG("Application: Recalculating Differential (real-time enabled)...");
         CalculateAllDifferentialsInternal();
         UpdateDifferentialVisualsInternal();
-
-        if (m_config.Interactivity.realTimeGrad) {
-            polyscope::info("Application: Recalculating Gradient after physics step (real-time enabled)...");
-            if (m_globalDiffValid) {
-                CalculateAllGradientsInternal();
-                UpdateGradientVisualsInternal();
-            } else {
-                polyscope::warning("Application: Skipping post-step gradient calculation as differential failed.");
-                UpdateGradientVisualsInternal();  // This will remove visuals if m_globalGradValid
-                                                  // is false
-            }
-        }
     }
 }
 
 void Application::RequestPrintEnergy() {
+    WaitForAsyncEvaluation();
     polyscope::info("--- Energy Report ---");
-    for (const auto& objPtr : m_sceneManager->GetObjects()) {
-        if (objPtr->IsSimulated()) {
-            try {
-                Real energy = m_repulsorEngine->GetEnergy(*objPtr);
-                polyscope::info(objPtr->GetUniqueName() + ": " + std::to_string(energy));
-            } catch (...) {
-                polyscope::info(objPtr->GetUniqueName() + ": Error calculating energy.");
+    std::vector<SceneObject*> simulated = m_sceneManager->GetSimulatedObjects();
+    try {
+        auto energies = m_sceneManager->EvaluateObjects(simulated, EvalFlags::Energy);
+        if (m_sceneManager->IsSharedObstacleActive() && !energies.empty()) {
+            // The shared scene mesh has a single, non-separable energy.
+            if (energies[0].ok) {
+                polyscope::info("Scene (shared obstacle): " + std::to_string(energies[0].value.energy));
+            } else {
+                polyscope::info("Scene (shared obstacle): Error calculating energy.");
             }
+            energies.clear();
         }
+        for (size_t i = 0; i < energies.size(); ++i) {
+            if (energies[i].ok) {
+                polyscope::info(simulated[i]->GetUniqueName() + ": " + std::to_string(energies[i].value.energy));
+            } else {
+                polyscope::info(simulated[i]->GetUniqueName() + ": Error calculating energy (" + energies[i].error +
+                                ").");
+            }
+        }
+    } catch (const std::exception& e) {
+        polyscope::error("Application: Energy calculation failed: " + std::string(e.what()));
     }
     polyscope::info("---------------------");
 }
@@ -198,17 +622,19 @@ void Application::RequestDebugMeshCreation(int objectId) {
         return;
     }
 
+    WaitForAsyncEvaluation();
+    m_sceneManager->FlushPendingUpdates();  // The debug mesh shows the Repulsor state, which must be current
     std::string debugName = obj->GetUniqueName() + "_DebugState";
     polyscope::info("Requesting debug mesh creation: " + debugName);
 
     try {
-        Tensors::Tensor2<Real, Int> worldCoords = obj->GetRepulsorMesh()->VertexCoordinates();
+        const auto& worldCoords = obj->GetRepulsorMesh()->VertexCoordinates();
         if (worldCoords.Dimension(0) == 0) {
             polyscope::warning("Debug Mesh Request: Repulsor mesh has no vertices.");
             return;
         }
 
-        std::vector<std::array<Real, 3>> verts = Utils::tensorToVecArray(worldCoords);
+        Utils::VertexSpan verts = Utils::tensorRows(worldCoords);
         const auto& faces = obj->GetSimplices();
 
         if (verts.empty() || faces.empty()) {
@@ -234,52 +660,19 @@ void Application::RequestDebugMeshCreation(int objectId) {
 }
 
 void Application::InvalidateCalculationCache() {
-    polyscope::info("Application: Invalidating calculation cache...");
+    TPE_LOG_DEBUG("Application: Invalidating calculation cache...");
     m_vizCache.clear();
     m_globalDiffValid = false;
     m_globalGradValid = false;
 }
 
 void Application::CalculateAllDifferentialsInternal() {
-    polyscope::info("Application: Calculating all differentials...");
-    if (!m_repulsorEngine || !m_sceneManager) {
-        return;
-    }
-
-    InvalidateCalculationCache();
-    bool all_ok = true;
-
-    for (const auto& objPtr : m_sceneManager->GetObjects()) {
-        if (!objPtr->IsSimulated() || !objPtr->GetRepulsorMesh()) {
-            continue;
-        }
-
-        int id = objPtr->GetId();
-        m_vizCache[id] = VizCalculationCache();
-
-        try {
-            Tensors::Tensor2<Real, Int> diff_tensor =
-                m_repulsorEngine->GetDifferential(*objPtr);
-            m_vizCache[id].diff_glm = Utils::tensorToGlmVec3(diff_tensor);
-            m_vizCache[id].diff_valid = true;
-
-        } catch (const std::exception& e) {
-            polyscope::error("Application: Failed differential calc for " + objPtr->GetUniqueName() + ": " + e.what());
-            m_vizCache[id].diff_valid = false;
-            all_ok = false;
-        }
-    }
-    m_globalDiffValid = all_ok;
-    polyscope::info("Differential calculation complete. Overall validity: " +
-                    std::string(m_globalDiffValid ? "OK" : "FAILED"));
+    TPE_LOG_DEBUG("Application: Calculating all differentials...");
+    CalculateVectorFieldsInternal(EvalFlags::Differential);
 }
 
 void Application::CalculateAllGradientsInternal() {
-    polyscope::info("Application: Calculating all gradients...");
-    if (!m_repulsorEngine || !m_sceneManager) {
-        return;
-    }
-
+    TPE_LOG_DEBUG("Application: Calculating all gradients...");
     if (!m_globalDiffValid) {
         polyscope::warning("Application: Cannot calculate gradients, differentials invalid.");
         m_globalGradValid = false;  // Ensure grad is marked invalid
@@ -289,40 +682,63 @@ void Application::CalculateAllGradientsInternal() {
         return;
     }
 
-    bool all_ok = true;
-    for (const auto& objPtr : m_sceneManager->GetObjects()) {
-        if (!objPtr->IsSimulated() || !objPtr->GetRepulsorMesh()) {
-            continue;
-        }
+    // The gradient solve needs the differential anyway, so refresh both from the same evaluation.
+    CalculateVectorFieldsInternal(EvalFlags::Differential | EvalFlags::Gradient);
+}
 
-        int id = objPtr->GetId();
+void Application::CalculateAllVectorFieldsInternal() {
+    TPE_LOG_DEBUG("Application: Calculating all differentials and gradients...");
+    CalculateVectorFieldsInternal(EvalFlags::Differential | EvalFlags::Gradient);
+}
 
-        if (!m_vizCache.count(id) || !m_vizCache[id].diff_valid) {
-            polyscope::warning("Application: Skipping gradient for " + objPtr->GetUniqueName() +
-                               ", differential invalid/missing.");
-            m_vizCache[id].grad_valid = false;
-            all_ok = false;
-            continue;
-        }
+void Application::CalculateVectorFieldsInternal(EvalFlags what) {
+    if (!m_repulsorEngine || !m_sceneManager) {
+        return;
+    }
+    WaitForAsyncEvaluation();
 
-        try {
-            Tensors::Tensor2<Real, Int> grad_tensor = m_repulsorEngine->GetGradient(*objPtr);
-            m_vizCache[id].grad_glm = Utils::tensorToGlmVec3(grad_tensor);
-            m_vizCache[id].grad_valid = true;
+    std::vector<SceneObject*> simulated = m_sceneManager->GetSimulatedObjects();
+    std::vector<BatchResult<EvaluationResult>> results;
+    try {
+        results = m_sceneManager->EvaluateObjects(simulated, what);
+    } catch (const std::exception& e) {
+        polyscope::error("Application: Failed vector field calc: " + std::string(e.what()));
+        results.resize(simulated.size());
+    }
+    StoreVectorFieldResults(simulated, results, what);
+}
 
-        } catch (const std::exception& e) {
-            polyscope::error("Application: Failed gradient calc for " + objPtr->GetUniqueName() + ": " + e.what());
-            m_vizCache[id].grad_valid = false;
+void Application::StoreVectorFieldResults(const std::vector<SceneObject*>& objects,
+                                          const std::vector<BatchResult<EvaluationResult>>& results, EvalFlags what) {
+    InvalidateCalculationCache();
+    const bool wantGrad = HasFlag(what, EvalFlags::Gradient);
+    bool all_ok = true;
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        int id = objects[i]->GetId();
+        VizCalculationCache& cache = m_vizCache[id];
+
+        if (results[i].ok) {
+            cache.diff_glm = Utils::tensorToGlmVec3(results[i].value.differential);
+            cache.diff_valid = true;
+            if (wantGrad) {
+                cache.grad_glm = Utils::tensorToGlmVec3(results[i].value.gradient);
+                cache.grad_valid = true;
+            }
+        } else {
+            polyscope::error("Application: Vector field calc failed for " + objects[i]->GetUniqueName() + ": " +
+                             results[i].error);
             all_ok = false;
         }
     }
-    m_globalGradValid = all_ok;
-    polyscope::info("Gradient calculation complete. Overall validity: " +
-                    std::string(m_globalGradValid ? "OK" : "FAILED"));
+
+    m_globalDiffValid = all_ok;
+    m_globalGradValid = wantGrad && all_ok;
+    TPE_LOG_DEBUG("Vector field calculation complete. Overall validity: ", all_ok ? "OK" : "FAILED");
 }
 
 void Application::UpdateDifferentialVisualsInternal() {
-    polyscope::info("Application: Updating differential visuals...");
+    TPE_LOG_DEBUG("Application: Updating differential visuals...");
     if (!m_vizEngine || !m_sceneManager) {
         return;
     }
@@ -339,7 +755,7 @@ void Application::UpdateDifferentialVisualsInternal() {
 }
 
 void Application::UpdateGradientVisualsInternal() {
-    polyscope::info("Application: Updating gradient visuals...");
+    TPE_LOG_DEBUG("Application: Updating gradient visuals...");
     if (!m_vizEngine || !m_sceneManager) {
         return;
     }
@@ -361,26 +777,23 @@ void Application::RequestCalculateAndShowDifferential() {
 }
 
 void Application::RequestCalculateAndShowGradient() {
-    if (!m_globalDiffValid) {
-        CalculateAllDifferentialsInternal();
-        UpdateDifferentialVisualsInternal();
+    if (m_globalDiffValid && m_globalGradValid) {
+        return;
     }
 
-    if (m_globalDiffValid) {
-        if (!m_globalGradValid) {
-            CalculateAllGradientsInternal();
-            UpdateGradientVisualsInternal();
-        }
-    } else {
+    // Differential and gradient come out of the same evaluation.
+    CalculateAllVectorFieldsInternal();
+    UpdateDifferentialVisualsInternal();
+    if (!m_globalDiffValid) {
         polyscope::warning("Application: Cannot show gradient, differential calculation failed.");
-        // Ensure gradient visuals are removed if diff failed
-        UpdateGradientVisualsInternal();
     }
+    // Removes gradient visuals if the evaluation failed
+    UpdateGradientVisualsInternal();
 }
 
 void Application::RequestVectorVisualsUpdate() {
     // Called when display config (log scale, linear scale) changes
-    polyscope::info("Application: Updating vector visuals based on display settings...");
+    TPE_LOG_DEBUG("Application: Updating vector visuals based on display settings...");
     UpdateDifferentialVisualsInternal();
     UpdateGradientVisualsInternal();
 }
@@ -404,6 +817,7 @@ void Application::RequestVerbosityUpdate(int newLevel) {
     }
 
     polyscope::options::verbosity = newLevel;
+    Log::setVerbosity(newLevel);
     m_config.Debug.verbosity = newLevel;  // Ensure config stays in sync
     polyscope::info("Application: Verbosity set to " + std::to_string(newLevel));
 }
@@ -1,17 +1,23 @@
 #ifndef APPLICATION_H
 #define APPLICATION_H
 
+#include <chrono>
+#include <cstddef>
 #include <glm/glm.hpp>
+#include <functional>
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "../Config/Config.h"
 #include "../Data/SceneDefinition.h"
 #include "../Engine/RepulsorEngine.h"
 #include "../Engine/VisualizationEngine.h"
+#include "../IO/Trajectory.h"
 #include "../Scene/SceneManager.h"
 #include "../UI/UIManager.h"
+#include "../Utils/BackgroundWorker.h"
 
 struct VizCalculationCache {
     // Store data needed for visualization
@@ -29,15 +35,17 @@ class Application {
     Application();
     ~Application();
 
-    void Initialize(int argc, char** argv);
+    void Initialize(int argc, char** argv);  // Arguments are OBJ/PLY files to load instead of the default example
     void Run();
 
     // --- Callbacks / Event Handlers ---
     void MainLoopIteration();  // Called by Polyscope each frame
     void CheckGizmoInteraction();
+    void ProcessPendingSceneUpdates();  // Once per frame, after all input has been handled
 
     // --- Actions Triggered by UI ---
     void RequestExampleLoad(ExampleId exampleId);
+    void RequestMeshLoad(const std::vector<std::string>& paths);
     void RequestPhysicsStep(int iterations);
     void RequestRepulsorParamUpdate();
     void RequestPrintEnergy();
@@ -46,16 +54,69 @@ class Application {
     void RequestCalculateAndShowGradient();
     void RequestVectorVisualsUpdate();
     void RequestObstacleVisualToggle(bool show);
+    void RequestObstacleUpdate();  // Obstacle selection settings changed
     void RequestVerbosityUpdate(int newLevel);
+    // Snapshots the scene now and writes it to Checkpoint.path on a background thread
+    void RequestCheckpointSave();
+    // Replaces the scene and the stored settings with those of the checkpoint at Checkpoint.path
+    void RequestCheckpointRestore();
+
+    // --- Trajectory Recording and Playback ---
+    // Records the current state and every following physics step to Recording.path until stopped
+    void RequestRecordingStart();
+    void RequestRecordingStop();  // Waits for the queued frames to be written
+    // Shows the frames of Recording.path on the loaded scene, which must contain the recorded objects, without
+    // evaluating anything. Closing playback, or taking a physics step, resumes the simulation from the frame shown.
+    void RequestPlaybackOpen();
+    void RequestPlaybackClose();
+    void RequestPlaybackSeek(int frame);
+    void SetPlaybackPlaying(bool playing);
+
+    const IO::TrajectoryRecorder* GetRecorder() const {
+        return m_recorder.get();
+    }
+    const IO::TrajectoryReader* GetPlayer() const {
+        return m_player.get();
+    }
+    std::size_t GetPlaybackFrame() const {
+        return m_playbackFrame;
+    }
+    bool IsPlaybackPlaying() const {
+        return m_playbackPlaying;
+    }
+
+    bool IsAsyncEvaluationRunning() const {
+        return m_evalWorker && m_evalWorker->IsBusy();
+    }
+    bool IsCheckpointSaving() const {
+        return m_checkpointWorker && m_checkpointWorker->IsBusy();
+    }
 
   private:
     void SetupPolyscope();
     void LoadInitialScene();
+    void LoadSceneFrom(const std::function<SceneDefinition()>& buildScene);
     void CalculateAllDifferentialsInternal();
     void CalculateAllGradientsInternal();
+    void CalculateAllVectorFieldsInternal();  // Differentials and gradients from one evaluation
+    void CalculateVectorFieldsInternal(EvalFlags what);
+    void StoreVectorFieldResults(const std::vector<SceneObject*>& objects,
+                                 const std::vector<BatchResult<EvaluationResult>>& results, EvalFlags what);
+    void RecalculateRealTimeVectorFieldsInternal();
     void UpdateDifferentialVisualsInternal();
     void UpdateGradientVisualsInternal();
     void InvalidateCalculationCache();
+    void MarkSceneChanged();  // New scene version; in-flight real-time results become stale
+
+    // --- Asynchronous Real-time Vector Fields ---
+    void StartAsyncVectorFields();
+    void PublishAsyncVectorFields();
+    void WaitForAsyncEvaluation();  // Required before anything else touches Repulsor state
+
+    // --- Trajectories ---
+    void RecordTrajectoryFrame();  // With Recording.recordFields, evaluates the vector fields first
+    void ShowPlaybackFrame(std::size_t frame);
+    void AdvancePlayback();  // Once per frame while playing, at Recording.playbackFps
 
     ConfigType m_config;
 
@@ -63,12 +124,35 @@ class Application {
     std::unique_ptr<VisualizationEngine> m_vizEngine;
     std::unique_ptr<SceneManager> m_sceneManager;
     std::unique_ptr<UIManager> m_uiManager;
+    std::unique_ptr<Utils::BackgroundWorker> m_evalWorker;
+    std::unique_ptr<Utils::BackgroundWorker> m_checkpointWorker;  // Writes checkpoints from their snapshots
 
     ExampleId m_currentExample = ExampleId::FCC_4;
+    std::vector<std::string> m_initialMeshPaths;  // From the command line
 
     std::map<int, VizCalculationCache> m_vizCache;
     bool m_globalDiffValid = false;
     bool m_globalGradValid = false;
+
+    // One real-time evaluation in flight at a time. Written by the worker job, read here only once it is idle.
+    struct AsyncVectorFieldJob {
+        unsigned long long version = 0;
+        EvalFlags what = EvalFlags::None;
+        std::vector<SceneObject*> objects;
+        std::vector<glm::mat4> frames;  // Transforms at submission; the gizmo may move objects while the job runs
+        std::vector<BatchResult<EvaluationResult>> results;
+        bool done = false;
+    };
+    AsyncVectorFieldJob m_asyncJob;
+    unsigned long long m_sceneVersion = 0;  // Bumped by every change that invalidates vector fields
+    bool m_asyncRequested = false;
+
+    std::unique_ptr<IO::TrajectoryRecorder> m_recorder;  // While recording
+    std::vector<IO::RecordedObject> m_recordedObjects;   // Reused by every recorded frame
+    std::unique_ptr<IO::TrajectoryReader> m_player;      // While playing back
+    std::size_t m_playbackFrame = 0;
+    bool m_playbackPlaying = false;
+    std::chrono::steady_clock::time_point m_playbackClock;  // When m_playbackFrame was due
 };
 
 #endif  // APPLICATION_H
\ No newline at end of file
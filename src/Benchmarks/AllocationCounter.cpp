@@ -0,0 +1,75 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+
+void* allocate(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* allocateAligned(std::size_t size, std::size_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    size = (size + alignment - 1) / alignment * alignment;  // aligned_alloc wants a multiple of the alignment
+#ifdef _MSC_VER
+    void* p = _aligned_malloc(size > 0 ? size : alignment, alignment);
+#else
+    void* p = std::aligned_alloc(alignment, size > 0 ? size : alignment);
+#endif
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void deallocateAligned(void* p) {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+}  // namespace
+
+namespace AllocationCounter {
+
+std::uint64_t Count() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+}  // namespace AllocationCounter
+
+// --- Replaced global allocation functions ---
+// The array and nothrow forms default to these; the sized deletes are spelled out since compilers warn otherwise.
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateAligned(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    deallocateAligned(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    deallocateAligned(p);
+}
@@ -0,0 +1,15 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+// Counts calls to the global operator new in this process. AllocationCounter.cpp replaces the global allocation
+// functions, so it is only linked into the benchmark executable. Every allocation is counted, including those
+// made inside Repulsor and the standard library.
+namespace AllocationCounter {
+
+std::uint64_t Count();  // Allocations since process start, over all threads
+
+}  // namespace AllocationCounter
+
+#endif  // ALLOCATION_COUNTER_H
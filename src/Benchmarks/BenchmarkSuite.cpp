@@ -0,0 +1,402 @@
+#include "BenchmarkSuite.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include "../Engine/RepulsorEngine.h"
+#include "../Engine/VisualizationEngine.h"
+#include "../Examples/Icosphere.h"
+#include "../Scene/SceneManager.h"
+#include "../Scene/SceneObject.h"
+#include "../Utils/Helpers.h"
+#include "../Utils/Log.h"
+#include "../Utils/ThreadPool.h"
+#include "../Utils/TransformKernels.h"
+#include "AllocationCounter.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kSphereRadius = 1.0;
+constexpr double kCenterSeparation = 2.4 * kSphereRadius;  // Same spacing as the FCC example
+
+// The n lattice sites closest to the origin, at kCenterSeparation between nearest neighbours
+std::vector<glm::vec3> fccCenters(int count) {
+    std::vector<glm::vec3> centers;
+    const double scale = kCenterSeparation / std::sqrt(2.0);
+    for (int n = 1; static_cast<int>(centers.size()) < count; ++n) {
+        centers.clear();
+        for (int i = -n; i <= n; ++i) {
+            for (int j = -n; j <= n; ++j) {
+                for (int k = -n; k <= n; ++k) {
+                    if ((i + j + k) % 2 == 0) {
+                        centers.emplace_back(i * scale, j * scale, k * scale);
+                    }
+                }
+            }
+        }
+    }
+    std::stable_sort(centers.begin(), centers.end(),
+                     [](const glm::vec3& a, const glm::vec3& b) { return glm::dot(a, a) < glm::dot(b, b); });
+    centers.resize(count);
+    return centers;
+}
+
+template <typename T>
+void throwOnFailure(const std::vector<BatchResult<T>>& results) {
+    for (const auto& result : results) {
+        if (!result.ok) {
+            throw std::runtime_error(result.error);
+        }
+    }
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += ' ';
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::vector<int> parseIntList(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::stoi(item));
+    }
+    if (values.empty()) {
+        throw std::invalid_argument("empty list");
+    }
+    return values;
+}
+
+}  // namespace
+
+BenchmarkSuite::BenchmarkSuite(const BenchmarkOptions& options) : m_options(options) {
+    m_config.Debug.verbosity = 0;
+    // Warm starts would make every repetition after the first cheaper than a real step
+    m_config.TPE.solverWarmStart = false;
+}
+
+SceneDefinition BenchmarkSuite::CreateLatticeScene(int sphereCount, int subdivisions) {
+    auto sphere = std::make_shared<MeshData>(createIcosphere(subdivisions, kSphereRadius));
+
+    SceneDefinition scene;
+    scene.sceneName = "Benchmark lattice " + std::to_string(sphereCount) + "x" + std::to_string(subdivisions);
+
+    std::vector<glm::vec3> centers = fccCenters(sphereCount);
+    for (int i = 0; i < sphereCount; ++i) {
+        auto meshData = std::make_shared<MeshData>(*sphere);  // Copies vertices; the topology stays shared
+        for (auto& v : meshData->vertices) {
+            for (int d = 0; d < amb_dim; ++d) {
+                v[d] += centers[i][d];
+            }
+        }
+        scene.objectDefs.emplace_back(i, "sphere", meshData, true, true, true, std::vector<int>{-1});
+    }
+    return scene;
+}
+
+int BenchmarkSuite::Run() {
+    for (int subdivisions : m_options.subdivisions) {
+        for (int sphereCount : m_options.sphereCounts) {
+            SceneDefinition scene = CreateLatticeScene(sphereCount, subdivisions);
+            bool first = true;
+            for (int threads : m_options.threadCounts) {
+                for (int objectThreads : m_options.objectThreadCounts) {
+                    m_config.TPE.threadCount = threads;
+                    m_config.TPE.objectThreadCount = objectThreads;
+                    std::cerr << "Benchmarking " << sphereCount << " spheres, subdivision " << subdivisions
+                              << ", threads " << threads << ", object threads " << objectThreads << std::endl;
+                    RunScene(scene, sphereCount, subdivisions, first);
+                    first = false;
+                }
+            }
+        }
+    }
+
+    bool allOk = std::all_of(m_records.begin(), m_records.end(), [](const BenchmarkRecord& r) { return r.ok; });
+    if (m_options.outputPath.empty()) {
+        WriteJson(std::cout);
+    } else {
+        std::ofstream file(m_options.outputPath);
+        if (!file) {
+            std::cerr << "Cannot open output file " << m_options.outputPath << std::endl;
+            return EXIT_FAILURE;
+        }
+        WriteJson(file);
+    }
+    return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void BenchmarkSuite::RunScene(const SceneDefinition& scene, int sphereCount, int subdivisions,
+                              bool runThreadIndependent) {
+    RepulsorEngine repulsorEngine(m_config);
+    NullVisualizationEngine vizEngine;
+    SceneManager sceneManager(repulsorEngine, vizEngine, m_config);
+
+    BenchmarkRecord base;
+    base.sphereCount = sphereCount;
+    base.subdivisions = subdivisions;
+    base.threadCount = m_config.TPE.threadCount;
+    base.objectThreadCount = m_config.TPE.objectThreadCount;
+    base.repetitions = m_options.repetitions;
+
+    size_t sceneVertices = 0;
+    for (const auto& def : scene.objectDefs) {
+        sceneVertices += def.meshData->vertices.size();
+    }
+    auto stage = [&](const char* name, size_t vertexCount) {
+        BenchmarkRecord record = base;
+        record.stage = name;
+        record.vertexCount = vertexCount;
+        return record;
+    };
+
+    // --- Mesh creation, on standalone objects so the loaded scene keeps its meshes ---
+    std::vector<std::unique_ptr<SceneObject>> standalone;
+    std::vector<size_t> vertexCounts;
+    for (const auto& def : scene.objectDefs) {
+        standalone.push_back(std::make_unique<SceneObject>(def));
+        vertexCounts.push_back(def.meshData->vertices.size());
+    }
+    repulsorEngine.PlanThreads(vertexCounts);  // As LoadScene does, so the meshes get the same thread counts
+    m_records.push_back(Time(
+        stage("initialize_mesh", sceneVertices),
+        [&] {
+            for (auto& obj : standalone) {
+                obj->SetRepulsorMesh(nullptr);
+            }
+        },
+        [&] {
+            for (auto& obj : standalone) {
+                if (!repulsorEngine.InitializeRepulsorMesh(*obj)) {
+                    throw std::runtime_error("InitializeRepulsorMesh failed for " + obj->GetUniqueName());
+                }
+            }
+        }));
+    standalone.clear();
+
+    if (!sceneManager.LoadScene(scene)) {
+        BenchmarkRecord failed = stage("load_scene", sceneVertices);
+        failed.ok = false;
+        failed.error = "LoadScene failed";
+        m_records.push_back(failed);
+        return;
+    }
+    std::vector<SceneObject*> simulated = sceneManager.GetSimulatedObjects();
+
+    // --- Transforms (single-threaded, so only run once per scene) ---
+    if (runThreadIndependent) {
+        glm::mat4 transform = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(0.1f, -0.2f, 0.3f)), 0.25f,
+                                          glm::vec3(0.f, 1.f, 0.f));
+        m_records.push_back(Time(stage("apply_transform", sceneVertices), [] {}, [&] {
+            for (SceneObject* obj : simulated) {
+                std::vector<std::array<Real, amb_dim>> world = Utils::applyTransform(obj->GetInitialVertices(),
+                                                                                     transform);
+                if (world.size() != obj->GetInitialVertices().size()) {
+                    throw std::runtime_error("applyTransform returned a wrong vertex count");
+                }
+            }
+        }));
+    }
+
+    // --- Obstacle updates after every object moved ---
+    size_t obstacleVertices = 0;
+    for (SceneObject* obj : simulated) {
+        if (const Mesh_T* obstacle = obj->GetObstacleMesh()) {
+            obstacleVertices += obstacle->VertexCount();
+        }
+    }
+    float offset = 0.0f;
+    m_records.push_back(Time(
+        stage("update_obstacles", obstacleVertices),
+        [&] {
+            offset = offset > 0.0f ? -0.01f : 0.01f;
+            for (SceneObject* obj : simulated) {
+                sceneManager.UpdateObjectTransform(obj->GetId(),
+                                                   glm::translate(glm::mat4(1.0f), glm::vec3(offset, 0.f, 0.f)));
+            }
+            sceneManager.FlushPendingUpdates();
+        },
+        [&] { sceneManager.RefreshObstacles(); }));
+
+    // --- One object dragged, as in a gizmo frame: only the obstacles containing it are updated ---
+    if (!simulated.empty()) {
+        float dragOffset = 0.0f;
+        m_records.push_back(Time(stage("move_object", obstacleVertices), [] {}, [&] {
+            dragOffset = dragOffset > 0.0f ? -0.01f : 0.01f;
+            sceneManager.UpdateObjectTransform(simulated.front()->GetId(),
+                                               glm::translate(glm::mat4(1.0f), glm::vec3(0.f, dragOffset, 0.f)));
+            sceneManager.FlushPendingUpdates();
+        }));
+    }
+
+    // --- Physics queries ---
+    m_records.push_back(Time(stage("world_displacement", sceneVertices), [] {}, [&] {
+        throwOnFailure(repulsorEngine.CalculateWorldDisplacements(simulated));
+    }));
+    m_records.push_back(Time(stage("gradient", sceneVertices), [] {}, [&] {
+        throwOnFailure(repulsorEngine.GetGradients(simulated));
+    }));
+
+    // --- Full physics step: displacements, application and obstacle updates ---
+    m_records.push_back(Time(stage("physics_step", sceneVertices), [] {}, [&] {
+        if (!sceneManager.ApplyPhysicsStep(1)) {
+            throw std::runtime_error("ApplyPhysicsStep failed");
+        }
+    }));
+}
+
+BenchmarkRecord BenchmarkSuite::Time(BenchmarkRecord record, const std::function<void()>& setup,
+                                     const std::function<void()>& operation) const {
+    std::vector<double> timings;
+    timings.reserve(m_options.repetitions);
+    std::uint64_t allocations = 0;
+    try {
+        for (int rep = 0; rep <= m_options.repetitions; ++rep) {
+            setup();
+            const std::uint64_t allocationsBefore = AllocationCounter::Count();
+            Clock::time_point start = Clock::now();
+            operation();
+            double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (rep > 0) {
+                timings.push_back(elapsedMs);
+                allocations += AllocationCounter::Count() - allocationsBefore;
+            }
+        }
+    } catch (const std::exception& e) {
+        record.ok = false;
+        record.error = e.what();
+        Log::error("Benchmark " + record.stage + " failed: " + record.error);
+        return record;
+    }
+
+    if (!timings.empty()) {
+        double total = 0.0;
+        for (double t : timings) {
+            total += t;
+        }
+        record.meanMs = total / timings.size();
+        record.minMs = *std::min_element(timings.begin(), timings.end());
+        record.maxMs = *std::max_element(timings.begin(), timings.end());
+        record.allocations = static_cast<double>(allocations) / timings.size();
+    }
+    return record;
+}
+
+void BenchmarkSuite::WriteJson(std::ostream& out) const {
+    out << std::setprecision(9);
+    out << "{\n";
+    out << "  \"hardwareThreads\": " << Utils::ThreadPool::HardwareThreadCount() << ",\n";
+    out << "  \"repetitions\": " << m_options.repetitions << ",\n";
+    out << "  \"vectorizedTransforms\": " << (Utils::transformKernelsVectorized() ? "true" : "false") << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < m_records.size(); ++i) {
+        const BenchmarkRecord& r = m_records[i];
+        double verticesPerSecond = r.meanMs > 0.0 ? r.vertexCount / (r.meanMs * 1e-3) : 0.0;
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"stage\": \"" << r.stage << "\", \"spheres\": " << r.sphereCount
+            << ", \"subdivisions\": " << r.subdivisions << ", \"vertices\": " << r.vertexCount
+            << ", \"threads\": " << r.threadCount << ", \"objectThreads\": " << r.objectThreadCount
+            << ", \"meanMs\": " << r.meanMs << ", \"minMs\": " << r.minMs << ", \"maxMs\": " << r.maxMs
+            << ", \"verticesPerSecond\": " << verticesPerSecond << ", \"allocations\": " << r.allocations
+            << ", \"ok\": " << (r.ok ? "true" : "false");
+        if (!r.ok) {
+            out << ", \"error\": \"" << jsonEscape(r.error) << "\"";
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void BenchmarkSuite::PrintUsage(std::ostream& out, const char* programName) {
+    out << "Usage: " << programName << " [options]\n"
+        << "\n"
+        << "Times mesh creation, transforms, obstacle updates, displacements, gradients and full physics steps\n"
+        << "on FCC lattices of icospheres and writes the results as JSON, including the heap allocations per\n"
+        << "operation. Lists are comma separated.\n"
+        << "\n"
+        << "  --spheres <list>         Sphere counts (default 2,16,64,256)\n"
+        << "  --subdivisions <list>    Icosphere subdivision levels (default 1,2,3)\n"
+        << "  --threads <list>         Repulsor threads per mesh, 0: from the thread budget (default 1)\n"
+        << "  --object-threads <list>  Objects processed in parallel, 0: from the thread budget (default 1,0)\n"
+        << "  --repetitions <n>        Timed runs per stage (default 3)\n"
+        << "  --output <file>          Write the JSON to a file instead of stdout\n"
+        << "  --help                   Show this message\n";
+}
+
+bool BenchmarkSuite::ParseArguments(int argc, char** argv, BenchmarkOptions& options, bool& showHelp,
+                                    std::string& error) {
+    showHelp = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            showHelp = true;
+            return true;
+        }
+        if (i + 1 >= argc) {
+            error = "Missing value for " + arg;
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--spheres") {
+                options.sphereCounts = parseIntList(value);
+            } else if (arg == "--subdivisions") {
+                options.subdivisions = parseIntList(value);
+            } else if (arg == "--threads") {
+                options.threadCounts = parseIntList(value);
+            } else if (arg == "--object-threads") {
+                options.objectThreadCounts = parseIntList(value);
+            } else if (arg == "--repetitions") {
+                options.repetitions = std::stoi(value);
+            } else if (arg == "--output") {
+                options.outputPath = value;
+            } else {
+                error = "Unknown option '" + arg + "'";
+                return false;
+            }
+        } catch (const std::exception& e) {
+            error = "Invalid value for " + arg + ": " + e.what();
+            return false;
+        }
+    }
+
+    auto positive = [](int v) { return v > 0; };
+    auto nonNegative = [](int v) { return v >= 0; };
+    if (!std::all_of(options.sphereCounts.begin(), options.sphereCounts.end(), positive)) {
+        error = "Sphere counts must be positive";
+        return false;
+    }
+    if (!std::all_of(options.threadCounts.begin(), options.threadCounts.end(), nonNegative) ||
+        !std::all_of(options.objectThreadCounts.begin(), options.objectThreadCounts.end(), nonNegative)) {
+        error = "Thread counts must not be negative";
+        return false;
+    }
+    if (options.repetitions < 1) {
+        error = "--repetitions must be at least 1";
+        return false;
+    }
+    return true;
+}
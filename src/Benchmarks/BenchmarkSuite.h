@@ -0,0 +1,67 @@
+#ifndef BENCHMARK_SUITE_H
+#define BENCHMARK_SUITE_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../Config/Config.h"
+#include "../Data/SceneDefinition.h"
+
+struct BenchmarkOptions {
+    std::vector<int> sphereCounts = {2, 16, 64, 256};
+    std::vector<int> subdivisions = {1, 2, 3};
+    std::vector<int> threadCounts = {1};           // Repulsor threads per mesh (TPE.threadCount, 0: budget)
+    std::vector<int> objectThreadCounts = {1, 0};  // Objects in parallel (TPE.objectThreadCount, 0: budget)
+    int repetitions = 3;     // Timed runs per stage, after one untimed warm-up run
+    std::string outputPath;  // Empty: JSON goes to stdout
+};
+
+// One timed stage on one scene and thread configuration.
+struct BenchmarkRecord {
+    std::string stage;
+    int sphereCount = 0;
+    int subdivisions = 0;
+    size_t vertexCount = 0;  // Vertices processed by one operation
+    int threadCount = 0;
+    int objectThreadCount = 0;
+    int repetitions = 0;
+    double meanMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double allocations = 0.0;  // Heap allocations per timed run, averaged; see AllocationCounter.h
+    bool ok = true;
+    std::string error;
+};
+
+// Times the TPE hot paths (mesh creation, transforms, obstacle updates, displacements, gradients, full physics
+// steps) on generated FCC lattices of icospheres and writes the results as JSON, with allocation counts.
+class BenchmarkSuite {
+  public:
+    explicit BenchmarkSuite(const BenchmarkOptions& options);
+
+    int Run();  // Returns a process exit code
+
+    // Spheres packed on an FCC lattice around the origin, every sphere repelling all others.
+    static SceneDefinition CreateLatticeScene(int sphereCount, int subdivisions);
+
+    static bool ParseArguments(int argc, char** argv, BenchmarkOptions& options, bool& showHelp,
+                               std::string& error);
+    static void PrintUsage(std::ostream& out, const char* programName);
+
+  private:
+    void RunScene(const SceneDefinition& scene, int sphereCount, int subdivisions, bool runThreadIndependent);
+    // Runs setup (untimed) and operation once as warm-up, then `repetitions` more times; fills the timings and the
+    // allocation count of the timed operations.
+    // A throwing operation marks the record as failed.
+    BenchmarkRecord Time(BenchmarkRecord record, const std::function<void()>& setup,
+                         const std::function<void()>& operation) const;
+    void WriteJson(std::ostream& out) const;
+
+    BenchmarkOptions m_options;
+    ConfigType m_config;  // Settings of the case currently running
+    std::vector<BenchmarkRecord> m_records;
+};
+
+#endif  // BENCHMARK_SUITE_H
@@ -0,0 +1,34 @@
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "../Utils/Log.h"
+#include "BenchmarkSuite.h"
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    bool showHelp = false;
+    std::string error;
+    if (!BenchmarkSuite::ParseArguments(argc, argv, options, showHelp, error)) {
+        std::cerr << "Error: " << error << "\n\n";
+        BenchmarkSuite::PrintUsage(std::cerr, argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (showHelp) {
+        BenchmarkSuite::PrintUsage(std::cout, argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    Log::setVerbosity(0);
+
+    try {
+        BenchmarkSuite suite(options);
+        return suite.Run();
+    } catch (const std::exception& e) {
+        std::cerr << "FATAL ERROR: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (...) {
+        std::cerr << "FATAL ERROR: Unknown exception caught." << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -1,11 +1,22 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <string>
+
+// Update rule of a physics step; every rule takes the step along the tangent-point (Sobolev) metric
+enum class OptimizerType {
+    GradientDescent,  // Metric gradient at the safe step size
+    LBFGS,            // Quasi-Newton; the metric is the initial inverse Hessian approximation
+    Nesterov,         // Gradient step plus accelerated momentum
+};
+
+// Settings that a checkpoint carries over to a resumed run are listed in IO/Checkpoint.cpp.
 struct ConfigType {
     struct {
         int activeObjectId = -1;
         bool realTimeDiff = false;
         bool realTimeGrad = false;
+        bool asyncRealTime = true;  // Evaluate real-time vector fields on a background thread
     } Interactivity;
 
     struct {
@@ -26,15 +37,71 @@ struct ConfigType {
         int maxRefinement = 30;
         int clusterSplitThreshold = 2;
         int parallelPercolationDepth = 5;
-        int threadCount = 1;
+        // Threads are split between objects evaluated in parallel and Repulsor's threads inside each mesh, so the
+        // two levels together stay within threadBudget. A positive count pins that level instead.
+        int threadBudget = 0;       // Threads for both levels together (0: hardware concurrency)
+        int threadCount = 0;        // Repulsor threads per mesh (0: by vertex count, from the budget)
+        int objectThreadCount = 0;  // Objects processed in parallel (0: from the budget)
+        bool pinThreads = false;    // Bind worker threads to CPUs, NUMA node by node (Linux only)
+        // Add each object's self-repulsion to its obstacle interaction. The self term is cached after every
+        // deformation and reused while the object only moves rigidly. The shared scene mesh always includes it.
+        bool includeSelfEnergy = false;
+        // Rebuild an object's mesh once it has deformed by this fraction of its size since it was built, bounding
+        // how loose its cluster tree gets. Rigid motion does not count. 0: never (trees are not reused otherwise).
+        double treeRebuildDrift = 0.0;
+        // Metric solve: tolerance is loose far from convergence and tightens as the differential shrinks
+        double solverToleranceMin = 1e-5;
+        double solverToleranceMax = 1e-2;
+        int solverMaxIterations = 100;
+        bool solverAdaptiveTolerance = true;
+        bool solverWarmStart = true;  // Start each solve from the object's previous gradient
     } TPE;
 
+    struct {
+        // One mesh over all obstacle sources instead of a combined obstacle per object. It always includes each
+        // object's self-repulsion, so it needs TPE.includeSelfEnergy, and only suits scenes where every simulated
+        // object repels all others ({-1}). Read on scene load; turning either off drops it.
+        bool sharedSceneObstacle = false;
+        // Per-object obstacles only include sources whose world bounding box is within this gap of the target's
+        bool distanceCulling = false;
+        double interactionRadius = 1.0;
+    } Obstacles;
+
     struct {
         int nLoopIterations = 1;
+        // Backtracking (Armijo) line search along the Sobolev gradient instead of the plain safe step. Each trial
+        // costs one energy evaluation; the metric solve is not repeated.
+        bool lineSearch = false;
+        double lineSearchMaxStep = 10.0;  // Largest trial step, in units of the gradient; MaximumSafeStepSize caps it
+        double lineSearchGrowth = 2.0;    // The first trial is the previous step's accepted step times this
+        double lineSearchShrink = 0.5;    // Step factor after a rejected trial
+        double armijoConstant = 1e-4;     // Sufficient decrease: E(x - t g) <= E(x) - c t <dE, g>
+        int lineSearchMaxTrials = 8;      // Per object and step; no move if none is accepted
+        // L-BFGS and Nesterov keep their history per object and take a plain gradient step whenever
+        // MaximumSafeStepSize would shorten their step. The history restarts on scene loads and p/q changes.
+        OptimizerType optimizer = OptimizerType::GradientDescent;
+        int lbfgsHistory = 8;   // Position/differential pairs kept
+        double momentum = 0.9;  // Nesterov momentum coefficient, in [0, 1)
     } Opt;
 
+    struct {
+        std::string path = "tpe_checkpoint.tpec";  // Written by Save Checkpoint, read by Restore Checkpoint
+        int autosaveSteps = 0;                      // Save after every this many physics steps (0: never)
+    } Checkpoint;
+
+    struct {
+        std::string path = "tpe_trajectory.tpet";  // Written by Start Recording, read by Open Playback
+        bool recordFields = false;  // Evaluate and store the differential and gradient of every recorded step
+        double quantum = 1e-7;      // Recorded vertex changes are rounded to multiples of this
+        int keyframeInterval = 30;  // Full-precision frame every this many frames; bounds the cost of a seek
+        int queueFrames = 16;       // Frames buffered for the writer thread; further frames are dropped
+        float playbackFps = 30.0f;
+    } Recording;
+
     struct {
         int verbosity = 1;  // 0: no output, 1: some output, 2: detailed output
+        bool profiling = true;                     // Collect hot-path timings (builds with TPE_ENABLE_PROFILING)
+        std::string traceFile = "tpe_trace.json";  // Chrome trace written by the Performance panel
     } Debug;
 };
 
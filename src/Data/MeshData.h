@@ -2,13 +2,35 @@
 #define MESH_DATA_H
 
 #include <array>
+#include <memory>
 #include <vector>
 
 #include "../Utils/GlobalTypes.h"  // Defines Real, Int, amb_dim, dom_dim
 
+// Connectivity shared by every instance of a mesh (e.g. all spheres of a lattice). Immutable once built.
+struct MeshTopology {
+    std::vector<std::array<Int, dom_dim + 1>> simplices;  // Assuming triangles
+    size_t vertexCount = 0;                                // Vertices each instance must provide
+};
+
+// One mesh instance: its own vertex positions plus a reference to the shared topology.
 struct MeshData {
     std::vector<std::array<Real, amb_dim>> vertices;
-    std::vector<std::array<Int, dom_dim + 1>> simplices;  // Assuming triangles
+    std::shared_ptr<const MeshTopology> topology;
+
+    const std::vector<std::array<Int, dom_dim + 1>>& simplices() const {
+        static const std::vector<std::array<Int, dom_dim + 1>> empty;
+        return topology ? topology->simplices : empty;
+    }
 };
 
-#endif  // MESH_DATA_H
\ No newline at end of file
+// Wraps freshly built connectivity for sharing between instances.
+inline std::shared_ptr<const MeshTopology> makeMeshTopology(std::vector<std::array<Int, dom_dim + 1>> simplices,
+                                                            size_t vertexCount) {
+    auto topology = std::make_shared<MeshTopology>();
+    topology->simplices = std::move(simplices);
+    topology->vertexCount = vertexCount;
+    return topology;
+}
+
+#endif  // MESH_DATA_H
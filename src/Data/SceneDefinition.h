@@ -9,17 +9,16 @@
 #include "../Utils/GlobalTypes.h"
 #include "MeshData.h"
 
-namespace polyscope {
-enum class UpDir;
-enum class FrontDir;
-}  // namespace polyscope
-
 enum class ExampleId {
     FCC_4,
     TWO_SPHERES
     // Add other examples here
 };
 
+// Camera orientation of a scene, mapped onto the viewer's own conventions by the visualization engine
+enum class CameraUpDir { XUp, YUp, ZUp, NegXUp, NegYUp, NegZUp };
+enum class CameraFrontDir { XFront, YFront, ZFront, NegXFront, NegYFront, NegZFront };
+
 // Defines the static properties of an object in a scene
 struct SceneObjectDefinition {
     int id = -1;
@@ -29,6 +28,7 @@ struct SceneObjectDefinition {
     bool isObstacleSource = false;
     bool isSimulated = false;
     std::vector<int> obstacleDefinitionIds;
+    glm::mat4 initialTransform{1.0f};  // Placement of meshData's vertices in the world, e.g. from a checkpoint
 
     SceneObjectDefinition() = default;
 
@@ -45,8 +45,8 @@ struct SceneDefinition {
     std::vector<SceneObjectDefinition> objectDefs;
     glm::vec3 initialCameraPosition{0.f, 0.f, 5.f};
     glm::vec3 initialCameraLookAt{0.f, 0.f, 0.f};
-    polyscope::UpDir upDir;
-    polyscope::FrontDir frontDir;
+    CameraUpDir upDir = CameraUpDir::YUp;
+    CameraFrontDir frontDir = CameraFrontDir::ZFront;
 };
 
 #endif  // SCENE_DEFINITION_H
\ No newline at end of file
@@ -1,4 +1,4 @@
-#include "VisualizationEngine.h"
+#include "PolyscopeVisualizationEngine.h"
 
 #include <polyscope/polyscope.h>
 #include <polyscope/surface_mesh.h>
@@ -10,15 +10,59 @@
 #include "../Scene/SceneManager.h"
 #include "../Scene/SceneObject.h"  // Full definition
 #include "../Utils/Helpers.h"      // For scaling etc.
+#include "../Utils/Log.h"
+#include "../Utils/Profiler.h"
+
+namespace {
+
+polyscope::UpDir ToPolyscope(CameraUpDir dir) {
+    switch (dir) {
+    case CameraUpDir::XUp:
+        return polyscope::UpDir::XUp;
+    case CameraUpDir::ZUp:
+        return polyscope::UpDir::ZUp;
+    case CameraUpDir::NegXUp:
+        return polyscope::UpDir::NegXUp;
+    case CameraUpDir::NegYUp:
+        return polyscope::UpDir::NegYUp;
+    case CameraUpDir::NegZUp:
+        return polyscope::UpDir::NegZUp;
+    case CameraUpDir::YUp:
+    default:
+        return polyscope::UpDir::YUp;
+    }
+}
+
+polyscope::FrontDir ToPolyscope(CameraFrontDir dir) {
+    switch (dir) {
+    case CameraFrontDir::XFront:
+        return polyscope::FrontDir::XFront;
+    case CameraFrontDir::YFront:
+        return polyscope::FrontDir::YFront;
+    case CameraFrontDir::NegXFront:
+        return polyscope::FrontDir::NegXFront;
+    case CameraFrontDir::NegYFront:
+        return polyscope::FrontDir::NegYFront;
+    case CameraFrontDir::NegZFront:
+        return polyscope::FrontDir::NegZFront;
+    case CameraFrontDir::ZFront:
+    default:
+        return polyscope::FrontDir::ZFront;
+    }
+}
+
+}  // namespace
 
-VisualizationEngine::VisualizationEngine(const ConfigType& config) : m_config(config) {
+PolyscopeVisualizationEngine::PolyscopeVisualizationEngine(const ConfigType& config) : m_config(config) {
     polyscope::info("Initializing Visualization Engine (Polyscope)...");
 }
 
-bool VisualizationEngine::RegisterObject(SceneObject& object) {
+bool PolyscopeVisualizationEngine::RegisterObject(SceneObject& object) {
     const auto& vertices = object.GetInitialVertices();
     const auto& simplices = object.GetSimplices();
     const std::string& name = object.GetUniqueName();
+    TPE_PROFILE_OBJECT(object.GetId());
+    TPE_PROFILE_SCOPE(VisualizationUpdate);
 
     if (vertices.empty() || simplices.empty()) {
         polyscope::warning("VizEngine: Skipping registration for " + name + " (empty geometry).");
@@ -50,7 +94,7 @@ bool VisualizationEngine::RegisterObject(SceneObject& object) {
     }
 }
 
-bool VisualizationEngine::RemoveObjectByName(const std::string& name) {
+bool PolyscopeVisualizationEngine::RemoveObjectByName(const std::string& name) {
     if (name.empty()) {
         return false;
     }
@@ -63,12 +107,14 @@ bool VisualizationEngine::RemoveObjectByName(const std::string& name) {
     return true;
 }
 
-void VisualizationEngine::RemoveAllObjects() {
+void PolyscopeVisualizationEngine::RemoveAllObjects() {
     polyscope::info("VizEngine: Removing all structures.");
     polyscope::removeAllStructures();
 }
 
-void VisualizationEngine::UpdateObjectTransform(SceneObject& object) {
+void PolyscopeVisualizationEngine::UpdateObjectTransform(SceneObject& object) {
+    TPE_PROFILE_OBJECT(object.GetId());
+    TPE_PROFILE_SCOPE(VisualizationUpdate);
     const std::string& name = object.GetUniqueName();
     auto* psMesh = polyscope::getSurfaceMesh(name);
     if (psMesh) {
@@ -78,7 +124,9 @@ void VisualizationEngine::UpdateObjectTransform(SceneObject& object) {
     }
 }
 
-void VisualizationEngine::UpdateObjectVertices(SceneObject& object) {
+void PolyscopeVisualizationEngine::UpdateObjectVertices(SceneObject& object) {
+    TPE_PROFILE_OBJECT(object.GetId());
+    TPE_PROFILE_SCOPE(VisualizationUpdate);
     const std::string& name = object.GetUniqueName();
     auto* psMesh = polyscope::getSurfaceMesh(name);
     if (psMesh) {
@@ -88,7 +136,8 @@ void VisualizationEngine::UpdateObjectVertices(SceneObject& object) {
     }
 }
 
-void VisualizationEngine::UpdateActiveGizmo(const std::string& oldActiveName, const std::string& newActiveName) {
+void PolyscopeVisualizationEngine::UpdateActiveGizmo(const std::string& oldActiveName,
+                                                     const std::string& newActiveName) {
     // Disable old
     if (!oldActiveName.empty() && oldActiveName != newActiveName) {
         auto* oldStruct = polyscope::getSurfaceMesh(oldActiveName);
@@ -104,7 +153,7 @@ void VisualizationEngine::UpdateActiveGizmo(const std::string& oldActiveName, co
         auto* newStruct = polyscope::getSurfaceMesh(newActiveName);
         if (newStruct) {
             newStruct->setTransformGizmoEnabled(true);
-            polyscope::info("VizEngine: Enabled gizmo for " + newActiveName);
+            TPE_LOG_DEBUG("VizEngine: Enabled gizmo for ", newActiveName);
         } else {
             polyscope::warning("VizEngine: Could not find new structure '" + newActiveName + "' to enable gizmo.");
         }
@@ -114,11 +163,13 @@ void VisualizationEngine::UpdateActiveGizmo(const std::string& oldActiveName, co
     RequestRedraw();
 }
 
-void VisualizationEngine::UpdateVectorQuantity(SceneObject& object, const std::string& quantityName,
-                                               const std::vector<glm::vec3>& vectors) {
+void PolyscopeVisualizationEngine::UpdateVectorQuantity(SceneObject& object, const std::string& quantityName,
+                                                        const std::vector<glm::vec3>& vectors) {
+    TPE_PROFILE_OBJECT(object.GetId());
+    TPE_PROFILE_SCOPE(VisualizationUpdate);
     const std::string& meshName = object.GetUniqueName();
-    polyscope::info("VizEngine: UpdateVectorQuantity START - Name: " + meshName + ", QName: " + quantityName +
-                    ", VecCount: " + std::to_string(vectors.size()));
+    TPE_LOG_DEBUG("VizEngine: UpdateVectorQuantity START - Name: ", meshName, ", QName: ", quantityName,
+                  ", VecCount: ", vectors.size());
 
     auto* psMesh = polyscope::getSurfaceMesh(meshName);
     if (!psMesh) {
@@ -143,7 +194,7 @@ void VisualizationEngine::UpdateVectorQuantity(SceneObject& object, const std::s
     }
 }
 
-void VisualizationEngine::RemoveVectorQuantity(SceneObject& object, const std::string& quantityName) {
+void PolyscopeVisualizationEngine::RemoveVectorQuantity(SceneObject& object, const std::string& quantityName) {
     const std::string& meshName = object.GetUniqueName();
     auto* psMesh = polyscope::getSurfaceMesh(meshName);
     if (psMesh) {
@@ -151,7 +202,7 @@ void VisualizationEngine::RemoveVectorQuantity(SceneObject& object, const std::s
     }
 }
 
-void VisualizationEngine::RemoveAllVectorQuantities(SceneObject& object) {
+void PolyscopeVisualizationEngine::RemoveAllVectorQuantities(SceneObject& object) {
     const std::string& meshName = object.GetUniqueName();
     auto* psMesh = polyscope::getSurfaceMesh(meshName);
     if (psMesh) {
@@ -160,25 +211,31 @@ void VisualizationEngine::RemoveAllVectorQuantities(SceneObject& object) {
     }
 }
 
-void VisualizationEngine::RequestRedraw() {
+void PolyscopeVisualizationEngine::RequestRedraw() {
     polyscope::requestRedraw();
 }
 
-void VisualizationEngine::SetCameraView(const glm::vec3& position, const glm::vec3& lookAt, polyscope::UpDir upDir,
-                                        polyscope::FrontDir frontDir) {
-    polyscope::view::upDir = upDir;
-    polyscope::view::frontDir = frontDir;
+void PolyscopeVisualizationEngine::SetCameraView(const glm::vec3& position, const glm::vec3& lookAt, CameraUpDir upDir,
+                                                 CameraFrontDir frontDir) {
+    polyscope::view::upDir = ToPolyscope(upDir);
+    polyscope::view::frontDir = ToPolyscope(frontDir);
     polyscope::view::lookAt(position, lookAt);
 }
 
-void VisualizationEngine::ResetCamera() {
+void PolyscopeVisualizationEngine::ResetCamera() {
     polyscope::view::resetCameraToHomeView();
 }
 
-void VisualizationEngine::UpdateSingleObstacleVisual(SceneObject& targetObject) {
+void PolyscopeVisualizationEngine::UpdateSingleObstacleVisual(SceneObject& targetObject) {
     if (!targetObject.IsSimulated() || !targetObject.GetRepulsorMesh()) {
         return;
     }
+    // Hidden obstacles are refreshed by ShowObstaclesForAll when they are turned back on.
+    if (!m_config.Display.showObstacles) {
+        return;
+    }
+    TPE_PROFILE_OBJECT(targetObject.GetId());
+    TPE_PROFILE_SCOPE(VisualizationUpdate);
 
     std::string obsName = targetObject.GetUniqueName() + "_Obstacle";
 
@@ -191,12 +248,12 @@ void VisualizationEngine::UpdateSingleObstacleVisual(SceneObject& targetObject)
         }
     } catch (const std::exception& e) {
         // Handle cases where GetObstacle() might throw if none is loaded
-        polyscope::info("UpdateSingleObstacleVisual: No obstacle found for " + targetObject.GetUniqueName() +
-                        " (exception: " + e.what() + ")");
+        TPE_LOG_DEBUG("UpdateSingleObstacleVisual: No obstacle found for ", targetObject.GetUniqueName(),
+                      " (exception: ", e.what(), ")");
         obsMeshPtr = nullptr;
     } catch (...) {  // Catch potential non-std exceptions from GetObstacle
-        polyscope::info("UpdateSingleObstacleVisual: No obstacle found (non-std exception) for " +
-                        targetObject.GetUniqueName());
+        TPE_LOG_DEBUG("UpdateSingleObstacleVisual: No obstacle found (non-std exception) for ",
+                      targetObject.GetUniqueName());
         obsMeshPtr = nullptr;
     }
 
@@ -204,30 +261,37 @@ void VisualizationEngine::UpdateSingleObstacleVisual(SceneObject& targetObject)
     bool hasPsObsMesh = polyscope::hasSurfaceMesh(obsName);
 
     if (obstacleDataIsValid) {
-        std::vector<std::array<Real, 3>> verts;
+        Utils::VertexSpan verts;
         std::vector<std::vector<Int>> faces;
 
         try {
-            verts = Utils::tensorToVecArray(obsMeshPtr->VertexCoordinates());
-
-            const auto& simplexTensor = obsMeshPtr->Simplices();
-            Int nSimplex = simplexTensor.Dimension(0);
-            Int vertsPerSimplex = simplexTensor.Dimension(1);
-
-            if (vertsPerSimplex == (dom_dim + 1)) {
-                faces.resize(nSimplex);
-                for (Int i = 0; i < nSimplex; ++i) {
-                    faces[i].resize(vertsPerSimplex);
-                    for (Int j = 0; j < vertsPerSimplex; ++j) {
-                        faces[i][j] = simplexTensor(i, j);
+            verts = Utils::tensorRows(obsMeshPtr->VertexCoordinates());  // Viewed in place, the mesh owns it
+            if (verts.empty()) {
+                throw std::runtime_error("Empty geometry after extraction.");
+            }
+
+            // Obstacle topology is fixed after scene load, so faces are only needed on first registration.
+            if (!hasPsObsMesh) {
+                const auto& simplexTensor = obsMeshPtr->Simplices();
+                Int nSimplex = simplexTensor.Dimension(0);
+                Int vertsPerSimplex = simplexTensor.Dimension(1);
+
+                if (vertsPerSimplex == (dom_dim + 1)) {
+                    faces.resize(nSimplex);
+                    for (Int i = 0; i < nSimplex; ++i) {
+                        faces[i].resize(vertsPerSimplex);
+                        for (Int j = 0; j < vertsPerSimplex; ++j) {
+                            faces[i][j] = simplexTensor(i, j);
+                        }
                     }
+                } else {
+                    polyscope::error("Obstacle simplex data has unexpected dimension: " +
+                                     std::to_string(vertsPerSimplex));
                 }
-            } else {
-                polyscope::error("Obstacle simplex data has unexpected dimension: " + std::to_string(vertsPerSimplex));
-            }
 
-            if (verts.empty() || faces.empty()) {
-                throw std::runtime_error("Empty geometry after extraction.");
+                if (faces.empty()) {
+                    throw std::runtime_error("Empty geometry after extraction.");
+                }
             }
 
             if (hasPsObsMesh) {
@@ -243,7 +307,7 @@ void VisualizationEngine::UpdateSingleObstacleVisual(SceneObject& targetObject)
                 psObsMesh->setShadeStyle(polyscope::MeshShadeStyle::Smooth);
                 psObsMesh->setTransformGizmoEnabled(false);
                 psObsMesh->setSurfaceColor({0.8f, 0.5f, 0.5f});  // gray
-                polyscope::info("Registered obstacle visual: " + obsName);
+                TPE_LOG_DEBUG("Registered obstacle visual: ", obsName);
             }
 
         } catch (const std::exception& e) {
@@ -254,12 +318,12 @@ void VisualizationEngine::UpdateSingleObstacleVisual(SceneObject& targetObject)
     } else {
         if (hasPsObsMesh) {
             polyscope::removeStructure(obsName);
-            polyscope::info("Removed obstacle visual: " + obsName);
+            TPE_LOG_DEBUG("Removed obstacle visual: ", obsName);
         }
     }
 }
 
-void VisualizationEngine::ShowObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>& objects) {
+void PolyscopeVisualizationEngine::ShowObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>& objects) {
     polyscope::info("VizEngine: Enabling obstacle visuals...");
     for (const auto& objPtr : objects) {
         if (!objPtr->IsSimulated()) {
@@ -278,7 +342,7 @@ void VisualizationEngine::ShowObstaclesForAll(const std::vector<std::unique_ptr<
     RequestRedraw();
 }
 
-void VisualizationEngine::HideObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>& objects) {
+void PolyscopeVisualizationEngine::HideObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>& objects) {
     polyscope::info("VizEngine: Disabling obstacle visuals...");
     for (const auto& objPtr : objects) {
         if (!objPtr->IsSimulated()) {
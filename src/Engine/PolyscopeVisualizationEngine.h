@@ -0,0 +1,44 @@
+#ifndef POLYSCOPE_VISUALIZATION_ENGINE_H
+#define POLYSCOPE_VISUALIZATION_ENGINE_H
+
+#include "VisualizationEngine.h"
+
+struct ConfigType;
+
+class PolyscopeVisualizationEngine : public VisualizationEngine {
+  public:
+    explicit PolyscopeVisualizationEngine(const ConfigType& config);
+    ~PolyscopeVisualizationEngine() override = default;
+
+    // --- Object Management ---
+    bool RegisterObject(SceneObject& object) override;
+    bool RemoveObjectByName(const std::string& name) override;
+    void RemoveAllObjects() override;
+
+    // --- Updates ---
+    void UpdateObjectTransform(SceneObject& object) override;
+    void UpdateObjectVertices(SceneObject& object) override;
+    void UpdateActiveGizmo(const std::string& oldActiveName, const std::string& newActiveName) override;
+
+    // --- Vector Visualization ---
+    void UpdateVectorQuantity(SceneObject& object, const std::string& quantityName,
+                              const std::vector<glm::vec3>& vectors) override;
+    void RemoveVectorQuantity(SceneObject& object, const std::string& quantityName) override;
+    void RemoveAllVectorQuantities(SceneObject& object) override;
+
+    // --- Obstacle Visuals ---
+    void UpdateSingleObstacleVisual(SceneObject& targetObject) override;
+    void ShowObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>& objects) override;
+    void HideObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>& objects) override;
+
+    // --- General ---
+    void RequestRedraw() override;
+    void SetCameraView(const glm::vec3& position, const glm::vec3& lookAt, CameraUpDir upDir,
+                       CameraFrontDir frontDir) override;
+    void ResetCamera() override;
+
+  private:
+    const ConfigType& m_config;
+};
+
+#endif  // POLYSCOPE_VISUALIZATION_ENGINE_H
@@ -1,47 +1,146 @@
 #include "RepulsorEngine.h"
 
-#include <polyscope/polyscope.h>
-
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
+#include <type_traits>
 
 #include "../Scene/SceneObject.h"
+#include "../Utils/BroadPhase.h"
 #include "../Utils/Helpers.h"
+#include "../Utils/Log.h"
+#include "../Utils/Profiler.h"
+#include "../Utils/ThreadPool.h"
+
+namespace {
+Real FrobeniusNorm(const Tensors::Tensor2<Real, Int>& T) {
+    const Real* data = T.data();
+    const std::size_t size = static_cast<std::size_t>(T.Dimension(0)) * static_cast<std::size_t>(T.Dimension(1));
+    Real sum = 0.0;
+    for (std::size_t i = 0; i < size; ++i) {
+        sum += data[i] * data[i];
+    }
+    return std::sqrt(sum);
+}
+
+Real Dot(const Tensors::Tensor2<Real, Int>& a, const Tensors::Tensor2<Real, Int>& b) {
+    const std::size_t size = static_cast<std::size_t>(a.Dimension(0)) * static_cast<std::size_t>(a.Dimension(1));
+    Real sum = 0.0;
+    for (std::size_t i = 0; i < size; ++i) {
+        sum += a.data()[i] * b.data()[i];
+    }
+    return sum;
+}
+
+void Axpy(Real a, const Tensors::Tensor2<Real, Int>& x, Tensors::Tensor2<Real, Int>& y) {  // y += a x
+    const std::size_t size = static_cast<std::size_t>(y.Dimension(0)) * static_cast<std::size_t>(y.Dimension(1));
+    for (std::size_t i = 0; i < size; ++i) {
+        y.data()[i] += a * x.data()[i];
+    }
+}
+
+// MaximumSafeStepSize along -direction, capped at `cap`. Flips the direction in place rather than copying it.
+Real SafeDescentStep(Mesh_T& mesh, Tensors::Tensor2<Real, Int>& direction, Real cap) {
+    TPE_PROFILE_SCOPE(MaximumSafeStepSize);
+    direction *= static_cast<Real>(-1.0);
+    const Real step = mesh.MaximumSafeStepSize(direction.data(), cap);
+    direction *= static_cast<Real>(-1.0);
+    return step;
+}
+
+// L-BFGS keeps a secant pair only if its curvature <s, y> is clearly positive, so the update stays positive definite
+constexpr Real kMinPairCurvature = 1e-8;  // Relative to |s| |y|
+}  // namespace
 
 RepulsorEngine::RepulsorEngine(const ConfigType& config) : m_config(config) {
-    polyscope::info("Initializing Repulsor Engine...");
+    Log::info("Initializing Repulsor Engine...");
     try {
         m_tpeFactory = std::make_unique<TPE_Factory_T>();
+        m_tpseFactory = std::make_unique<TPSE_Factory_T>();
         m_tpmFactory = std::make_unique<TPM_Factory_T>();
         CreateOrUpdateEnergyMetricObjects();
     } catch (const std::exception& e) {
-        polyscope::error("Failed to create Repulsor factories: " + std::string(e.what()));
+        Log::error("Failed to create Repulsor factories: " + std::string(e.what()));
         throw;
     }
-    polyscope::info("Repulsor Engine Initialized.");
+    Log::info("Repulsor Engine Initialized.");
 }
 
 RepulsorEngine::~RepulsorEngine() {
-    polyscope::info("Shutting down Repulsor Engine.");
+    Log::info("Shutting down Repulsor Engine.");
+}
+
+std::unique_lock<std::mutex> RepulsorEngine::LockWorkers() {
+    TPE_PROFILE_SCOPE(WorkerLockWait);
+    return std::unique_lock<std::mutex>(m_energyMetricMutex);
+}
+
+int RepulsorEngine::GetThreadBudget() const {
+    if (m_config.TPE.threadBudget > 0) {
+        return m_config.TPE.threadBudget;
+    }
+    return Utils::ThreadPool::HardwareThreadCount();
+}
+
+void RepulsorEngine::UpdateThreadSplit() {
+    m_threadSplit = Utils::splitThreadBudget(GetThreadBudget(), m_plannedVertexCounts, m_config.TPE.objectThreadCount,
+                                             m_config.TPE.threadCount);
+    if (m_threadSplit.objectWorkers * m_threadSplit.meshShare > m_threadSplit.budget) {
+        Log::warning("RepulsorEngine: Object and mesh thread settings exceed the thread budget of " +
+                     std::to_string(m_threadSplit.budget) + "; the machine will be oversubscribed.");
+    }
+}
+
+void RepulsorEngine::PlanThreads(std::span<const std::size_t> vertexCounts) {
+    std::unique_lock<std::mutex> lock = LockWorkers();
+    m_plannedVertexCounts.assign(vertexCounts.begin(), vertexCounts.end());
+    UpdateThreadSplit();
+    Log::info("Thread budget " + std::to_string(m_threadSplit.budget) + ": " +
+              std::to_string(m_threadSplit.objectWorkers) + " object(s) at once, up to " +
+              std::to_string(m_threadSplit.meshShare) + " Repulsor thread(s) each");
 }
 
 void RepulsorEngine::CreateOrUpdateEnergyMetricObjects() {
-    std::lock_guard<std::mutex> lock(m_energyMetricMutex);
+    std::unique_lock<std::mutex> lock = LockWorkers();
+
+    UpdateThreadSplit();
+    // The pool covers the whole budget (or more object workers, if the user forces them), so budget changes are
+    // the only reason to recreate it; splits just change how many of its workers a batch uses.
+    const int workerCount = std::max(m_threadSplit.budget, m_threadSplit.objectWorkers);
+    const bool poolChanged = !m_threadPool || m_threadPool->GetThreadCount() != workerCount ||
+                             m_threadsPinned != m_config.TPE.pinThreads;
+    const bool pqChanged = m_current_p != m_config.TPE.p || m_current_q != m_config.TPE.q;
+
+    if (poolChanged) {
+        Log::info("Creating Repulsor worker pool with " + std::to_string(workerCount) + " thread(s)");
+        m_threadPool.reset();
+        m_threadPool = std::make_unique<Utils::ThreadPool>(workerCount, m_config.TPE.pinThreads);
+        m_threadsPinned = m_config.TPE.pinThreads;
+        if (m_threadsPinned && m_threadPool->GetPinnedCount() < workerCount - 1) {
+            Log::warning("RepulsorEngine: Pinned " + std::to_string(m_threadPool->GetPinnedCount()) + " of " +
+                         std::to_string(workerCount - 1) + " worker thread(s); pinning is only supported on Linux.");
+        }
+    }
 
-    if (!m_energyObj || !m_metricObj || m_current_p != m_config.TPE.p || m_current_q != m_config.TPE.q) {
-        polyscope::info("Updating Repulsor energy/metric objects (p=" + std::to_string(m_config.TPE.p) +
-                        ", q=" + std::to_string(m_config.TPE.q) + ")");
+    if (poolChanged || pqChanged || m_workers.empty()) {
+        Log::info("Updating Repulsor energy/metric objects (p=" + std::to_string(m_config.TPE.p) +
+                  ", q=" + std::to_string(m_config.TPE.q) + ")");
         try {
-            m_energyObj = m_tpeFactory->Make(dom_dim, dom_dim, amb_dim, m_config.TPE.q, m_config.TPE.p);
-            m_metricObj = m_tpmFactory->Make(dom_dim, amb_dim, m_config.TPE.q, m_config.TPE.p);
-            if (!m_energyObj || !m_metricObj) {
-                throw std::runtime_error("Factory returned nullptr for energy/metric object.");
+            std::vector<WorkerContext> workers(m_threadPool->GetThreadCount());
+            for (auto& ctx : workers) {
+                ctx.energyObj = m_tpeFactory->Make(dom_dim, dom_dim, amb_dim, m_config.TPE.q, m_config.TPE.p);
+                ctx.selfEnergyObj = m_tpseFactory->Make(dom_dim, amb_dim, m_config.TPE.q, m_config.TPE.p);
+                ctx.metricObj = m_tpmFactory->Make(dom_dim, amb_dim, m_config.TPE.q, m_config.TPE.p);
+                if (!ctx.energyObj || !ctx.selfEnergyObj || !ctx.metricObj) {
+                    throw std::runtime_error("Factory returned nullptr for energy/metric object.");
+                }
             }
+            m_workers = std::move(workers);
             m_current_p = m_config.TPE.p;
             m_current_q = m_config.TPE.q;
         } catch (const std::exception& e) {
-            polyscope::error("Failed to update energy/metric objects: " + std::string(e.what()));
-            m_energyObj = nullptr;
-            m_metricObj = nullptr;
+            Log::error("Failed to update energy/metric objects: " + std::string(e.what()));
+            m_workers.clear();
             m_current_p = -1.0;
             m_current_q = -1.0;
             throw;
@@ -54,169 +153,622 @@ bool RepulsorEngine::InitializeRepulsorMesh(SceneObject& object) {
         return false;
     }
     if (object.GetRepulsorMesh()) {
-        polyscope::warning("RepulsorEngine: Mesh already initialized for " + object.GetUniqueName());
+        Log::warning("RepulsorEngine: Mesh already initialized for " + object.GetUniqueName());
         return true;
     }
 
-    const auto& vertices = object.GetInitialVertices();
-    const auto& simplices = object.GetSimplices();
-
-    if (vertices.empty() || simplices.empty()) {
-        polyscope::error("RepulsorEngine: Cannot initialize mesh for " + object.GetUniqueName() + " - empty geometry.");
+    try {
+        CreateRepulsorMesh(object);
+    } catch (const std::exception& e) {
+        Log::error("RepulsorEngine: Failed to create mesh for " + object.GetUniqueName() + ": " +
+                   std::string(e.what()));
+        object.SetRepulsorMesh(nullptr);
         return false;
     }
+    return true;
+}
 
-    Repulsor::SimplicialMesh_Factory<Mesh_T, dom_dim, dom_dim, amb_dim, amb_dim> meshFactory;
-    const double (*v_ptr)[amb_dim] = reinterpret_cast<const double (*)[amb_dim]>(vertices.data());
-    const int (*s_ptr)[dom_dim + 1] = reinterpret_cast<const int (*)[dom_dim + 1]>(simplices.data());
-
-    try {
-        auto meshPtr = meshFactory.Make(v_ptr[0], vertices.size(), amb_dim, false, s_ptr[0], simplices.size(),
-                                        dom_dim + 1, false, m_config.TPE.threadCount);
-
-        if (!meshPtr) {
-            throw std::runtime_error("MeshFactory::Make returned nullptr.");
+std::vector<BatchResult<bool>> RepulsorEngine::InitializeRepulsorMeshes(std::span<SceneObject* const> objects) {
+    return RunBatch<bool>(objects, "mesh creation", [this](SceneObject& obj, WorkerContext&) {
+        if (!obj.GetRepulsorMesh()) {
+            CreateRepulsorMesh(obj);
         }
+        return true;
+    });
+}
 
-        UpdateMeshParametersInternal(meshPtr.get());
-        object.SetRepulsorMesh(std::move(meshPtr));
-
-    } catch (const std::exception& e) {
-        polyscope::error("RepulsorEngine: Failed to create mesh for " + object.GetUniqueName() + ": " +
-                         std::string(e.what()));
-        object.SetRepulsorMesh(nullptr);
-        return false;
+void RepulsorEngine::CreateRepulsorMesh(SceneObject& object) {
+    TPE_PROFILE_OBJECT(object.GetId());
+    TPE_PROFILE_SCOPE(InitializeMesh);
+    // World coordinates, so objects that start transformed (e.g. restored from a checkpoint) start where they are
+    const Tensors::Tensor2<Real, Int>& vertices = object.GetWorldCoordinates();
+    const auto& simplices = object.GetSimplices();
+    if (!object.IsSimulated() || vertices.Dimension(0) == 0 || simplices.empty()) {
+        throw std::runtime_error("not simulated or empty geometry");
     }
 
-    return true;
+    Repulsor::SimplicialMesh_Factory<Mesh_T, dom_dim, dom_dim, amb_dim, amb_dim> meshFactory;
+    const int (*s_ptr)[dom_dim + 1] = reinterpret_cast<const int (*)[dom_dim + 1]>(simplices.data());
+    const std::size_t vertexCount = static_cast<std::size_t>(vertices.Dimension(0));
+
+    auto meshPtr = meshFactory.Make(vertices.data(), vertexCount, amb_dim, false, s_ptr[0], simplices.size(),
+                                    dom_dim + 1, false, m_threadSplit.MeshThreadsFor(vertexCount));
+    if (!meshPtr) {
+        throw std::runtime_error("MeshFactory::Make returned nullptr.");
+    }
+    UpdateMeshParametersInternal(meshPtr.get());
+    ClusterTreeState& tree = object.GetClusterTreeState();
+    tree.builtAtDrift = tree.drift;
+    tree.extent =
+        Utils::aabbMaxExtent(Utils::computeWorldAabb(object.GetInitialVertices(), object.GetCurrentTransform()));
+    object.SetRepulsorMesh(std::move(meshPtr));
 }
 
 bool RepulsorEngine::UpdateRepulsorMeshState(SceneObject& object) {
     Mesh_T* meshPtr = object.GetRepulsorMesh();
     if (!meshPtr) {
-        polyscope::warning("RepulsorEngine: Cannot update state for " + object.GetUniqueName() + ", no mesh.");
+        Log::warning("RepulsorEngine: Cannot update state for " + object.GetUniqueName() + ", no mesh.");
         return false;
     }
     if (!object.IsSimulated()) {
         return true;  // Nothing to update
     }
+    TPE_PROFILE_OBJECT(object.GetId());
+    TPE_PROFILE_SCOPE(UpdateMeshState);
 
-    // Calculate current world coordinates
-    const auto& localVerts = object.GetInitialVertices();
-    const auto& transform = object.GetCurrentTransform();
-    std::vector<std::array<Real, amb_dim>> worldVerts = Utils::applyTransform(localVerts, transform);
-
-    if (worldVerts.empty()) {
-        polyscope::warning("RepulsorEngine: Calculated world vertices are empty for " + object.GetUniqueName());
-        return false;
-    }
-
-    Tensors::Tensor2<Real, Int> worldTensor = Utils::vecArrayToTensor(worldVerts);
-    if (worldTensor.Dimension(0) == 0) {
+    // Refresh the object's own world buffer and hand it to Repulsor as is
+    if (object.GetInitialVertices().empty()) {
+        Log::warning("RepulsorEngine: Calculated world vertices are empty for " + object.GetUniqueName());
         return false;
     }
+    object.SyncWorldCoordinates();
 
     try {
-        meshPtr->ClearCache();
-        meshPtr->SemiStaticUpdate(worldTensor.data());
-        polyscope::info("Repulsor state updated for " + object.GetUniqueName());
+        RefitRepulsorMesh(object);  // Rebuilds only if replaced coordinates deformed the object too far
+        TPE_LOG_DEBUG("Repulsor state updated for ", object.GetUniqueName());
         return true;
     } catch (const std::exception& e) {
-        polyscope::error("RepulsorEngine: SemiStaticUpdate failed for " + object.GetUniqueName() + ": " +
-                         std::string(e.what()));
+        Log::error("RepulsorEngine: Mesh update failed for " + object.GetUniqueName() + ": " + std::string(e.what()));
         return false;
     }
 }
 
+bool RepulsorEngine::RefitRepulsorMesh(SceneObject& object) {
+    Mesh_T* meshPtr = object.GetRepulsorMesh();
+    if (!meshPtr) {
+        throw std::runtime_error("no Repulsor mesh");
+    }
+    ClusterTreeState& tree = object.GetClusterTreeState();
+    const Real drift = tree.drift - tree.builtAtDrift;
+    if (clusterTreeDrifted(drift, tree.extent, m_config.TPE.treeRebuildDrift)) {
+        TPE_LOG_DEBUG("RepulsorEngine: Rebuilding mesh of ", object.GetUniqueName(), " after a drift of ", drift);
+        CreateRepulsorMesh(object);  // Keeps the old mesh if it throws
+        ++tree.rebuilds;
+        return true;
+    }
+    if (!UpdateMeshCoordinates(*meshPtr, Utils::tensorRows(object.GetWorldCoordinates()))) {
+        throw std::runtime_error("Repulsor mesh update failed");
+    }
+    ++tree.refits;
+    return false;
+}
+
 std::unique_ptr<Mesh_T> RepulsorEngine::CreateObstacleMesh(const std::vector<std::array<Real, 3>>& vertices,
                                                            const std::vector<std::array<Int, 3>>& simplices) {
     if (vertices.empty() || simplices.empty()) {
-        polyscope::warning("RepulsorEngine::CreateObstacleMesh: Cannot create mesh from empty geometry.");
+        Log::warning("RepulsorEngine::CreateObstacleMesh: Cannot create mesh from empty geometry.");
+        return nullptr;
+    }
+    TPE_PROFILE_SCOPE(CreateObstacleMesh);
+    try {
+        // Evaluated inside the target's work, so it gets no more than a concurrently running object
+        return MakeMesh(vertices, simplices, m_threadSplit.SharedMeshThreadsFor(vertices.size()));
+    } catch (const std::exception& e) {
+        Log::error("RepulsorEngine: Failed to create obstacle mesh: " + std::string(e.what()));
+        return nullptr;
+    }
+}
+
+std::unique_ptr<Mesh_T> RepulsorEngine::CreateSceneMesh(const std::vector<std::array<Real, 3>>& vertices,
+                                                        const std::vector<std::array<Int, 3>>& simplices) {
+    if (vertices.empty() || simplices.empty()) {
+        Log::warning("RepulsorEngine::CreateSceneMesh: Cannot create mesh from empty geometry.");
+        return nullptr;
+    }
+    try {
+        return MakeMesh(vertices, simplices, m_threadSplit.StandaloneMeshThreadsFor(vertices.size()));
+    } catch (const std::exception& e) {
+        Log::error("RepulsorEngine: Failed to create scene mesh: " + std::string(e.what()));
         return nullptr;
     }
+}
 
+std::unique_ptr<Mesh_T> RepulsorEngine::MakeMesh(const std::vector<std::array<Real, 3>>& vertices,
+                                                 const std::vector<std::array<Int, 3>>& simplices, int threadCount) {
     Repulsor::SimplicialMesh_Factory<Mesh_T, dom_dim, dom_dim, amb_dim, amb_dim> meshFactory;
     const double (*v_ptr)[amb_dim] = reinterpret_cast<const double (*)[amb_dim]>(vertices.data());
     const int (*s_ptr)[dom_dim + 1] = reinterpret_cast<const int (*)[dom_dim + 1]>(simplices.data());
 
+    auto meshPtr = meshFactory.Make(v_ptr[0], vertices.size(), amb_dim, false, s_ptr[0], simplices.size(),
+                                    dom_dim + 1, false, threadCount);
+    if (!meshPtr) {
+        throw std::runtime_error("MeshFactory::Make returned nullptr.");
+    }
+
+    UpdateMeshParametersInternal(meshPtr.get());
+    return meshPtr;
+}
+
+bool RepulsorEngine::LoadObstacle(SceneObject& target, std::unique_ptr<Mesh_T> obstacleMesh) {
+    Mesh_T* targetMesh = target.GetRepulsorMesh();
+    if (!targetMesh || !obstacleMesh) {
+        return false;
+    }
+
+    TPE_PROFILE_OBJECT(target.GetId());
+    TPE_PROFILE_SCOPE(LoadObstacle);
+    Mesh_T* obstacleHandle = obstacleMesh.get();
     try {
-        auto obstacleMeshPtr = meshFactory.Make(v_ptr[0], vertices.size(), amb_dim, false, s_ptr[0], simplices.size(),
-                                                dom_dim + 1, false, m_config.TPE.threadCount);
+        targetMesh->LoadObstacle(std::move(obstacleMesh));
+        target.SetObstacleMesh(obstacleHandle);
+        return true;
+    } catch (const std::exception& e) {
+        Log::error("RepulsorEngine: Exception during LoadObstacle for " + target.GetUniqueName() + ": " +
+                   std::string(e.what()));
+        target.SetObstacleMesh(nullptr);
+        return false;
+    }
+}
 
-        if (!obstacleMeshPtr) {
-            throw std::runtime_error("Obstacle MeshFactory::Make returned nullptr.");
-        }
+bool RepulsorEngine::UpdateObstacleCoordinates(SceneObject& target, const std::vector<std::array<Real, 3>>& vertices) {
+    Mesh_T* obstacleMesh = target.GetObstacleMesh();
+    if (!obstacleMesh) {
+        return false;
+    }
+    // The target's cached obstacle interaction data is rebuilt by the next Evaluate.
+    return UpdateMeshCoordinates(*obstacleMesh, vertices);
+}
 
-        UpdateMeshParametersInternal(obstacleMeshPtr.get());
-        return obstacleMeshPtr;
+bool RepulsorEngine::UpdateMeshCoordinates(Mesh_T& mesh, Utils::VertexSpan vertices) {
+    if (static_cast<size_t>(mesh.VertexCount()) != vertices.size()) {
+        return false;
+    }
 
+    try {
+        mesh.ClearCache();
+        mesh.SemiStaticUpdate(&vertices[0][0]);
+        return true;
     } catch (const std::exception& e) {
-        polyscope::error("RepulsorEngine: Failed to create obstacle mesh: " + std::string(e.what()));
-        return nullptr;
+        Log::error("RepulsorEngine: Coordinate update failed: " + std::string(e.what()));
+        return false;
     }
 }
 
-Tensors::Tensor2<Real, Int> RepulsorEngine::CalculateWorldDisplacement(SceneObject& object) {
-    Mesh_T* meshPtr = object.GetRepulsorMesh();
-    std::lock_guard<std::mutex> lock(m_energyMetricMutex);
-    if (!m_energyObj || !m_metricObj) {
-        polyscope::error("RepulsorEngine: Energy/Metric objects not available for calculation.");
+EvaluationResult RepulsorEngine::Evaluate(SceneObject& object, EvalFlags what) {
+    std::unique_lock<std::mutex> lock = LockWorkers();
+    if (m_workers.empty()) {
+        Log::error("RepulsorEngine: Energy/Metric objects not available for calculation.");
         throw std::runtime_error("Energy/Metric objects not initialized.");
     }
+    try {
+        return EvaluateInternal(object, what, m_workers[0]);
+    } catch (const std::exception& e) {
+        Log::error("RepulsorEngine: Error evaluating " + object.GetUniqueName() + ": " + std::string(e.what()));
+        throw;
+    }
+}
+
+EvaluationResult RepulsorEngine::EvaluateSceneMesh(Mesh_T& mesh, Utils::SolverState& state, EvalFlags what) {
+    EvaluationResult result;
+    EvaluateSceneMeshInto(mesh, state, what, result);
+    return result;
+}
+
+void RepulsorEngine::EvaluateSceneMeshInto(Mesh_T& mesh, Utils::SolverState& state, EvalFlags what,
+                                           EvaluationResult& result) {
+    std::unique_lock<std::mutex> lock = LockWorkers();
+    if (m_workers.empty()) {
+        throw std::runtime_error("Energy/Metric objects not initialized.");
+    }
+    // Repulsor parallelizes within the mesh, so a single evaluation on worker 0's objects is enough.
+    // Errors propagate to the caller, which reports them on the main thread.
+    EvaluateMeshInto(mesh, state, what, *m_workers[0].selfEnergyObj, m_workers[0], result);
+}
+
+EvaluationResult RepulsorEngine::EvaluateInternal(SceneObject& object, EvalFlags what, WorkerContext& ctx,
+                                                  const glm::mat4* frame) {
+    EvaluationResult result;
+    EvaluateInto(object, what, ctx, result, frame);
+    return result;
+}
+
+void RepulsorEngine::EvaluateInto(SceneObject& object, EvalFlags what, WorkerContext& ctx, EvaluationResult& result,
+                                  const glm::mat4* frame) {
+    Mesh_T* meshPtr = object.GetRepulsorMesh();
     if (!meshPtr || !object.IsSimulated()) {
-        return Tensors::Tensor2<Real, Int>(0, amb_dim);
+        result.energy = 0.0;
+        result.stepSize = 0.0;
+        result.computed = EvalFlags::None;
+        Utils::ensureShape(result.differential, 0, amb_dim);
+        Utils::ensureShape(result.gradient, 0, amb_dim);
+        return;
     }
-    if (meshPtr->VertexCount() == 0) {
-        polyscope::warning("RepulsorEngine: Cannot calculate displacement for " + object.GetUniqueName() +
-                           ", vertex count is zero.");
-        return Tensors::Tensor2<Real, Int>(0, amb_dim);
+    TPE_PROFILE_OBJECT(object.GetId());
+    EvaluateMeshInto(*meshPtr, object.GetSolverState(), what, *ctx.energyObj, ctx, result,
+                     m_config.TPE.includeSelfEnergy ? &object : nullptr, frame);
+}
+
+const SelfEnergyCache& RepulsorEngine::RefreshSelfEnergy(SceneObject& object, const glm::mat4& frame, bool wantDiff,
+                                                         WorkerContext& ctx) {
+    SelfEnergyCache& cache = object.GetSelfEnergyCache();
+    const Utils::AffineTransform current = Utils::AffineTransform::FromMat4(frame);
+    if (cache.valid && (cache.hasDifferential || !wantDiff) &&
+        Utils::rigidChange(cache.transform, current, cache.rotation)) {
+        ++cache.reuses;
+        return cache;
     }
 
-    try {
-        meshPtr->ClearCache();
+    TPE_PROFILE_SCOPE(SelfEnergy);
+    Mesh_T& mesh = *object.GetRepulsorMesh();
+    cache.valid = false;
+    cache.energy = ctx.selfEnergyObj->Value(mesh);
+    cache.hasDifferential = wantDiff;
+    if (wantDiff) {
+        cache.differential = ctx.selfEnergyObj->Differential(mesh);
+        if (cache.differential.Dimension(0) != mesh.VertexCount() || cache.differential.Dimension(1) != amb_dim) {
+            throw std::runtime_error("Self energy differential dimension mismatch.");
+        }
+    }
+    cache.transform = current;
+    cache.rotation = Utils::AffineTransform();
+    cache.valid = true;
+    ++cache.evaluations;
+    return cache;
+}
 
-        Tensors::Tensor2<Real, Int> diff = m_energyObj->Differential(*meshPtr);
-        Tensors::Tensor2<Real, Int> gradient(meshPtr->VertexCount(), amb_dim);
+void RepulsorEngine::EvaluateMeshInto(Mesh_T& mesh, Utils::SolverState& state, EvalFlags what, Energy_T& energy,
+                                      WorkerContext& ctx, EvaluationResult& result, SceneObject* selfOf,
+                                      const glm::mat4* selfFrame) {
+    result.energy = 0.0;
+    result.stepSize = 0.0;
+    result.computed = EvalFlags::None;
+    if (mesh.VertexCount() == 0) {
+        Utils::ensureShape(result.differential, 0, amb_dim);
+        Utils::ensureShape(result.gradient, 0, amb_dim);
+        return;
+    }
+
+    const bool wantStep = HasFlag(what, EvalFlags::StepSize);
+    const bool wantGrad = wantStep || HasFlag(what, EvalFlags::Gradient);
+    const bool wantDiff = wantGrad || HasFlag(what, EvalFlags::Differential);
+
+    // One cache build serves every quantity below.
+    mesh.ClearCache();
+    const SelfEnergyCache* self =
+        selfOf ? &RefreshSelfEnergy(*selfOf, selfFrame ? *selfFrame : selfOf->GetCurrentTransform(), wantDiff, ctx)
+               : nullptr;
+
+    if (HasFlag(what, EvalFlags::Energy)) {
+        TPE_PROFILE_SCOPE(Energy);
+        result.energy = energy.Value(mesh) + (self ? self->energy : 0.0);
+        result.computed |= EvalFlags::Energy;
+    }
+
+    if (wantDiff) {
+        TPE_PROFILE_SCOPE(Differential);
+        result.differential = energy.Differential(mesh);  // Repulsor hands out a fresh tensor; it is moved in
+        if (self) {
+            // The cached self differential was taken in the frame of an earlier transform; turn it into this one.
+            Utils::addTransformedVectors(self->rotation, self->differential.data(), result.differential.data(),
+                                         static_cast<size_t>(self->differential.Dimension(0)));
+        }
+        result.computed |= EvalFlags::Differential;
+    }
 
-        const int max_iter = 100;
-        const double relative_tolerance = 1e-5;
-        const Int nrhs = diff.Dimension(1);
+    if (wantGrad) {
+        const Int nrhs = result.differential.Dimension(1);
         if (nrhs != amb_dim) {
             throw std::runtime_error("Differential dimension mismatch.");
         }
+        Utils::ensureShape(result.gradient, mesh.VertexCount(), amb_dim);
+        TPE_PROFILE_SCOPE(Solve);
+        SolveMetric(mesh, state, ctx, result.differential, result.gradient);
+        result.computed |= EvalFlags::Gradient;
+    }
 
-        m_metricObj->Solve(*meshPtr, 1.0, diff.data(), nrhs, 0.0, gradient.data(), nrhs, nrhs, max_iter,
-                           relative_tolerance);
+    if (wantStep) {
+        result.stepSize = SafeDescentStep(mesh, result.gradient, 1.0);
+        result.computed |= EvalFlags::StepSize;
+    }
+}
 
-        Tensors::Tensor2<Real, Int> downward_gradient = gradient;
-        downward_gradient *= static_cast<Real>(-1.0);
+void RepulsorEngine::CalculateSceneMeshStep(Mesh_T& mesh, Utils::SolverState& state, const Real* coords,
+                                            PhysicsWorkspace& workspace) {
+    std::unique_lock<std::mutex> lock = LockWorkers();
+    if (m_workers.empty()) {
+        throw std::runtime_error("Energy/Metric objects not initialized.");
+    }
+    StepMeshInto(mesh, state, coords, *m_workers[0].selfEnergyObj, m_workers[0], nullptr, workspace);
+}
 
-        double t = meshPtr->MaximumSafeStepSize(downward_gradient.data(), 1.0);
+void RepulsorEngine::StepMeshInto(Mesh_T& mesh, Utils::SolverState& state, const Real* coords, Energy_T& energy,
+                                  WorkerContext& ctx, SceneObject* selfOf, PhysicsWorkspace& workspace) {
+    EvaluationResult& result = workspace.evaluation;
+    OptimizerState& optimizer = workspace.optimizer;
+    const OptimizerType type = m_config.Opt.optimizer;
+    if (optimizer.type != type) {
+        optimizer.Reset();
+        optimizer.type = type;
+    }
+    const bool lbfgs = type == OptimizerType::LBFGS;
 
-        Tensors::Tensor2<Real, Int> world_displacement = downward_gradient;
-        world_displacement *= static_cast<Real>(t);
-        return world_displacement;
+    // L-BFGS solves the metric on its own right-hand side, so its evaluation stops at the differential
+    EvalFlags what = lbfgs ? EvalFlags::Differential : EvalFlags::Gradient;
+    if (m_config.Opt.lineSearch) {
+        what |= EvalFlags::Energy;
+    }
+    EvaluateMeshInto(mesh, state, what, energy, ctx, result, selfOf);
+    if (!HasFlag(result.computed, EvalFlags::Differential)) {
+        return;  // Empty mesh
+    }
 
-    } catch (const std::exception& e) {
-        polyscope::error("RepulsorEngine: Error calculating displacement for " + object.GetUniqueName() + ": " +
-                         std::string(e.what()));
-        throw;
+    optimizer.fellBack = false;
+    ++optimizer.steps;
+    Real safeStep = -1.0;  // Safe step along -gradient capped at 1, once known
+    if (lbfgs) {
+        LbfgsDirectionInto(mesh, coords, ctx, workspace);
+        bool useGradient = Dot(result.differential, result.gradient) <= 0.0;  // Not a descent direction
+        if (!useGradient) {
+            safeStep = SafeDescentStep(mesh, result.gradient, 1.0);
+            useGradient = safeStep < 1.0;  // The quasi-Newton step would have to be shortened
+        }
+        if (useGradient) {
+            optimizer.fellBack = true;
+            ++optimizer.fallbacks;
+            TPE_PROFILE_SCOPE(Solve);
+            SolveMetric(mesh, state, ctx, result.differential, result.gradient);
+            safeStep = -1.0;
+        }
+    }
+
+    if (m_config.Opt.lineSearch) {
+        LineSearchInto(mesh, coords, energy, selfOf ? ctx.selfEnergyObj.get() : nullptr, workspace);
+    } else {
+        result.stepSize = safeStep >= 0.0 ? safeStep : SafeDescentStep(mesh, result.gradient, 1.0);
+        result.gradient *= static_cast<Real>(-result.stepSize);
+        result.computed |= EvalFlags::StepSize;
+    }
+
+    if (type == OptimizerType::Nesterov) {
+        ApplyMomentum(mesh, workspace);
+    } else if (lbfgs) {
+        Utils::copyInto(optimizer.lastCoordinates, coords, mesh.VertexCount(), amb_dim);
+        Utils::copyInto(optimizer.lastDifferential, result.differential);
+        optimizer.hasLast = true;
     }
 }
 
-Real RepulsorEngine::GetEnergy(SceneObject& object) {
-    Mesh_T* meshPtr = object.GetRepulsorMesh();
-    std::lock_guard<std::mutex> lock(m_energyMetricMutex);
-    if (!m_energyObj) {
-        polyscope::error("RepulsorEngine: Energy object not available for GetEnergy.");
-        throw std::runtime_error("Energy object not initialized.");
+void RepulsorEngine::LbfgsDirectionInto(Mesh_T& mesh, const Real* coords, WorkerContext& ctx,
+                                        PhysicsWorkspace& workspace) {
+    EvaluationResult& result = workspace.evaluation;
+    OptimizerState& optimizer = workspace.optimizer;
+    const Int vertexCount = mesh.VertexCount();
+    const int history = std::max(1, m_config.Opt.lbfgsHistory);
+    if (static_cast<int>(optimizer.s.size()) != history) {
+        optimizer.Reset();
+        optimizer.s.resize(history);
+        optimizer.y.resize(history);
+        optimizer.rho.resize(history);
+        optimizer.alpha.resize(history);
     }
-    if (!meshPtr || !object.IsSimulated() || meshPtr->VertexCount() == 0) {
-        return 0.0;
+
+    // Secant pair of the previous step; it also spans any move made in between, which is still a valid secant
+    if (optimizer.hasLast && optimizer.lastCoordinates.Dimension(0) == vertexCount) {
+        const int slot = (optimizer.newest + 1) % history;
+        Tensors::Tensor2<Real, Int>& s = optimizer.s[slot];
+        Tensors::Tensor2<Real, Int>& y = optimizer.y[slot];
+        Utils::ensureShape(s, vertexCount, amb_dim);
+        Utils::ensureShape(y, vertexCount, amb_dim);
+        const std::size_t size = static_cast<std::size_t>(vertexCount) * amb_dim;
+        for (std::size_t i = 0; i < size; ++i) {
+            s.data()[i] = coords[i] - optimizer.lastCoordinates.data()[i];
+            y.data()[i] = result.differential.data()[i] - optimizer.lastDifferential.data()[i];
+        }
+        const Real sy = Dot(s, y);
+        if (sy > kMinPairCurvature * std::sqrt(Dot(s, s) * Dot(y, y))) {
+            optimizer.rho[slot] = 1.0 / sy;
+            optimizer.newest = slot;
+            optimizer.pairs = std::min(optimizer.pairs + 1, history);
+        } else if (optimizer.pairs == history) {
+            --optimizer.pairs;  // The rejected pair overwrote the oldest one
+        }
+    }
+
+    // Two-loop recursion
+    Tensors::Tensor2<Real, Int>& q = optimizer.scratch;
+    Utils::copyInto(q, result.differential);
+    for (int k = 0; k < optimizer.pairs; ++k) {
+        const int i = (optimizer.newest - k + history) % history;
+        optimizer.alpha[i] = optimizer.rho[i] * Dot(optimizer.s[i], q);
+        Axpy(-optimizer.alpha[i], optimizer.y[i], q);
+    }
+    Utils::ensureShape(result.gradient, vertexCount, amb_dim);
+    {
+        TPE_PROFILE_SCOPE(Solve);
+        SolveMetric(mesh, optimizer.solverState, ctx, q, result.gradient);
+    }
+    for (int k = optimizer.pairs - 1; k >= 0; --k) {
+        const int i = (optimizer.newest - k + history) % history;
+        const Real beta = optimizer.rho[i] * Dot(optimizer.y[i], result.gradient);
+        Axpy(optimizer.alpha[i] - beta, optimizer.s[i], result.gradient);
+    }
+    result.computed |= EvalFlags::Gradient;
+}
+
+void RepulsorEngine::ApplyMomentum(Mesh_T& mesh, PhysicsWorkspace& workspace) {
+    EvaluationResult& result = workspace.evaluation;
+    OptimizerState& optimizer = workspace.optimizer;
+    const Tensors::Tensor2<Real, Int>& step = result.gradient;
+    const Real mu = std::clamp<Real>(m_config.Opt.momentum, 0.0, 0.999);
+
+    // Momentum that points uphill is dropped (adaptive restart), as is momentum after a step that did not move
+    bool accelerate = optimizer.hasVelocity && optimizer.velocity.Dimension(0) == step.Dimension(0) &&
+                      result.stepSize > 0.0 && Dot(result.differential, optimizer.velocity) < 0.0;
+    if (accelerate) {
+        Tensors::Tensor2<Real, Int>& accelerated = optimizer.scratch;
+        Utils::copyInto(accelerated, step);
+        accelerated *= static_cast<Real>(1.0 + mu);
+        Axpy(mu * mu, optimizer.velocity, accelerated);
+        Real safeStep = 0.0;
+        {
+            TPE_PROFILE_SCOPE(MaximumSafeStepSize);
+            safeStep = mesh.MaximumSafeStepSize(accelerated.data(), 1.0);
+        }
+        accelerate = safeStep >= 1.0;
+        if (!accelerate) {
+            optimizer.fellBack = true;
+            ++optimizer.fallbacks;
+        }
+    }
+
+    if (accelerate) {
+        optimizer.velocity *= static_cast<Real>(mu);
+        Axpy(1.0, step, optimizer.velocity);
+        Utils::copyInto(result.gradient, optimizer.scratch);
+    } else {
+        Utils::copyInto(optimizer.velocity, step);
+    }
+    optimizer.hasVelocity = true;
+}
+
+void RepulsorEngine::LineSearchInto(Mesh_T& mesh, const Real* coords, Energy_T& energy, Energy_T* selfEnergy,
+                                    PhysicsWorkspace& workspace) {
+    EvaluationResult& result = workspace.evaluation;
+    LineSearchState& search = workspace.lineSearch;
+    const Int vertexCount = mesh.VertexCount();
+    Utils::ensureShape(search.trial, vertexCount, amb_dim);
+    const std::size_t size = static_cast<std::size_t>(vertexCount) * amb_dim;
+    Real* trial = search.trial.data();
+    const Real* gradient = result.gradient.data();
+
+    // Directional derivative along -gradient; negative unless the solve went wrong
+    const Real slope = -Dot(result.differential, result.gradient);
+    const Real maxStep = SafeDescentStep(mesh, result.gradient, m_config.Opt.lineSearchMaxStep);
+
+    search.initialEnergy = result.energy;
+    search.energy = result.energy;
+    search.acceptedStep = 0.0;
+    search.trials = 0;
+    ++search.searches;
+
+    if (slope < 0.0 && maxStep > 0.0) {
+        TPE_PROFILE_SCOPE(LineSearch);
+        // Start from the previous step, grown, so a run settles on its scale instead of searching it anew each time
+        Real step = search.step > 0.0 ? std::min(maxStep, search.step * m_config.Opt.lineSearchGrowth) : maxStep;
+        try {
+            for (int k = 0; k < std::max(1, m_config.Opt.lineSearchMaxTrials); ++k) {
+                for (std::size_t i = 0; i < size; ++i) {
+                    trial[i] = coords[i] - step * gradient[i];
+                }
+                mesh.ClearCache();
+                mesh.SemiStaticUpdate(trial);
+                const Real trialEnergy = energy.Value(mesh) + (selfEnergy ? selfEnergy->Value(mesh) : 0.0);
+                ++search.trials;
+                if (trialEnergy <= result.energy + m_config.Opt.armijoConstant * step * slope) {
+                    search.acceptedStep = step;
+                    search.energy = trialEnergy;
+                    break;
+                }
+                step *= m_config.Opt.lineSearchShrink;
+            }
+        } catch (...) {
+            mesh.ClearCache();
+            mesh.SemiStaticUpdate(coords);
+            throw;
+        }
+        // Without an accepted step, the next search starts where this one gave up
+        search.step = search.acceptedStep > 0.0 ? search.acceptedStep : step;
+        mesh.ClearCache();
+        mesh.SemiStaticUpdate(coords);
+    }
+    search.totalTrials += search.trials;
+
+    result.stepSize = search.acceptedStep;
+    result.gradient *= static_cast<Real>(-search.acceptedStep);
+    result.computed |= EvalFlags::StepSize;
+}
+
+Real RepulsorEngine::ComputeSolverTolerance(Utils::SolverState& state, Real diffNorm) const {
+    const Real tolMin = m_config.TPE.solverToleranceMin;
+    const Real tolMax = std::max(tolMin, m_config.TPE.solverToleranceMax);
+    if (!m_config.TPE.solverAdaptiveTolerance) {
+        return tolMin;
+    }
+
+    // Forcing-term schedule: the tolerance follows the differential norm relative to the largest one seen,
+    // so early iterations solve loosely and the solve tightens as the energy converges.
+    state.referenceDiffNorm = std::max(state.referenceDiffNorm, diffNorm);
+    if (state.referenceDiffNorm <= 0.0) {
+        return tolMin;
+    }
+    return std::clamp(tolMax * (diffNorm / state.referenceDiffNorm), tolMin, tolMax);
+}
+
+void RepulsorEngine::SolveMetric(Mesh_T& mesh, Utils::SolverState& state, WorkerContext& ctx,
+                                 const Tensors::Tensor2<Real, Int>& diff, Tensors::Tensor2<Real, Int>& gradient) {
+    const Int nrhs = amb_dim;
+    const Int n = mesh.VertexCount();
+    const int maxIter = std::max(1, m_config.TPE.solverMaxIterations);
+    const Real diffNorm = FrobeniusNorm(diff);
+    Real tolerance = ComputeSolverTolerance(state, diffNorm);
+
+    state.lastIterationCap = maxIter;
+    state.lastWarmStartResidual = 1.0;
+    state.lastSkipped = false;
+    ++state.solveCount;
+
+    const bool canWarmStart = m_config.TPE.solverWarmStart && state.lastGradient.Dimension(0) == n &&
+                              state.lastGradient.Dimension(1) == nrhs && diffNorm > 0.0;
+
+    if (!canWarmStart) {
+        ctx.metricObj->Solve(mesh, 1.0, diff.data(), nrhs, 0.0, gradient.data(), nrhs, nrhs, maxIter, tolerance);
+    } else {
+        // Defect correction around the previous gradient g0: solve A dg = d - A g0, then g = g0 + dg.
+        // The correction's relative tolerance is rescaled so the absolute accuracy matches a cold solve.
+        Tensors::Tensor2<Real, Int>& residual = state.residual;
+        Utils::copyInto(residual, diff);
+        ctx.metricObj->MultiplyMetric(mesh, -1.0, state.lastGradient.data(), nrhs, 1.0, residual.data(), nrhs, nrhs);
+        const Real residualNorm = FrobeniusNorm(residual);
+        state.lastWarmStartResidual = residualNorm / diffNorm;
+
+        Utils::copyInto(gradient, state.lastGradient);
+        if (residualNorm <= tolerance * diffNorm) {
+            state.lastSkipped = true;
+        } else {
+            const Real correctionTolerance = std::min<Real>(0.5, tolerance * diffNorm / residualNorm);
+            // beta = 1 accumulates the correction onto the initial guess already stored in `gradient`.
+            ctx.metricObj->Solve(mesh, 1.0, residual.data(), nrhs, 1.0, gradient.data(), nrhs, nrhs, maxIter,
+                                 correctionTolerance);
+        }
     }
+
+    state.lastTolerance = tolerance;
+    Utils::copyInto(state.lastGradient, gradient);
+}
+
+Tensors::Tensor2<Real, Int> RepulsorEngine::ToWorldDisplacement(EvaluationResult&& result) {
+    Tensors::Tensor2<Real, Int> world_displacement = std::move(result.gradient);
+    world_displacement *= static_cast<Real>(-result.stepSize);
+    return world_displacement;
+}
+
+Tensors::Tensor2<Real, Int> RepulsorEngine::CalculateWorldDisplacement(SceneObject& object) {
+    return ToWorldDisplacement(Evaluate(object, EvalFlags::StepSize));
+}
+
+Real RepulsorEngine::GetEnergy(SceneObject& object) {
     try {
-        meshPtr->ClearCache();
-        return m_energyObj->Value(*meshPtr);
+        return Evaluate(object, EvalFlags::Energy).energy;
     } catch (...) {
         return 0.0;
     }
@@ -244,55 +796,136 @@ void RepulsorEngine::UpdateMeshParametersInternal(Mesh_T* meshPtr) {
 void RepulsorEngine::ApplyCurrentConfigToMesh(SceneObject& object) {
     Mesh_T* meshPtr = object.GetRepulsorMesh();
     if (meshPtr) {
-        polyscope::info("RepulsorEngine: Applying config to mesh " + object.GetUniqueName());
+        TPE_LOG_DEBUG("RepulsorEngine: Applying config to mesh ", object.GetUniqueName());
         UpdateMeshParametersInternal(meshPtr);
     }
+    object.GetSelfEnergyCache().valid = false;  // Settings or exponents may have changed
+}
+
+void RepulsorEngine::ApplyCurrentConfigToMesh(Mesh_T& mesh) {
+    UpdateMeshParametersInternal(&mesh);
 }
 
 Tensors::Tensor2<Real, Int> RepulsorEngine::GetDifferential(SceneObject& object) {
-    Mesh_T* meshPtr = object.GetRepulsorMesh();
-    if (!m_energyObj) {
-        throw std::runtime_error("Energy object not initialized.");
-    }
-    if (!meshPtr || !object.IsSimulated() || meshPtr->VertexCount() == 0) {
-        return Tensors::Tensor2<Real, Int>(0, amb_dim);
+    return std::move(Evaluate(object, EvalFlags::Differential).differential);
+}
+
+Tensors::Tensor2<Real, Int> RepulsorEngine::GetGradient(SceneObject& object) {
+    return std::move(Evaluate(object, EvalFlags::Gradient).gradient);
+}
+
+// --- Batched Calculations ---
+
+template <typename T, typename Fn>
+std::vector<BatchResult<T>> RepulsorEngine::RunBatch(std::span<SceneObject* const> objects, const char* what,
+                                                     Fn&& fn) {
+    std::vector<BatchResult<T>> results(objects.size());
+
+    {
+        std::unique_lock<std::mutex> lock = LockWorkers();
+        if (m_workers.empty()) {
+            throw std::runtime_error("Energy/Metric objects not initialized.");
+        }
+
+        // Each object owns its mesh and obstacle, so objects only share the per-worker energy/metric pair.
+        auto runObject = [&](std::size_t i, int workerId) {
+            SceneObject* object = objects[i];
+            if (!object) {
+                results[i].error = "null object";
+                return;
+            }
+            try {
+                if constexpr (std::is_invocable_v<Fn&, SceneObject&, WorkerContext&, std::size_t>) {
+                    results[i].value = fn(*object, m_workers[workerId], i);  // For callers with per-object inputs
+                } else {
+                    results[i].value = fn(*object, m_workers[workerId]);
+                }
+                results[i].ok = true;
+            } catch (const std::exception& e) {
+                results[i].error = e.what();
+            } catch (...) {
+                results[i].error = "unknown exception";
+            }
+        };
+        m_threadPool->ParallelFor(objects.size(), runObject, m_threadSplit.objectWorkers);
     }
 
-    try {
-        meshPtr->ClearCache();
-        return m_energyObj->Differential(*meshPtr);
-    } catch (const std::exception& e) {
-        polyscope::error("RepulsorEngine: Error getting differential for " + object.GetUniqueName() + ": " +
-                         std::string(e.what()));
-        throw;
+    // Failures are left to the caller to report: batches may run off the main thread, where Polyscope logging
+    // is not safe.
+    for (auto& result : results) {
+        if (!result.ok) {
+            result.error = std::string(what) + ": " + result.error;
+        }
     }
+    return results;
 }
 
-Tensors::Tensor2<Real, Int> RepulsorEngine::GetGradient(SceneObject& object) {
-    Mesh_T* meshPtr = object.GetRepulsorMesh();
-    if (!m_energyObj || !m_metricObj) {
-        throw std::runtime_error("Energy/Metric object not initialized.");
-    }
-    if (!meshPtr || !object.IsSimulated() || meshPtr->VertexCount() == 0) {
-        return Tensors::Tensor2<Real, Int>(0, amb_dim);
+std::vector<BatchResult<EvaluationResult>> RepulsorEngine::EvaluateBatch(std::span<SceneObject* const> objects,
+                                                                         EvalFlags what,
+                                                                         std::span<const glm::mat4> frames) {
+    auto evaluate = [this, what, frames](SceneObject& obj, WorkerContext& ctx, std::size_t i) {
+        return EvaluateInternal(obj, what, ctx, i < frames.size() ? &frames[i] : nullptr);
+    };
+    return RunBatch<EvaluationResult>(objects, "evaluation", evaluate);
+}
+
+std::vector<BatchResult<Tensors::Tensor2<Real, Int>>>
+RepulsorEngine::CalculateWorldDisplacements(std::span<SceneObject* const> objects) {
+    return RunBatch<Tensors::Tensor2<Real, Int>>(objects, "displacement", [this](SceneObject& obj, WorkerContext& ctx) {
+        return ToWorldDisplacement(EvaluateInternal(obj, EvalFlags::StepSize, ctx));
+    });
+}
+
+std::vector<BatchResult<Tensors::Tensor2<Real, Int>>>
+RepulsorEngine::GetDifferentials(std::span<SceneObject* const> objects) {
+    return RunBatch<Tensors::Tensor2<Real, Int>>(objects, "differential", [this](SceneObject& obj, WorkerContext& ctx) {
+        return std::move(EvaluateInternal(obj, EvalFlags::Differential, ctx).differential);
+    });
+}
+
+std::vector<BatchResult<Tensors::Tensor2<Real, Int>>>
+RepulsorEngine::GetGradients(std::span<SceneObject* const> objects) {
+    return RunBatch<Tensors::Tensor2<Real, Int>>(objects, "gradient", [this](SceneObject& obj, WorkerContext& ctx) {
+        return std::move(EvaluateInternal(obj, EvalFlags::Gradient, ctx).gradient);
+    });
+}
+
+std::vector<BatchResult<Real>> RepulsorEngine::GetEnergies(std::span<SceneObject* const> objects) {
+    return RunBatch<Real>(objects, "energy", [this](SceneObject& obj, WorkerContext& ctx) {
+        return EvaluateInternal(obj, EvalFlags::Energy, ctx).energy;
+    });
+}
+
+bool RepulsorEngine::CalculateStepDisplacements(std::span<SceneObject* const> objects) {
+    std::unique_lock<std::mutex> lock = LockWorkers();
+    if (m_workers.empty()) {
+        throw std::runtime_error("Energy/Metric objects not initialized.");
     }
 
-    try {
-        meshPtr->ClearCache();
-        Tensors::Tensor2<Real, Int> diff = m_energyObj->Differential(*meshPtr);
-        Tensors::Tensor2<Real, Int> gradient(meshPtr->VertexCount(), amb_dim);
-        const int max_iter = 100;
-        const double relative_tolerance = 1e-5;
-        const Int nrhs = diff.Dimension(1);
-        if (nrhs != amb_dim) {
-            throw std::runtime_error("Differential dimension mismatch.");
+    // Same scheme as RunBatch, but every object evaluates into its own workspace instead of a result vector.
+    auto stepObject = [&](std::size_t i, int workerId) {
+        PhysicsWorkspace& workspace = objects[i]->GetPhysicsWorkspace();
+        try {
+            SceneObject& object = *objects[i];
+            WorkerContext& ctx = m_workers[workerId];
+            if (!object.GetRepulsorMesh() || !object.IsSimulated()) {
+                EvaluateInto(object, EvalFlags::StepSize, ctx, workspace.evaluation);  // Leaves an empty result
+            } else {
+                TPE_PROFILE_OBJECT(object.GetId());
+                StepMeshInto(*object.GetRepulsorMesh(), object.GetSolverState(), object.GetWorldCoordinates().data(),
+                             *ctx.energyObj, ctx, m_config.TPE.includeSelfEnergy ? &object : nullptr, workspace);
+            }
+            workspace.ok = true;
+        } catch (const std::exception& e) {
+            workspace.ok = false;
+            workspace.error = std::string("displacement: ") + e.what();
+        } catch (...) {
+            workspace.ok = false;
+            workspace.error = "displacement: unknown exception";
         }
-        m_metricObj->Solve(*meshPtr, 1.0, diff.data(), nrhs, 0.0, gradient.data(), nrhs, nrhs, max_iter,
-                           relative_tolerance);
-        return gradient;
-    } catch (const std::exception& e) {
-        polyscope::error("RepulsorEngine: Error getting gradient for " + object.GetUniqueName() + ": " +
-                         std::string(e.what()));
-        throw;
-    }
+    };
+    m_threadPool->ParallelFor(objects.size(), stepObject, m_threadSplit.objectWorkers);
+
+    return std::all_of(objects.begin(), objects.end(),
+                       [](SceneObject* object) { return object->GetPhysicsWorkspace().ok; });
 }
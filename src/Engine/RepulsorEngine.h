@@ -4,16 +4,153 @@
 #include <array>
 #include <memory>
 #include <mutex>
+#include <span>
+#include <string>
 #include <vector>
 
 #include "../Config/Config.h"
 #include "../Utils/GlobalTypes.h"
+#include "../Utils/Helpers.h"
+#include "../Utils/ThreadBudget.h"
+#include "../Utils/TransformKernels.h"
 
 class SceneObject;
 namespace Utils {
-struct CombinedObstacleGeometry;
+class ThreadPool;
+}  // namespace Utils
+
+// Quantities requested from RepulsorEngine::Evaluate. Combine with operator|.
+enum class EvalFlags : unsigned {
+    None = 0,
+    Energy = 1u << 0,
+    Differential = 1u << 1,
+    Gradient = 1u << 2,  // Implies a differential evaluation
+    StepSize = 1u << 3,  // Safe step size along the negative gradient; implies Gradient
+};
+
+constexpr EvalFlags operator|(EvalFlags a, EvalFlags b) {
+    return static_cast<EvalFlags>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+constexpr EvalFlags& operator|=(EvalFlags& a, EvalFlags b) {
+    return a = a | b;
+}
+constexpr bool HasFlag(EvalFlags flags, EvalFlags flag) {
+    return (static_cast<unsigned>(flags) & static_cast<unsigned>(flag)) != 0;
+}
+
+// Everything computed by one Evaluate call. Fields not listed in `computed` are left empty.
+struct EvaluationResult {
+    Real energy = 0.0;
+    Tensors::Tensor2<Real, Int> differential;
+    Tensors::Tensor2<Real, Int> gradient;
+    Real stepSize = 0.0;  // MaximumSafeStepSize along -gradient, capped at 1
+    EvalFlags computed = EvalFlags::None;
+};
+
+// Backtracking line search state of one object (or the shared scene mesh), carried across physics steps.
+struct LineSearchState {
+    Tensors::Tensor2<Real, Int> trial;  // Trial world coordinates; scratch, kept to reuse its buffer
+    Real step = 0.0;  // Where the next search starts from (times Opt.lineSearchGrowth); 0 starts at the safe step
+
+    // The most recent search, for logs and the UI
+    Real initialEnergy = 0.0;
+    Real energy = 0.0;  // At the accepted step, initialEnergy if none was accepted
+    Real acceptedStep = 0.0;
+    int trials = 0;
+    long long searches = 0;
+    long long totalTrials = 0;
+};
+
+// L-BFGS or Nesterov history of one object (or the shared scene mesh), carried across physics steps. Positions,
+// differentials and velocities are world-space N x 3 tensors, sized on first use and reused afterwards.
+struct OptimizerState {
+    OptimizerType type = OptimizerType::GradientDescent;  // The optimizer the history belongs to
+
+    // --- L-BFGS ---
+    std::vector<Tensors::Tensor2<Real, Int>> s;  // Ring of Opt.lbfgsHistory position changes
+    std::vector<Tensors::Tensor2<Real, Int>> y;  // Matching differential changes
+    std::vector<Real> rho;                       // 1 / <s, y>
+    std::vector<Real> alpha;                     // Two-loop recursion scratch
+    int pairs = 0;                               // Valid pairs, ending at `newest`
+    int newest = -1;
+    Tensors::Tensor2<Real, Int> lastCoordinates;  // Where the previous step was evaluated
+    Tensors::Tensor2<Real, Int> lastDifferential;
+    bool hasLast = false;
+    // Warm start and tolerance schedule of the solve on the two-loop right-hand side. It is not the object's
+    // gradient, so it must not become the initial guess or the tolerance reference of gradient solves.
+    Utils::SolverState solverState;
+
+    // --- Nesterov ---
+    Tensors::Tensor2<Real, Int> velocity;
+    bool hasVelocity = false;
+
+    Tensors::Tensor2<Real, Int> scratch;  // Right-hand side of the L-BFGS solve, or the accelerated step
+
+    // --- Statistics ---
+    bool fellBack = false;  // The last step was a plain gradient step because the safe step size limited it
+    long long steps = 0;
+    long long fallbacks = 0;
+
+    void Reset() {  // Forgets the history but keeps the pair buffers
+        pairs = 0;
+        newest = -1;
+        hasLast = false;
+        hasVelocity = false;
+        solverState = Utils::SolverState();
+    }
+};
+
+// Per-object physics step buffers, owned by SceneObject and sized when it is created. Steps evaluate into them
+// instead of returning fresh tensors, so a step on a loaded scene does not allocate in our code.
+struct PhysicsWorkspace {
+    EvaluationResult evaluation;  // After CalculateStepDisplacements, `gradient` holds the world displacement
+    LineSearchState lineSearch;   // Only used with Opt.lineSearch
+    OptimizerState optimizer;     // Only used with an Opt.optimizer other than GradientDescent
+    bool ok = false;
+    std::string error;  // Why the last step evaluation failed
+};
+
+// An object's self-repulsion as of its last deformation, owned by SceneObject. The self term does not change under
+// rigid motion, and its differential only turns with the object, so while the object is merely dragged or rotated it
+// is reused instead of evaluated again. Invalidated whenever the vertices or the mesh settings change.
+struct SelfEnergyCache {
+    bool valid = false;
+    bool hasDifferential = false;
+    Real energy = 0.0;
+    Tensors::Tensor2<Real, Int> differential;  // World frame of `transform`
+    Utils::AffineTransform transform;          // Object transform the self term was evaluated at
+    Utils::AffineTransform rotation;           // Linear map from that frame to the current one; set on lookup
+    long long evaluations = 0;
+    long long reuses = 0;
+};
+
+// How far an object has deformed since its Repulsor mesh was built, owned by SceneObject. Coordinate updates
+// (SemiStaticUpdate) keep the cluster tree's structure and recompute its boxes, so rigid motion leaves the tree as
+// tight as it was, while deformation loosens it. With TPE.treeRebuildDrift above 0, the mesh is rebuilt once the
+// deformation since it was built exceeds that fraction of the object's size. This only bounds how loose a tree gets;
+// no tree is reused beyond what SemiStaticUpdate already does. Obstacles containing the object apply the same rule.
+struct ClusterTreeState {
+    Real drift = 0.0;  // Sum of the largest vertex movement of every deformation so far; never reset
+    Real builtAtDrift = 0.0;  // `drift` when the mesh was built
+    Real extent = 0.0;        // Largest world bounding box extent when the mesh was built
+    long long refits = 0;
+    long long rebuilds = 0;
+};
+
+// Whether a cluster tree over an object of size `extent`, whose vertices moved by up to `drift` since the tree was
+// built, should be rebuilt rather than refitted. `maxRelativeDrift` <= 0 always refits.
+inline bool clusterTreeDrifted(Real drift, Real extent, Real maxRelativeDrift) {
+    return maxRelativeDrift > 0.0 && extent > 0.0 && drift > maxRelativeDrift * extent;
 }
 
+// Per-object outcome of a batched calculation, index-aligned with the input span.
+template <typename T>
+struct BatchResult {
+    T value{};
+    bool ok = false;
+    std::string error;
+};
+
 class RepulsorEngine {
   public:
     explicit RepulsorEngine(const ConfigType& config);
@@ -21,36 +158,146 @@ class RepulsorEngine {
 
     // --- Mesh Management ---
     bool InitializeRepulsorMesh(SceneObject& object);
+    // Creates the meshes of several simulated objects at once, spread across the worker pool like other batches
+    std::vector<BatchResult<bool>> InitializeRepulsorMeshes(std::span<SceneObject* const> objects);
+    // After transform changes or replaced coordinates: syncs the object's world coordinates and passes them on with
+    // RefitRepulsorMesh, so a deformed mesh may be rebuilt (check ClusterTreeState::rebuilds). False on failure.
     bool UpdateRepulsorMeshState(SceneObject& object);
+    // Hands the object's world coordinates to its mesh with SemiStaticUpdate, the same update as before drift
+    // tracking. If the object deformed too far since the mesh was built, the mesh is rebuilt instead so the tree fits
+    // again (see ClusterTreeState). A rebuilt mesh has no obstacle loaded. Returns whether it was rebuilt; throws on
+    // failure.
+    bool RefitRepulsorMesh(SceneObject& object);
     void ApplyCurrentConfigToMesh(SceneObject& object);
+    void ApplyCurrentConfigToMesh(Mesh_T& mesh);
     std::unique_ptr<Mesh_T> CreateObstacleMesh(const std::vector<std::array<Real, 3>>& vertices,
                                                const std::vector<std::array<Int, 3>>& simplices);
+    // Standalone mesh over the whole scene; may use the whole thread budget since it is evaluated on its own.
+    std::unique_ptr<Mesh_T> CreateSceneMesh(const std::vector<std::array<Real, 3>>& vertices,
+                                            const std::vector<std::array<Int, 3>>& simplices);
+    bool UpdateMeshCoordinates(Mesh_T& mesh, std::span<const std::array<Real, 3>> vertices);  // Utils::VertexSpan
+    bool LoadObstacle(SceneObject& target, std::unique_ptr<Mesh_T> obstacleMesh);
+    // Moves the already loaded obstacle to new coordinates, keeping its topology and cluster tree layout.
+    bool UpdateObstacleCoordinates(SceneObject& target, const std::vector<std::array<Real, 3>>& vertices);
 
     // --- Physics Calculations ---
+    // Computes any mix of energy, differential, gradient and step size from a single cache build.
+    EvaluationResult Evaluate(SceneObject& object, EvalFlags what);
     Tensors::Tensor2<Real, Int> CalculateWorldDisplacement(SceneObject& object);
     Tensors::Tensor2<Real, Int> GetDifferential(SceneObject& object);
     Tensors::Tensor2<Real, Int> GetGradient(SceneObject& object);
     Real GetEnergy(SceneObject& object);
+    // Evaluates the self tangent-point energy of a standalone mesh, e.g. the shared scene mesh.
+    EvaluationResult EvaluateSceneMesh(Mesh_T& mesh, Utils::SolverState& state, EvalFlags what);
+    // Same, reusing the buffers already held by `result`.
+    void EvaluateSceneMeshInto(Mesh_T& mesh, Utils::SolverState& state, EvalFlags what, EvaluationResult& result);
+
+    // --- Batched Physics Calculations (objects are spread across the worker pool) ---
+    // `frames`, if given, holds each object's transform as of the last flush; batches running off the main thread
+    // must pass it, since the main thread may move objects meanwhile.
+    std::vector<BatchResult<EvaluationResult>> EvaluateBatch(std::span<SceneObject* const> objects, EvalFlags what,
+                                                             std::span<const glm::mat4> frames = {});
+    std::vector<BatchResult<Tensors::Tensor2<Real, Int>>>
+    CalculateWorldDisplacements(std::span<SceneObject* const> objects);
+    std::vector<BatchResult<Tensors::Tensor2<Real, Int>>> GetDifferentials(std::span<SceneObject* const> objects);
+    std::vector<BatchResult<Tensors::Tensor2<Real, Int>>> GetGradients(std::span<SceneObject* const> objects);
+    std::vector<BatchResult<Real>> GetEnergies(std::span<SceneObject* const> objects);
+    // Physics step: writes each object's world displacement into its PhysicsWorkspace. False if any object failed;
+    // its workspace carries the error. The direction comes from Opt.optimizer; with Opt.lineSearch its length comes
+    // from a line search.
+    bool CalculateStepDisplacements(std::span<SceneObject* const> objects);
+    // Physics step of a standalone mesh, e.g. the shared scene mesh, whose world coordinates are `coords`. Like
+    // CalculateStepDisplacements, leaves the world displacement in workspace.evaluation.gradient.
+    void CalculateSceneMeshStep(Mesh_T& mesh, Utils::SolverState& state, const Real* coords,
+                                PhysicsWorkspace& workspace);
 
     // --- Parameter Updates ---
     void UpdateEngineParameters();  // Called when config changes
 
+    // --- Thread Budget ---
+    // Splits the thread budget for a scene whose simulated objects have these vertex counts. Call before creating
+    // the scene's meshes: a mesh's Repulsor thread count is fixed when it is created.
+    void PlanThreads(std::span<const std::size_t> vertexCounts);
+    const Utils::ThreadSplit& GetThreadSplit() const {
+        return m_threadSplit;
+    }
+
   private:
+    // Energy/metric objects are not safe to share between threads, so each pool worker owns a pair.
+    struct WorkerContext {
+        std::unique_ptr<Energy_T> energyObj;      // Interaction with the loaded obstacle
+        std::unique_ptr<Energy_T> selfEnergyObj;  // Self-repulsion of a standalone mesh
+        std::unique_ptr<Metric_T> metricObj;
+    };
+
     void UpdateMeshParametersInternal(Mesh_T* meshPtr);
     void CreateOrUpdateEnergyMetricObjects();
+    std::unique_lock<std::mutex> LockWorkers();  // Locks m_energyMetricMutex, timing the wait
+    int GetThreadBudget() const;
+    void UpdateThreadSplit();  // From the config and the planned vertex counts; m_energyMetricMutex must be held
+
+    void CreateRepulsorMesh(SceneObject& object);  // Throws on failure and logs nothing, so batches can call it
+    std::unique_ptr<Mesh_T> MakeMesh(const std::vector<std::array<Real, 3>>& vertices,
+                                     const std::vector<std::array<Int, 3>>& simplices, int threadCount);
+    // `frame` is the transform the object's mesh coordinates were synced with; null reads the current transform,
+    // which only the main thread may do.
+    EvaluationResult EvaluateInternal(SceneObject& object, EvalFlags what, WorkerContext& ctx,
+                                      const glm::mat4* frame = nullptr);
+    void EvaluateInto(SceneObject& object, EvalFlags what, WorkerContext& ctx, EvaluationResult& result,
+                      const glm::mat4* frame = nullptr);
+    // Shared core of every evaluation. Overwrites `result`, reusing its tensors when their shapes still fit. With
+    // `selfOf`, the object's cached self term is added to `energy`'s before the metric solve; `selfFrame` as for
+    // EvaluateInto.
+    void EvaluateMeshInto(Mesh_T& mesh, Utils::SolverState& state, EvalFlags what, Energy_T& energy,
+                          WorkerContext& ctx, EvaluationResult& result, SceneObject* selfOf = nullptr,
+                          const glm::mat4* selfFrame = nullptr);
+    // Backtracking (Armijo) search along -gradient. workspace.evaluation must hold the energy, differential and
+    // gradient of `mesh` at `coords`, its current world coordinates. Trial points only cost an energy evaluation
+    // (`energy`, plus `selfEnergy` if given). Leaves the world displacement of the accepted step in
+    // workspace.evaluation.gradient and `mesh` back at `coords`.
+    void LineSearchInto(Mesh_T& mesh, const Real* coords, Energy_T& energy, Energy_T* selfEnergy,
+                        PhysicsWorkspace& workspace);
+    // One physics step of `mesh` at `coords` with the configured optimizer and step rule. Arguments as for
+    // EvaluateMeshInto; leaves the world displacement in workspace.evaluation.gradient.
+    void StepMeshInto(Mesh_T& mesh, Utils::SolverState& state, const Real* coords, Energy_T& energy,
+                      WorkerContext& ctx, SceneObject* selfOf, PhysicsWorkspace& workspace);
+    // Records the secant pair of the previous step and runs the L-BFGS two-loop recursion on the differential, with
+    // a metric solve as the initial inverse Hessian. Leaves the direction (a descent step of length 1 along its
+    // negative) in workspace.evaluation.gradient.
+    void LbfgsDirectionInto(Mesh_T& mesh, const Real* coords, WorkerContext& ctx, PhysicsWorkspace& workspace);
+    // Turns the gradient step G in workspace.evaluation.gradient into Nesterov's mu^2 v + (1 + mu) G and sets the
+    // velocity v to mu v + G. Restarts from G when the momentum points uphill or the safe step size would shorten
+    // the accelerated step.
+    void ApplyMomentum(Mesh_T& mesh, PhysicsWorkspace& workspace);
+    void SolveMetric(Mesh_T& mesh, Utils::SolverState& state, WorkerContext& ctx,
+                     const Tensors::Tensor2<Real, Int>& diff, Tensors::Tensor2<Real, Int>& gradient);
+    Real ComputeSolverTolerance(Utils::SolverState& state, Real diffNorm) const;
+    // The object's self energy (and differential, if wanted) with its mesh in `frame`, evaluated only if the cache
+    // cannot be rotated into place. The mesh cache must be fresh.
+    const SelfEnergyCache& RefreshSelfEnergy(SceneObject& object, const glm::mat4& frame, bool wantDiff,
+                                             WorkerContext& ctx);
+    static Tensors::Tensor2<Real, Int> ToWorldDisplacement(EvaluationResult&& result);
+
+    template <typename T, typename Fn>
+    std::vector<BatchResult<T>> RunBatch(std::span<SceneObject* const> objects, const char* what, Fn&& fn);
 
     const ConfigType& m_config;
 
     // Factories owned by the engine
     std::unique_ptr<TPE_Factory_T> m_tpeFactory;
+    std::unique_ptr<TPSE_Factory_T> m_tpseFactory;
     std::unique_ptr<TPM_Factory_T> m_tpmFactory;
 
-    // Energy/Metric objects
-    std::unique_ptr<Energy_T> m_energyObj;
-    std::unique_ptr<Metric_T> m_metricObj;
+    // Application worker pool, sized to the thread budget, and one energy/metric pair per worker. Batches only use
+    // the first m_threadSplit.objectWorkers of them. m_workers[0] also serves single-object calls.
+    std::unique_ptr<Utils::ThreadPool> m_threadPool;
+    std::vector<WorkerContext> m_workers;
+    bool m_threadsPinned = false;
+    Utils::ThreadSplit m_threadSplit;
+    std::vector<std::size_t> m_plannedVertexCounts;
     double m_current_p = -1.0;
     double m_current_q = -1.0;
-    std::mutex m_energyMetricMutex;
+    std::mutex m_energyMetricMutex;  // Guards m_workers against recreation while a calculation is running
 };
 
 #endif  // REPULSOR_ENGINE_H
\ No newline at end of file
@@ -2,53 +2,75 @@
 #define VISUALIZATION_ENGINE_H
 
 #include <glm/glm.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "../Data/SceneDefinition.h"
 #include "../Utils/GlobalTypes.h"  // For Real type if needed for vectors
 
 class SceneObject;
-struct ConfigType;
-
-namespace polyscope {
-enum class UpDir;
-enum class FrontDir;
-}  // namespace polyscope
 
+// Rendering interface used by the scene and application layers. The interactive app plugs in the Polyscope
+// implementation; headless runs use NullVisualizationEngine so the core never depends on a viewer.
 class VisualizationEngine {
   public:
-    explicit VisualizationEngine(const ConfigType& config);
-    ~VisualizationEngine() = default;
+    virtual ~VisualizationEngine() = default;
 
     // --- Object Management ---
-    bool RegisterObject(SceneObject& object);
-    bool RemoveObjectByName(const std::string& name);
-    void RemoveAllObjects();
+    virtual bool RegisterObject(SceneObject& object) = 0;
+    virtual bool RemoveObjectByName(const std::string& name) = 0;
+    virtual void RemoveAllObjects() = 0;
 
     // --- Updates ---
-    void UpdateObjectTransform(SceneObject& object);
-    void UpdateObjectVertices(SceneObject& object);
-    void UpdateActiveGizmo(const std::string& oldActiveName, const std::string& newActiveName);
+    virtual void UpdateObjectTransform(SceneObject& object) = 0;
+    virtual void UpdateObjectVertices(SceneObject& object) = 0;
+    virtual void UpdateActiveGizmo(const std::string& oldActiveName, const std::string& newActiveName) = 0;
 
     // --- Vector Visualization ---
-    void UpdateVectorQuantity(SceneObject& object, const std::string& quantityName,
-                              const std::vector<glm::vec3>& vectors);
-    void RemoveVectorQuantity(SceneObject& object, const std::string& quantityName);
-    void RemoveAllVectorQuantities(SceneObject& object);
+    virtual void UpdateVectorQuantity(SceneObject& object, const std::string& quantityName,
+                                      const std::vector<glm::vec3>& vectors) = 0;
+    virtual void RemoveVectorQuantity(SceneObject& object, const std::string& quantityName) = 0;
+    virtual void RemoveAllVectorQuantities(SceneObject& object) = 0;
 
     // --- Obstacle Visuals ---
-    void UpdateSingleObstacleVisual(SceneObject& targetObject);
-    void ShowObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>& objects);
-    void HideObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>& objects);
+    virtual void UpdateSingleObstacleVisual(SceneObject& targetObject) = 0;
+    virtual void ShowObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>& objects) = 0;
+    virtual void HideObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>& objects) = 0;
 
     // --- General ---
-    void RequestRedraw();
-    void SetCameraView(const glm::vec3& position, const glm::vec3& lookAt, polyscope::UpDir upDir,
-                       polyscope::FrontDir frontDir);
-    void ResetCamera();
+    virtual void RequestRedraw() = 0;
+    virtual void SetCameraView(const glm::vec3& position, const glm::vec3& lookAt, CameraUpDir upDir,
+                               CameraFrontDir frontDir) = 0;
+    virtual void ResetCamera() = 0;
+};
+
+// Accepts every call and draws nothing. Registration reports success so scene loading proceeds normally.
+class NullVisualizationEngine : public VisualizationEngine {
+  public:
+    bool RegisterObject(SceneObject&) override {
+        return true;
+    }
+    bool RemoveObjectByName(const std::string&) override {
+        return true;
+    }
+    void RemoveAllObjects() override {}
+
+    void UpdateObjectTransform(SceneObject&) override {}
+    void UpdateObjectVertices(SceneObject&) override {}
+    void UpdateActiveGizmo(const std::string&, const std::string&) override {}
+
+    void UpdateVectorQuantity(SceneObject&, const std::string&, const std::vector<glm::vec3>&) override {}
+    void RemoveVectorQuantity(SceneObject&, const std::string&) override {}
+    void RemoveAllVectorQuantities(SceneObject&) override {}
+
+    void UpdateSingleObstacleVisual(SceneObject&) override {}
+    void ShowObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>&) override {}
+    void HideObstaclesForAll(const std::vector<std::unique_ptr<SceneObject>>&) override {}
 
-  private:
-    const ConfigType& m_config;
+    void RequestRedraw() override {}
+    void SetCameraView(const glm::vec3&, const glm::vec3&, CameraUpDir, CameraFrontDir) override {}
+    void ResetCamera() override {}
 };
 
-#endif  // VISUALIZATION_ENGINE_H
\ No newline at end of file
+#endif  // VISUALIZATION_ENGINE_H
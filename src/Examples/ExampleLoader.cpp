@@ -1,10 +1,8 @@
 #include "ExampleLoader.h"
 
-#include <polyscope/polyscope.h>
-#include <polyscope/view.h>
-
 #include <stdexcept>
 
+#include "../Utils/Log.h"
 #include "FCCLatticeSpheres.h"
 
 using EmbeddedData::two_spheres_simplex_count;
@@ -22,7 +20,7 @@ std::shared_ptr<MeshData> ExampleLoader::s_obstacleSphereTemplate = nullptr;
 
 std::shared_ptr<MeshData> ExampleLoader::GetSphereTemplate() {
     if (!s_sphereTemplate) {
-        polyscope::info("Loading sphere template data...");
+        Log::info("Loading sphere template data...");
 
         if (two_spheres_vertex_count == 0 || two_spheres_simplex_count == 0) {
             throw std::runtime_error("Global sphere template data not loaded/defined.");
@@ -34,19 +32,19 @@ std::shared_ptr<MeshData> ExampleLoader::GetSphereTemplate() {
             s_sphereTemplate->vertices[i] = {two_spheres_vertex_coordinates[i][0], two_spheres_vertex_coordinates[i][1],
                                              two_spheres_vertex_coordinates[i][2]};
         }
-        s_sphereTemplate->simplices.resize(two_spheres_simplex_count);
+        std::vector<std::array<Int, dom_dim + 1>> simplices(two_spheres_simplex_count);
         for (size_t i = 0; i < two_spheres_simplex_count; ++i) {
-            s_sphereTemplate->simplices[i] = {two_spheres_simplices[i][0], two_spheres_simplices[i][1],
-                                              two_spheres_simplices[i][2]};
+            simplices[i] = {two_spheres_simplices[i][0], two_spheres_simplices[i][1], two_spheres_simplices[i][2]};
         }
-        polyscope::info("Sphere template loaded.");
+        s_sphereTemplate->topology = makeMeshTopology(std::move(simplices), two_spheres_vertex_count);
+        Log::info("Sphere template loaded.");
     }
     return s_sphereTemplate;
 }
 
 std::shared_ptr<MeshData> ExampleLoader::GetObstacleSphereTemplate() {
     if (!s_obstacleSphereTemplate) {
-        polyscope::info("Loading obstacle sphere template data from EmbeddedData...");
+        Log::info("Loading obstacle sphere template data from EmbeddedData...");
 
         if (two_spheres_obstacle_vertex_count == 0 || two_spheres_obstacle_simplex_count == 0) {
             throw std::runtime_error("Embedded obstacle sphere template data is empty or invalid.");
@@ -59,13 +57,13 @@ std::shared_ptr<MeshData> ExampleLoader::GetObstacleSphereTemplate() {
                                                      two_spheres_obstacle_vertex_coordinates[i][1],
                                                      two_spheres_obstacle_vertex_coordinates[i][2]};
         }
-        s_obstacleSphereTemplate->simplices.resize(two_spheres_obstacle_simplex_count);
+        std::vector<std::array<Int, dom_dim + 1>> simplices(two_spheres_obstacle_simplex_count);
         for (size_t i = 0; i < two_spheres_obstacle_simplex_count; ++i) {
-            s_obstacleSphereTemplate->simplices[i] = {two_spheres_obstacle_simplices[i][0],
-                                                      two_spheres_obstacle_simplices[i][1],
-                                                      two_spheres_obstacle_simplices[i][2]};
+            simplices[i] = {two_spheres_obstacle_simplices[i][0], two_spheres_obstacle_simplices[i][1],
+                            two_spheres_obstacle_simplices[i][2]};
         }
-        polyscope::info("Obstacle sphere template loaded.");
+        s_obstacleSphereTemplate->topology = makeMeshTopology(std::move(simplices), two_spheres_obstacle_vertex_count);
+        Log::info("Obstacle sphere template loaded.");
     }
     return s_obstacleSphereTemplate;
 }
@@ -84,8 +82,8 @@ SceneDefinition ExampleLoader::LoadExample(ExampleId exampleId) {
 SceneDefinition ExampleLoader::CreateFCC4SphereScene() {
     SceneDefinition scene;
     scene.sceneName = "FCC 4 Spheres";
-    scene.upDir = polyscope::UpDir::YUp;
-    scene.frontDir = polyscope::FrontDir::NegYFront;
+    scene.upDir = CameraUpDir::YUp;
+    scene.frontDir = CameraFrontDir::NegYFront;
 
     std::shared_ptr<MeshData> sphereMesh = GetSphereTemplate();
 
@@ -99,8 +97,10 @@ SceneDefinition ExampleLoader::CreateFCC4SphereScene() {
     // ---
 
     for (int i = 0; i < raw_data_fcc.size(); ++i) {
-        auto uniqueMeshData = std::make_shared<MeshData>(*sphereMesh);
-        uniqueMeshData->vertices = raw_data_fcc[i];
+        // Every lattice site gets its own vertices but references the template's connectivity
+        auto uniqueMeshData = std::make_shared<MeshData>();
+        uniqueMeshData->vertices = std::move(raw_data_fcc[i]);
+        uniqueMeshData->topology = sphereMesh->topology;
 
         scene.objectDefs.emplace_back(i,                    // id
                                       "sphere",             // baseName
@@ -122,8 +122,8 @@ SceneDefinition ExampleLoader::CreateFCC4SphereScene() {
 SceneDefinition ExampleLoader::CreateTwoSphereScene() {
     SceneDefinition scene;
     scene.sceneName = "Two Spheres";
-    scene.upDir = polyscope::UpDir::NegXUp;
-    scene.frontDir = polyscope::FrontDir::NegYFront;
+    scene.upDir = CameraUpDir::NegXUp;
+    scene.frontDir = CameraFrontDir::NegYFront;
 
     std::shared_ptr<MeshData> mainSphereGeo = GetSphereTemplate();
     std::shared_ptr<MeshData> obstacleSphereGeo = GetObstacleSphereTemplate();
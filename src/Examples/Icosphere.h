@@ -0,0 +1,79 @@
+#ifndef ICOSPHERE_H
+#define ICOSPHERE_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "../Data/MeshData.h"
+
+// Unit-sphere triangulation from a subdivided icosahedron, centered at the origin.
+// Level 0 has 12 vertices; every level quadruples the faces (10 * 4^n + 2 vertices).
+inline MeshData createIcosphere(int subdivisions, Real radius = 1.0) {
+    MeshData mesh;
+    std::vector<std::array<Int, dom_dim + 1>> simplices;
+
+    const Real t = (1.0 + std::sqrt(5.0)) / 2.0;
+    mesh.vertices = {{-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0}, {0, -1, t}, {0, 1, t},
+                     {0, -1, -t}, {0, 1, -t}, {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1}};
+    simplices = {{0, 11, 5}, {0, 5, 1},  {0, 1, 7},  {0, 7, 10}, {0, 10, 11},  // Around vertex 0
+                 {1, 5, 9},  {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},   // Adjacent band
+                 {3, 9, 4},  {3, 4, 2},  {3, 2, 6},  {3, 6, 8},  {3, 8, 9},    // Around vertex 3
+                 {4, 9, 5},  {2, 4, 11}, {6, 2, 10}, {8, 6, 7},  {9, 8, 1}};   // Adjacent band
+
+    auto normalize = [](std::array<Real, amb_dim>& v) {
+        Real len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        for (Real& c : v) {
+            c /= len;
+        }
+    };
+    for (auto& v : mesh.vertices) {
+        normalize(v);
+    }
+
+    for (int level = 0; level < subdivisions; ++level) {
+        std::map<std::pair<Int, Int>, Int> midpoints;  // Shared edges get a single new vertex
+        auto midpoint = [&](Int a, Int b) {
+            auto key = std::minmax(a, b);
+            auto it = midpoints.find(key);
+            if (it != midpoints.end()) {
+                return it->second;
+            }
+            std::array<Real, amb_dim> m;
+            for (int d = 0; d < amb_dim; ++d) {
+                m[d] = 0.5 * (mesh.vertices[a][d] + mesh.vertices[b][d]);
+            }
+            normalize(m);
+            Int index = static_cast<Int>(mesh.vertices.size());
+            mesh.vertices.push_back(m);
+            midpoints.emplace(key, index);
+            return index;
+        };
+
+        std::vector<std::array<Int, dom_dim + 1>> refined;
+        refined.reserve(simplices.size() * 4);
+        for (const auto& f : simplices) {
+            Int ab = midpoint(f[0], f[1]);
+            Int bc = midpoint(f[1], f[2]);
+            Int ca = midpoint(f[2], f[0]);
+            refined.push_back({f[0], ab, ca});
+            refined.push_back({f[1], bc, ab});
+            refined.push_back({f[2], ca, bc});
+            refined.push_back({ab, bc, ca});
+        }
+        simplices = std::move(refined);
+    }
+
+    for (auto& v : mesh.vertices) {
+        for (Real& c : v) {
+            c *= radius;
+        }
+    }
+    mesh.topology = makeMeshTopology(std::move(simplices), mesh.vertices.size());
+    return mesh;
+}
+
+#endif  // ICOSPHERE_H
@@ -0,0 +1,433 @@
+#include "HeadlessRunner.h"
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+#include "../Engine/RepulsorEngine.h"
+#include "../Engine/VisualizationEngine.h"
+#include "../Examples/ExampleLoader.h"
+#include "../IO/Checkpoint.h"
+#include "../IO/MeshImporter.h"
+#include "../IO/Trajectory.h"
+#include "../Scene/SceneManager.h"
+#include "../Scene/SceneObject.h"
+#include "../Utils/BackgroundWorker.h"
+#include "../Utils/Log.h"
+#include "../Utils/Profiler.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+const std::map<std::string, ExampleId>& SceneNames() {
+    static const std::map<std::string, ExampleId> names = {
+        {"fcc4", ExampleId::FCC_4},
+        {"two_spheres", ExampleId::TWO_SPHERES},
+    };
+    return names;
+}
+
+}  // namespace
+
+HeadlessRunner::HeadlessRunner(const ConfigType& config, const HeadlessOptions& options)
+    : m_config(config), m_options(options) {
+    m_repulsorEngine = std::make_unique<RepulsorEngine>(m_config);
+    m_vizEngine = std::make_unique<NullVisualizationEngine>();
+    m_sceneManager = std::make_unique<SceneManager>(*m_repulsorEngine, *m_vizEngine, m_config);
+    m_checkpointWorker = std::make_unique<Utils::BackgroundWorker>();
+}
+
+HeadlessRunner::~HeadlessRunner() {
+    m_checkpointWorker.reset();  // Finishes a save in progress before the scene goes away
+    m_recorder.reset();
+}
+
+int HeadlessRunner::Run() {
+    if (m_options.tracePath.empty()) {
+        return RunIterations();
+    }
+
+    Profiler::beginTrace();
+    int exitCode = RunIterations();
+    std::string error;
+    if (!Profiler::writeTrace(m_options.tracePath, error)) {
+        Log::error("Headless: " + error);
+        return EXIT_FAILURE;
+    }
+    return exitCode;
+}
+
+bool HeadlessRunner::LoadScene() {
+    try {
+        SceneDefinition sceneDef;
+        unsigned long long completedSteps = 0;
+        if (!m_options.restorePath.empty()) {
+            IO::Checkpoint checkpoint = IO::readCheckpoint(m_options.restorePath, m_config);
+            m_config = checkpoint.config;
+            m_repulsorEngine->UpdateEngineParameters();  // Meshes are created with the restored parameters
+            sceneDef = std::move(checkpoint.scene);
+            completedSteps = checkpoint.completedSteps;
+        } else if (!m_options.meshPaths.empty()) {
+            sceneDef = IO::createMeshScene(m_options.meshPaths, m_config.TPE.threadBudget);
+        } else {
+            sceneDef = ExampleLoader::LoadExample(m_options.example);
+        }
+        if (!m_sceneManager->LoadScene(sceneDef)) {
+            Log::error("Headless: Scene loading failed.");
+            return false;
+        }
+        m_sceneManager->SetCompletedSteps(completedSteps);
+    } catch (const std::exception& e) {
+        Log::error("Headless: Exception during scene load: " + std::string(e.what()));
+        return false;
+    }
+    return true;
+}
+
+int HeadlessRunner::RunIterations() {
+    if (!LoadScene()) {
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream file;
+    if (!m_options.outputPath.empty()) {
+        file.open(m_options.outputPath);
+        if (!file) {
+            Log::error("Headless: Cannot open output file " + m_options.outputPath);
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& out = file.is_open() ? static_cast<std::ostream&>(file) : std::cout;
+    out << "iteration,energy,step_ms,energy_ms\n" << std::setprecision(17);
+
+    double energy = 0.0;
+    double energyMs = 0.0;
+    if (!MeasureEnergy(energy, energyMs)) {
+        return EXIT_FAILURE;
+    }
+    out << m_sceneManager->GetCompletedSteps() << ',' << energy << ',' << 0.0 << ',' << energyMs << '\n';
+    if (m_options.record && !StartRecording()) {
+        return EXIT_FAILURE;
+    }
+
+    for (int iter = 1; iter <= m_options.iterations; ++iter) {
+        Clock::time_point stepStart = Clock::now();
+        bool stepOk = m_sceneManager->ApplyPhysicsStep(1);
+        double stepMs = ElapsedMs(stepStart);
+        if (!stepOk) {
+            Log::error("Headless: Physics step " + std::to_string(iter) + " failed.");
+            return EXIT_FAILURE;
+        }
+        if (m_recorder) {
+            RecordFrame();  // Not part of step_ms
+        }
+
+        if (!MeasureEnergy(energy, energyMs)) {
+            return EXIT_FAILURE;
+        }
+        const unsigned long long completedSteps = m_sceneManager->GetCompletedSteps();
+        out << completedSteps << ',' << energy << ',' << stepMs << ',' << energyMs << '\n';
+        out.flush();  // Keep partial results of long runs
+        TPE_PROFILE_END_FRAME();
+
+        const int autosaveSteps = m_config.Checkpoint.autosaveSteps;
+        if (m_options.saveCheckpoint && autosaveSteps > 0 && completedSteps % autosaveSteps == 0 &&
+            iter < m_options.iterations) {
+            SaveCheckpoint();
+        }
+    }
+
+    LogClusterTreeStats();
+    if (m_recorder && !StopRecording()) {
+        return EXIT_FAILURE;
+    }
+    if (m_options.saveCheckpoint) {
+        SaveCheckpoint();
+        m_checkpointWorker->Wait();
+        if (m_checkpointFailed) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+void HeadlessRunner::LogClusterTreeStats() const {
+    long long refits = 0;
+    long long rebuilds = 0;
+    for (SceneObject* obj : m_sceneManager->GetSimulatedObjects()) {
+        refits += obj->GetClusterTreeState().refits;
+        rebuilds += obj->GetClusterTreeState().rebuilds;
+    }
+    Log::info("Headless: Cluster trees refitted " + std::to_string(refits) + " time(s), rebuilt " +
+              std::to_string(rebuilds) + " time(s); " +
+              std::to_string(m_sceneManager->GetBroadPhaseStats().driftRebuilds) + " obstacle rebuild(s).");
+}
+
+bool HeadlessRunner::StartRecording() {
+    std::vector<IO::TrajectoryObject> objects;
+    for (const auto& objPtr : m_sceneManager->GetObjects()) {
+        objects.push_back({objPtr->GetId(), objPtr->GetInitialVertices().size()});
+    }
+    IO::TrajectoryOptions options;
+    options.quantum = m_config.Recording.quantum;
+    options.keyframeInterval = m_config.Recording.keyframeInterval;
+    options.queueFrames = m_config.Recording.queueFrames;
+    try {
+        m_recorder = std::make_unique<IO::TrajectoryRecorder>(m_config.Recording.path, std::move(objects), options);
+    } catch (const std::exception& e) {
+        Log::error("Headless: " + std::string(e.what()));
+        return false;
+    }
+    RecordFrame();  // The initial state
+    return true;
+}
+
+void HeadlessRunner::RecordFrame() {
+    std::vector<IO::RecordedObject> objects;
+    for (const auto& objPtr : m_sceneManager->GetObjects()) {
+        IO::RecordedObject object;
+        object.vertices = objPtr->GetInitialVertices();
+        object.transform = objPtr->GetCurrentTransform();
+        objects.push_back(object);
+    }
+    m_recorder->Record(m_sceneManager->GetCompletedSteps(), objects);
+}
+
+bool HeadlessRunner::StopRecording() {
+    m_recorder->Close();
+    const std::uint64_t dropped = m_recorder->GetDroppedFrames();
+    Log::info("Headless: Recorded " + std::to_string(m_recorder->GetRecordedFrames()) + " frame(s) to " +
+              m_recorder->GetPath());
+    if (m_recorder->HasFailed()) {
+        Log::error("Headless: Writing " + m_recorder->GetPath() + " failed.");
+        return false;
+    }
+    if (dropped > 0) {
+        // A run without a viewer has nothing better to do than wait for the disk, so gaps are an error here
+        Log::error("Headless: " + std::to_string(dropped) + " frame(s) dropped; raise the queue with --record-queue.");
+        return false;
+    }
+    return true;
+}
+
+void HeadlessRunner::SaveCheckpoint() {
+    // One save at a time: a slow disk holds the run back instead of skipping checkpoints
+    m_checkpointWorker->Wait();
+    auto checkpoint = std::make_shared<IO::Checkpoint>();
+    checkpoint->config = m_config;
+    checkpoint->completedSteps = m_sceneManager->GetCompletedSteps();
+    checkpoint->scene = m_sceneManager->SnapshotScene();
+
+    const std::string path = m_config.Checkpoint.path;
+    m_checkpointWorker->Submit([this, checkpoint, path] {
+        try {
+            IO::writeCheckpoint(path, *checkpoint);
+            Log::info("Headless: Checkpoint at step " + std::to_string(checkpoint->completedSteps) + " saved to " +
+                      path);
+        } catch (const std::exception& e) {
+            Log::error("Headless: Checkpoint save failed: " + std::string(e.what()));
+            m_checkpointFailed = true;
+        }
+    });
+}
+
+bool HeadlessRunner::MeasureEnergy(double& energy, double& elapsedMs) {
+    std::vector<SceneObject*> simulated = m_sceneManager->GetSimulatedObjects();
+
+    Clock::time_point start = Clock::now();
+    std::vector<BatchResult<EvaluationResult>> results;
+    try {
+        results = m_sceneManager->EvaluateObjects(simulated, EvalFlags::Energy);
+    } catch (const std::exception& e) {
+        Log::error("Headless: Energy evaluation failed: " + std::string(e.what()));
+        return false;
+    }
+    elapsedMs = ElapsedMs(start);
+
+    energy = 0.0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].ok) {
+            Log::error("Headless: Energy evaluation failed for " + simulated[i]->GetUniqueName() + ": " +
+                       results[i].error);
+            return false;
+        }
+        energy += results[i].value.energy;
+    }
+    // Shared mode reports the scene energy on every object
+    if (m_sceneManager->IsSharedObstacleActive() && !results.empty()) {
+        energy = results[0].value.energy;
+    }
+    return true;
+}
+
+void HeadlessRunner::PrintUsage(std::ostream& out, const char* programName) {
+    out << "Usage: " << programName << " [options]\n"
+        << "\n"
+        << "Runs physics steps without a viewer and writes iteration,energy,step_ms,energy_ms as CSV.\n"
+        << "\n"
+        << "  --scene <fcc4|two_spheres>  Example scene (default fcc4)\n"
+        << "  --mesh <file>               Simulate an OBJ or binary PLY mesh instead; repeat for more objects\n"
+        << "  --restore <file>            Resume from a checkpoint; its settings replace all but thread options\n"
+        << "  --iterations <n>            Physics steps to run (default 10)\n"
+        << "  --output <file>             Write the CSV to a file instead of stdout\n"
+        << "  --checkpoint <file>         Write a checkpoint of the final state\n"
+        << "  --checkpoint-every <n>      With --checkpoint, also write it every n steps while running\n"
+        << "  --record <file>             Record the trajectory of every step (see the Recording panel)\n"
+        << "  --record-queue <n>          Frames buffered for the trajectory writer (default 16)\n"
+        << "  --trace <file>              Write a Chrome trace of the run (chrome://tracing, Perfetto)\n"
+        << "  --thread-budget <n>         Threads shared by both levels below (0: hardware threads)\n"
+        << "  --threads <n>               Repulsor threads per object (0: by vertex count, from the budget)\n"
+        << "  --object-threads <n>        Objects processed in parallel (0: from the budget)\n"
+        << "  --pin-threads               Bind worker threads to CPUs, NUMA node by node (Linux)\n"
+        << "  --q <value>, --p <value>    Tangent point energy exponents\n"
+        << "  --self-energy               Add each object's self-repulsion to its obstacle interaction\n"
+        << "  --tree-rebuild-drift <value>\n"
+        << "                              Relative drift after which cluster trees are rebuilt (0: never)\n"
+        << "  --theta <value>             Far-field adaptivity parameter\n"
+        << "  --far-field-separation <value>\n"
+        << "  --near-field-separation <value>\n"
+        << "  --max-refinement <n>\n"
+        << "  --split-threshold <n>       Max cluster size before splitting\n"
+        << "  --shared-obstacle           One obstacle mesh over the whole scene (needs --self-energy)\n"
+        << "  --line-search               Choose each step's length by Armijo backtracking\n"
+        << "  --optimizer <name>          Step rule: gradient (default), lbfgs or nesterov\n"
+        << "  --lbfgs-history <n>         Secant pairs kept by L-BFGS (default 8)\n"
+        << "  --momentum <value>          Nesterov momentum coefficient (default 0.9)\n"
+        << "  --culling-radius <value>    Enable distance culling of obstacle sources\n"
+        << "  --verbosity <n>             0: errors only (default), 1: progress, 2: debug detail, on stderr\n"
+        << "  --help                      Show this message\n";
+}
+
+bool HeadlessRunner::ParseArguments(int argc, char** argv, ConfigType& config, HeadlessOptions& options,
+                                    bool& showHelp, std::string& error) {
+    using ValueHandler = std::function<void(const std::string&)>;
+    const std::map<std::string, ValueHandler> valueOptions = {
+        {"--scene",
+         [&](const std::string& v) {
+             auto it = SceneNames().find(v);
+             if (it == SceneNames().end()) {
+                 throw std::invalid_argument("unknown scene '" + v + "'");
+             }
+             options.example = it->second;
+         }},
+        {"--mesh", [&](const std::string& v) { options.meshPaths.push_back(v); }},
+        {"--restore", [&](const std::string& v) { options.restorePath = v; }},
+        {"--iterations", [&](const std::string& v) { options.iterations = std::stoi(v); }},
+        {"--output", [&](const std::string& v) { options.outputPath = v; }},
+        {"--checkpoint",
+         [&](const std::string& v) {
+             config.Checkpoint.path = v;
+             options.saveCheckpoint = true;
+         }},
+        {"--checkpoint-every", [&](const std::string& v) { config.Checkpoint.autosaveSteps = std::stoi(v); }},
+        {"--record",
+         [&](const std::string& v) {
+             config.Recording.path = v;
+             options.record = true;
+         }},
+        {"--record-queue", [&](const std::string& v) { config.Recording.queueFrames = std::stoi(v); }},
+        {"--trace",
+         [&](const std::string& v) {
+#ifdef TPE_PROFILING
+             options.tracePath = v;
+#else
+             throw std::invalid_argument("'" + v + "': this build has no profiling (TPE_ENABLE_PROFILING=OFF)");
+#endif
+         }},
+        {"--thread-budget", [&](const std::string& v) { config.TPE.threadBudget = std::stoi(v); }},
+        {"--threads", [&](const std::string& v) { config.TPE.threadCount = std::stoi(v); }},
+        {"--object-threads", [&](const std::string& v) { config.TPE.objectThreadCount = std::stoi(v); }},
+        {"--q", [&](const std::string& v) { config.TPE.q = std::stod(v); }},
+        {"--p", [&](const std::string& v) { config.TPE.p = std::stod(v); }},
+        {"--theta", [&](const std::string& v) { config.TPE.theta = std::stod(v); }},
+        {"--far-field-separation", [&](const std::string& v) { config.TPE.farFieldSeparation = std::stod(v); }},
+        {"--near-field-separation", [&](const std::string& v) { config.TPE.nearFieldSeparation = std::stod(v); }},
+        {"--max-refinement", [&](const std::string& v) { config.TPE.maxRefinement = std::stoi(v); }},
+        {"--split-threshold", [&](const std::string& v) { config.TPE.clusterSplitThreshold = std::stoi(v); }},
+        {"--tree-rebuild-drift", [&](const std::string& v) { config.TPE.treeRebuildDrift = std::stod(v); }},
+        {"--optimizer",
+         [&](const std::string& v) {
+             if (v == "gradient") {
+                 config.Opt.optimizer = OptimizerType::GradientDescent;
+             } else if (v == "lbfgs") {
+                 config.Opt.optimizer = OptimizerType::LBFGS;
+             } else if (v == "nesterov") {
+                 config.Opt.optimizer = OptimizerType::Nesterov;
+             } else {
+                 throw std::invalid_argument("'" + v + "' is not gradient, lbfgs or nesterov");
+             }
+         }},
+        {"--lbfgs-history", [&](const std::string& v) { config.Opt.lbfgsHistory = std::stoi(v); }},
+        {"--momentum", [&](const std::string& v) { config.Opt.momentum = std::stod(v); }},
+        {"--culling-radius",
+         [&](const std::string& v) {
+             config.Obstacles.distanceCulling = true;
+             config.Obstacles.interactionRadius = std::stod(v);
+         }},
+        {"--verbosity", [&](const std::string& v) { config.Debug.verbosity = std::stoi(v); }},
+    };
+
+    showHelp = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            showHelp = true;
+            return true;
+        }
+        if (arg == "--shared-obstacle") {
+            config.Obstacles.sharedSceneObstacle = true;
+            continue;
+        }
+        if (arg == "--pin-threads") {
+            config.TPE.pinThreads = true;
+            continue;
+        }
+        if (arg == "--self-energy") {
+            config.TPE.includeSelfEnergy = true;
+            continue;
+        }
+        if (arg == "--line-search") {
+            config.Opt.lineSearch = true;
+            continue;
+        }
+
+        auto it = valueOptions.find(arg);
+        if (it == valueOptions.end()) {
+            error = "Unknown option '" + arg + "'";
+            return false;
+        }
+        if (i + 1 >= argc) {
+            error = "Missing value for " + arg;
+            return false;
+        }
+        try {
+            it->second(argv[++i]);
+        } catch (const std::exception& e) {
+            error = "Invalid value for " + arg + ": " + e.what();
+            return false;
+        }
+    }
+
+    if (options.iterations < 0) {
+        error = "--iterations must not be negative";
+        return false;
+    }
+    if (config.Recording.queueFrames < 1) {
+        error = "--record-queue must be positive";
+        return false;
+    }
+    if (config.Checkpoint.autosaveSteps < 0) {
+        error = "--checkpoint-every must not be negative";
+        return false;
+    }
+    return true;
+}
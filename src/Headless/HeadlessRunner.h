@@ -0,0 +1,70 @@
+#ifndef HEADLESS_RUNNER_H
+#define HEADLESS_RUNNER_H
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../Config/Config.h"
+#include "../Data/SceneDefinition.h"
+
+class RepulsorEngine;
+class SceneManager;
+class VisualizationEngine;
+namespace Utils {
+class BackgroundWorker;
+}
+namespace IO {
+class TrajectoryRecorder;
+}
+
+struct HeadlessOptions {
+    ExampleId example = ExampleId::FCC_4;
+    std::vector<std::string> meshPaths;  // Non-empty: a scene of these OBJ/PLY files instead of the example
+    int iterations = 10;
+    std::string outputPath;  // Empty: results go to stdout
+    std::string tracePath;   // Non-empty: Chrome trace of the whole run, see Profiler.h
+    std::string restorePath;      // Non-empty: resume from this checkpoint instead of loading a scene
+    bool saveCheckpoint = false;  // Write config.Checkpoint.path at the end (and every autosaveSteps steps)
+    bool record = false;          // Record every step to config.Recording.path
+};
+
+// Runs physics steps on an example scene or imported meshes without a viewer and writes one CSV row per iteration:
+// iteration, total energy, step time and energy evaluation time (milliseconds). Row 0 is the initial state.
+class HeadlessRunner {
+  public:
+    HeadlessRunner(const ConfigType& config, const HeadlessOptions& options);
+    ~HeadlessRunner();
+
+    int Run();  // Returns a process exit code
+
+    // Fills config and options from the command line. Returns false with a message in `error` on bad input;
+    // `showHelp` is set when --help was given.
+    static bool ParseArguments(int argc, char** argv, ConfigType& config, HeadlessOptions& options,
+                               bool& showHelp, std::string& error);
+    static void PrintUsage(std::ostream& out, const char* programName);
+
+  private:
+    int RunIterations();
+    bool LoadScene();
+    bool MeasureEnergy(double& energy, double& elapsedMs);
+    void LogClusterTreeStats() const;  // Refits and rebuilds over the run
+    void SaveCheckpoint();  // Snapshots now and writes on m_checkpointWorker, after any previous save
+    bool StartRecording();
+    void RecordFrame();
+    bool StopRecording();  // False if frames were lost
+
+    ConfigType m_config;
+    HeadlessOptions m_options;
+
+    std::unique_ptr<RepulsorEngine> m_repulsorEngine;
+    std::unique_ptr<VisualizationEngine> m_vizEngine;
+    std::unique_ptr<SceneManager> m_sceneManager;
+    std::unique_ptr<Utils::BackgroundWorker> m_checkpointWorker;
+    std::atomic<bool> m_checkpointFailed{false};
+    std::unique_ptr<IO::TrajectoryRecorder> m_recorder;
+};
+
+#endif  // HEADLESS_RUNNER_H
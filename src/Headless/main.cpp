@@ -0,0 +1,37 @@
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "../Utils/Log.h"
+#include "HeadlessRunner.h"
+
+int main(int argc, char** argv) {
+    ConfigType config;
+    config.Debug.verbosity = 0;  // Keep batch output quiet unless asked
+    HeadlessOptions options;
+
+    bool showHelp = false;
+    std::string error;
+    if (!HeadlessRunner::ParseArguments(argc, argv, config, options, showHelp, error)) {
+        std::cerr << "Error: " << error << "\n\n";
+        HeadlessRunner::PrintUsage(std::cerr, argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (showHelp) {
+        HeadlessRunner::PrintUsage(std::cout, argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    Log::setVerbosity(config.Debug.verbosity);
+
+    try {
+        HeadlessRunner runner(config, options);
+        return runner.Run();
+    } catch (const std::exception& e) {
+        std::cerr << "FATAL ERROR: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (...) {
+        std::cerr << "FATAL ERROR: Unknown exception caught." << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,409 @@
+#include "Checkpoint.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "MappedFile.h"
+
+// --- File Layout ---
+// All values in the host byte order; strings are a u32 length followed by the characters.
+//
+//   char[8] magic "TPECKPT", u32 version, u32 byte order mark 0x01020304
+//   u64 completed steps
+//   u32 setting count, then per setting: string name, u8 type, value (bool: u8, int: i32, float: f32, double: f64)
+//   string scene name, f32[3] camera position, f32[3] camera look-at, i32 up direction, i32 front direction
+//   u32 topology count, then per topology: u64 vertex count, u64 simplex count, i32[simplex count * 3] simplices
+//   u32 object count, then per object: i32 id, string base name, u8 flags (1 interactive, 2 obstacle source,
+//       4 simulated), u32 obstacle id count, i32[] obstacle ids, u32 topology index, f32[16] column-major transform,
+//       f64[vertex count * 3] local vertices
+
+namespace IO {
+
+namespace {
+
+constexpr char kMagic[8] = {'T', 'P', 'E', 'C', 'K', 'P', 'T', '\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+
+enum class SettingType : std::uint8_t { Bool, Int, Float, Double };
+
+enum ObjectFlags : std::uint8_t { kInteractive = 1, kObstacleSource = 2, kSimulated = 4 };
+
+static_assert(sizeof(Int) == sizeof(std::int32_t), "Simplices are stored as 32-bit indices");
+static_assert(sizeof(std::array<Real, amb_dim>) == amb_dim * sizeof(double), "Vertices are stored as packed doubles");
+static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "Transforms are stored as 16 floats");
+
+// The settings a checkpoint carries over, by name. Left out on purpose: session settings (Checkpoint, Recording,
+// Debug), thread settings, which describe the machine rather than the run, and the active object, which belongs to
+// the scene.
+template <typename Config, typename Visitor>
+void visitSettings(Config& config, Visitor&& visit) {
+    visit("Interactivity.realTimeDiff", config.Interactivity.realTimeDiff);
+    visit("Interactivity.realTimeGrad", config.Interactivity.realTimeGrad);
+    visit("Interactivity.asyncRealTime", config.Interactivity.asyncRealTime);
+
+    visit("Display.useLogScale", config.Display.useLogScale);
+    visit("Display.differentialScale", config.Display.differentialScale);
+    visit("Display.targetMaxLogScale", config.Display.targetMaxLogScale);
+    visit("Display.showObstacles", config.Display.showObstacles);
+
+    visit("TPE.q", config.TPE.q);
+    visit("TPE.p", config.TPE.p);
+    visit("TPE.theta", config.TPE.theta);
+    visit("TPE.intersection_theta", config.TPE.intersection_theta);
+    visit("TPE.farFieldSeparation", config.TPE.farFieldSeparation);
+    visit("TPE.nearFieldSeparation", config.TPE.nearFieldSeparation);
+    visit("TPE.nearFieldIntersection", config.TPE.nearFieldIntersection);
+    visit("TPE.maxRefinement", config.TPE.maxRefinement);
+    visit("TPE.clusterSplitThreshold", config.TPE.clusterSplitThreshold);
+    visit("TPE.parallelPercolationDepth", config.TPE.parallelPercolationDepth);
+    visit("TPE.includeSelfEnergy", config.TPE.includeSelfEnergy);
+    visit("TPE.treeRebuildDrift", config.TPE.treeRebuildDrift);
+    visit("TPE.solverToleranceMin", config.TPE.solverToleranceMin);
+    visit("TPE.solverToleranceMax", config.TPE.solverToleranceMax);
+    visit("TPE.solverMaxIterations", config.TPE.solverMaxIterations);
+    visit("TPE.solverAdaptiveTolerance", config.TPE.solverAdaptiveTolerance);
+    visit("TPE.solverWarmStart", config.TPE.solverWarmStart);
+
+    visit("Obstacles.sharedSceneObstacle", config.Obstacles.sharedSceneObstacle);
+    visit("Obstacles.distanceCulling", config.Obstacles.distanceCulling);
+    visit("Obstacles.interactionRadius", config.Obstacles.interactionRadius);
+
+    visit("Opt.nLoopIterations", config.Opt.nLoopIterations);
+    visit("Opt.lineSearch", config.Opt.lineSearch);
+    visit("Opt.lineSearchMaxStep", config.Opt.lineSearchMaxStep);
+    visit("Opt.lineSearchGrowth", config.Opt.lineSearchGrowth);
+    visit("Opt.lineSearchShrink", config.Opt.lineSearchShrink);
+    visit("Opt.armijoConstant", config.Opt.armijoConstant);
+    visit("Opt.lineSearchMaxTrials", config.Opt.lineSearchMaxTrials);
+    visit("Opt.optimizer", config.Opt.optimizer);
+    visit("Opt.lbfgsHistory", config.Opt.lbfgsHistory);
+    visit("Opt.momentum", config.Opt.momentum);
+}
+
+template <typename T>
+constexpr SettingType settingTypeOf() {
+    if constexpr (std::is_same_v<T, bool>) {
+        return SettingType::Bool;
+    } else if constexpr (std::is_same_v<T, int> || std::is_enum_v<T>) {  // Enums are stored as their value
+        return SettingType::Int;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return SettingType::Float;
+    } else {
+        static_assert(std::is_same_v<T, double>, "Unsupported setting type");
+        return SettingType::Double;
+    }
+}
+
+// --- Writing ---
+
+class Writer {
+  public:
+    explicit Writer(std::ostream& out) : m_out(out) {
+    }
+
+    void Bytes(const void* data, std::size_t size) {
+        m_out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+    template <typename T>
+    void Value(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Bytes(&value, sizeof(T));
+    }
+    void String(const std::string& text) {
+        Value(static_cast<std::uint32_t>(text.size()));
+        Bytes(text.data(), text.size());
+    }
+    template <typename T>
+    void Setting(const char* name, const T& value) {
+        String(name);
+        Value(settingTypeOf<T>());
+        if constexpr (std::is_same_v<T, bool>) {
+            Value(static_cast<std::uint8_t>(value));
+        } else if constexpr (std::is_enum_v<T>) {
+            Value(static_cast<std::int32_t>(value));
+        } else {
+            Value(value);
+        }
+    }
+
+  private:
+    std::ostream& m_out;
+};
+
+void writeTo(std::ostream& out, const Checkpoint& checkpoint) {
+    Writer writer(out);
+    writer.Bytes(kMagic, sizeof(kMagic));
+    writer.Value(kVersion);
+    writer.Value(kByteOrderMark);
+    writer.Value(static_cast<std::uint64_t>(checkpoint.completedSteps));
+
+    std::uint32_t settingCount = 0;
+    visitSettings(checkpoint.config, [&](const char*, const auto&) { ++settingCount; });
+    writer.Value(settingCount);
+    visitSettings(checkpoint.config, [&](const char* name, const auto& value) { writer.Setting(name, value); });
+
+    const SceneDefinition& scene = checkpoint.scene;
+    writer.String(scene.sceneName);
+    writer.Value(scene.initialCameraPosition);
+    writer.Value(scene.initialCameraLookAt);
+    writer.Value(static_cast<std::int32_t>(scene.upDir));
+    writer.Value(static_cast<std::int32_t>(scene.frontDir));
+
+    // Topologies shared between objects (e.g. a lattice of identical spheres) are written once
+    std::map<const MeshTopology*, std::uint32_t> topologyIndex;
+    std::vector<const MeshTopology*> topologies;
+    for (const SceneObjectDefinition& objDef : scene.objectDefs) {
+        if (!objDef.meshData || !objDef.meshData->topology) {
+            throw std::runtime_error("Object " + std::to_string(objDef.id) + " has no mesh data");
+        }
+        const MeshTopology* topology = objDef.meshData->topology.get();
+        if (topologyIndex.emplace(topology, static_cast<std::uint32_t>(topologies.size())).second) {
+            topologies.push_back(topology);
+        }
+    }
+    writer.Value(static_cast<std::uint32_t>(topologies.size()));
+    for (const MeshTopology* topology : topologies) {
+        writer.Value(static_cast<std::uint64_t>(topology->vertexCount));
+        writer.Value(static_cast<std::uint64_t>(topology->simplices.size()));
+        writer.Bytes(topology->simplices.data(), topology->simplices.size() * sizeof(topology->simplices[0]));
+    }
+
+    writer.Value(static_cast<std::uint32_t>(scene.objectDefs.size()));
+    for (const SceneObjectDefinition& objDef : scene.objectDefs) {
+        const MeshData& mesh = *objDef.meshData;
+        if (mesh.vertices.size() != mesh.topology->vertexCount) {
+            throw std::runtime_error("Object " + std::to_string(objDef.id) + " does not match its topology");
+        }
+        writer.Value(static_cast<std::int32_t>(objDef.id));
+        writer.String(objDef.baseName);
+        std::uint8_t flags = (objDef.isInteractive ? kInteractive : 0) |
+                             (objDef.isObstacleSource ? kObstacleSource : 0) | (objDef.isSimulated ? kSimulated : 0);
+        writer.Value(flags);
+        writer.Value(static_cast<std::uint32_t>(objDef.obstacleDefinitionIds.size()));
+        for (int obstacleId : objDef.obstacleDefinitionIds) {
+            writer.Value(static_cast<std::int32_t>(obstacleId));
+        }
+        writer.Value(topologyIndex.at(mesh.topology.get()));
+        writer.Value(objDef.initialTransform);
+        writer.Bytes(mesh.vertices.data(), mesh.vertices.size() * sizeof(mesh.vertices[0]));
+    }
+}
+
+// --- Reading ---
+
+class Reader {
+  public:
+    explicit Reader(std::span<const char> data) : m_cursor(data.data()), m_end(data.data() + data.size()) {
+    }
+
+    void Bytes(void* out, std::size_t size) {
+        if (size > static_cast<std::size_t>(m_end - m_cursor)) {
+            throw std::runtime_error("Checkpoint is truncated");
+        }
+        if (size > 0) {
+            std::memcpy(out, m_cursor, size);
+        }
+        m_cursor += size;
+    }
+    template <typename T>
+    T Value() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        Bytes(&value, sizeof(T));
+        return value;
+    }
+    std::string String() {
+        std::string text(Count(1), '\0');
+        Bytes(text.data(), text.size());
+        return text;
+    }
+    // Element count of an array that follows, checked against the bytes left before anything is allocated for it
+    std::size_t Count(std::size_t elementSize, bool wide = false) {
+        std::uint64_t count = wide ? Value<std::uint64_t>() : Value<std::uint32_t>();
+        Expect(count, elementSize);
+        return static_cast<std::size_t>(count);
+    }
+    // Throws unless `count` elements of `elementSize` bytes are left, for counts stored apart from their array
+    void Expect(std::uint64_t count, std::size_t elementSize) const {
+        if (count > static_cast<std::uint64_t>(m_end - m_cursor) / elementSize) {
+            throw std::runtime_error("Checkpoint is truncated");
+        }
+    }
+    bool AtEnd() const {
+        return m_cursor == m_end;
+    }
+
+  private:
+    const char* m_cursor;
+    const char* m_end;
+};
+
+struct StoredSetting {
+    SettingType type = SettingType::Bool;
+    double value = 0.0;  // Exact for every stored type
+};
+
+void readSettings(Reader& reader, ConfigType& config) {
+    std::map<std::string, StoredSetting> stored;
+    std::size_t count = reader.Count(1);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string name = reader.String();
+        StoredSetting setting;
+        setting.type = reader.Value<SettingType>();
+        switch (setting.type) {
+        case SettingType::Bool:
+            setting.value = reader.Value<std::uint8_t>() != 0 ? 1.0 : 0.0;
+            break;
+        case SettingType::Int:
+            setting.value = reader.Value<std::int32_t>();
+            break;
+        case SettingType::Float:
+            setting.value = reader.Value<float>();
+            break;
+        case SettingType::Double:
+            setting.value = reader.Value<double>();
+            break;
+        default:
+            throw std::runtime_error("Checkpoint setting '" + name + "' has an unknown type");
+        }
+        stored[name] = setting;
+    }
+
+    // Unknown names are settings this build no longer has; a changed type means the setting changed meaning
+    visitSettings(config, [&](const char* name, auto& value) {
+        using T = std::remove_reference_t<decltype(value)>;
+        auto it = stored.find(name);
+        if (it != stored.end() && it->second.type == settingTypeOf<T>()) {
+            if constexpr (std::is_enum_v<T>) {
+                value = static_cast<T>(static_cast<std::int32_t>(it->second.value));
+            } else {
+                value = static_cast<T>(it->second.value);
+            }
+        }
+    });
+}
+
+std::vector<std::shared_ptr<const MeshTopology>> readTopologies(Reader& reader) {
+    std::vector<std::shared_ptr<const MeshTopology>> topologies(reader.Count(2 * sizeof(std::uint64_t)));
+    for (auto& topology : topologies) {
+        std::uint64_t vertexCount = reader.Value<std::uint64_t>();
+        reader.Expect(vertexCount, sizeof(std::array<Real, amb_dim>));  // Every topology's vertices follow later
+        using Simplex = std::array<Int, dom_dim + 1>;
+        std::vector<Simplex> simplices(reader.Count(sizeof(Simplex), true));
+        reader.Bytes(simplices.data(), simplices.size() * sizeof(simplices[0]));
+        for (const auto& simplex : simplices) {
+            for (Int index : simplex) {
+                if (index < 0 || static_cast<std::uint64_t>(index) >= vertexCount) {
+                    throw std::runtime_error("Checkpoint topology has an out-of-range vertex index");
+                }
+            }
+        }
+        topology = makeMeshTopology(std::move(simplices), static_cast<std::size_t>(vertexCount));
+    }
+    return topologies;
+}
+
+Checkpoint readFrom(std::span<const char> data, const ConfigType& baseConfig) {
+    Reader reader(data);
+    char magic[sizeof(kMagic)];
+    reader.Bytes(magic, sizeof(magic));
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a checkpoint file");
+    }
+    std::uint32_t version = reader.Value<std::uint32_t>();
+    if (version != kVersion) {
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(version));
+    }
+    if (reader.Value<std::uint32_t>() != kByteOrderMark) {
+        throw std::runtime_error("Checkpoint was written on a machine of the other byte order");
+    }
+
+    Checkpoint checkpoint;
+    checkpoint.completedSteps = reader.Value<std::uint64_t>();
+    checkpoint.config = baseConfig;
+    readSettings(reader, checkpoint.config);
+
+    SceneDefinition& scene = checkpoint.scene;
+    scene.sceneName = reader.String();
+    scene.initialCameraPosition = reader.Value<glm::vec3>();
+    scene.initialCameraLookAt = reader.Value<glm::vec3>();
+    scene.upDir = static_cast<CameraUpDir>(reader.Value<std::int32_t>());
+    scene.frontDir = static_cast<CameraFrontDir>(reader.Value<std::int32_t>());
+
+    std::vector<std::shared_ptr<const MeshTopology>> topologies = readTopologies(reader);
+
+    scene.objectDefs.resize(reader.Count(1));
+    for (SceneObjectDefinition& objDef : scene.objectDefs) {
+        objDef.id = reader.Value<std::int32_t>();
+        objDef.baseName = reader.String();
+        std::uint8_t flags = reader.Value<std::uint8_t>();
+        objDef.isInteractive = (flags & kInteractive) != 0;
+        objDef.isObstacleSource = (flags & kObstacleSource) != 0;
+        objDef.isSimulated = (flags & kSimulated) != 0;
+        objDef.obstacleDefinitionIds.resize(reader.Count(sizeof(std::int32_t)));
+        for (int& obstacleId : objDef.obstacleDefinitionIds) {
+            obstacleId = reader.Value<std::int32_t>();
+        }
+        std::uint32_t topologyIndex = reader.Value<std::uint32_t>();
+        if (topologyIndex >= topologies.size()) {
+            throw std::runtime_error("Checkpoint object refers to a missing topology");
+        }
+        objDef.initialTransform = reader.Value<glm::mat4>();
+
+        auto mesh = std::make_shared<MeshData>();
+        mesh->topology = topologies[topologyIndex];
+        reader.Expect(mesh->topology->vertexCount, sizeof(mesh->vertices[0]));
+        mesh->vertices.resize(mesh->topology->vertexCount);
+        reader.Bytes(mesh->vertices.data(), mesh->vertices.size() * sizeof(mesh->vertices[0]));
+        objDef.meshData = std::move(mesh);
+    }
+
+    if (!reader.AtEnd()) {
+        throw std::runtime_error("Checkpoint has trailing data");
+    }
+    return checkpoint;
+}
+
+}  // namespace
+
+void writeCheckpoint(const std::string& path, const Checkpoint& checkpoint) {
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open '" + temporaryPath + "' for writing");
+        }
+        writeTo(out, checkpoint);
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Cannot write '" + temporaryPath + "'");
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        throw std::runtime_error("Cannot replace '" + path + "': " + error.message());
+    }
+}
+
+Checkpoint readCheckpoint(const std::string& path, const ConfigType& baseConfig) {
+    MappedFile file(path);
+    try {
+        return readFrom(file.Data(), baseConfig);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Cannot restore '" + path + "': " + e.what());
+    }
+}
+
+}  // namespace IO
@@ -0,0 +1,33 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+
+#include "../Config/Config.h"
+#include "../Data/SceneDefinition.h"
+
+namespace IO {
+
+// Everything needed to resume a run: the settings, the number of completed physics steps, and the scene with every
+// object's current vertices and transform (see SceneManager::SnapshotScene).
+struct Checkpoint {
+    ConfigType config;
+    unsigned long long completedSteps = 0;
+    SceneDefinition scene;
+};
+
+// Compact binary file in the host byte order. Settings are stored by name, so checkpoints stay readable when
+// settings are added or removed; thread, Checkpoint, Recording and Debug settings belong to the session and are not
+// stored. A topology shared by several objects is stored once. The file is written under a temporary name and
+// renamed into place, so an interrupted save never replaces a good checkpoint with a truncated one. Throws
+// std::runtime_error on I/O errors.
+void writeCheckpoint(const std::string& path, const Checkpoint& checkpoint);
+
+// Memory-maps the file and copies each vertex and simplex block into the scene's mesh data in one piece. Settings
+// the file does not contain keep their values from baseConfig. Throws std::runtime_error on unreadable, corrupt or
+// foreign-endian files.
+Checkpoint readCheckpoint(const std::string& path, const ConfigType& baseConfig);
+
+}  // namespace IO
+
+#endif  // CHECKPOINT_H
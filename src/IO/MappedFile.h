@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace IO {
+
+// Read-only view of a whole file, memory-mapped so that parsing reads straight from the page cache instead of
+// copying the file into a buffer first. Throws std::runtime_error if the file cannot be opened or mapped.
+class MappedFile {
+  public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const char> Data() const {
+        return {m_data, m_size};
+    }
+    std::size_t Size() const {
+        return m_size;
+    }
+
+  private:
+    const char* m_data = nullptr;  // nullptr for empty files, which cannot be mapped
+    std::size_t m_size = 0;
+};
+
+}  // namespace IO
+
+#endif  // MAPPED_FILE_H
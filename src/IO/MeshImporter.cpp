@@ -0,0 +1,843 @@
+#include "MeshImporter.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+#include "../Utils/Log.h"
+#include "../Utils/ThreadPool.h"
+#include "MappedFile.h"
+
+namespace IO {
+
+namespace {
+
+using Vertex = std::array<Real, amb_dim>;
+using Simplex = std::array<Int, dom_dim + 1>;
+
+constexpr std::size_t kChunksPerThread = 4;          // Spreads chunks of uneven parse cost over the workers
+constexpr std::size_t kMinChunkBytes = 256 * 1024;   // OBJ text per chunk
+constexpr std::size_t kMinChunkRecords = 16 * 1024;  // PLY vertices or faces per chunk
+
+int resolveThreadCount(int threadCount) {
+    return threadCount > 0 ? threadCount : Utils::ThreadPool::HardwareThreadCount();
+}
+
+std::size_t chunkCount(std::size_t items, std::size_t minPerChunk, const Utils::ThreadPool& pool) {
+    std::size_t maxChunks = static_cast<std::size_t>(pool.GetThreadCount()) * kChunksPerThread;
+    return std::clamp<std::size_t>(items / minPerChunk, 1, maxChunks);
+}
+
+void checkVertexCount(std::size_t vertexCount) {
+    if (vertexCount > static_cast<std::size_t>(std::numeric_limits<Int>::max())) {
+        throw std::runtime_error("Too many vertices (" + std::to_string(vertexCount) + ")");
+    }
+}
+
+// --- Text Scanning ---
+// The mapped file is not null-terminated, so every scan is bounded by an end pointer.
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char* skipToken(const char* p, const char* end) {
+    while (p < end && !isBlank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char* findLineEnd(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+    return newline ? static_cast<const char*>(newline) : end;
+}
+
+// Optionally signed decimal integer. Values past the range of Int saturate, so they fail later range checks.
+bool parseInteger(const char*& p, const char* end, long long& out) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    const char* digits = p;
+    long long value = 0;
+    for (; p < end && isDigit(*p); ++p) {
+        if (value <= std::numeric_limits<Int>::max()) {
+            value = value * 10 + (*p - '0');
+        }
+    }
+    out = negative ? -value : value;
+    return p != digits;
+}
+
+// Decimal floating-point number ("-1.5", ".25", "3e-4"). Exact for up to 15 significant digits and exponents within
+// +-22, which covers what mesh exporters write; otherwise within an ulp or two. Locale-independent, unlike strtod.
+bool parseReal(const char*& p, const char* end, double& out) {
+    static constexpr double kPowersOfTen[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                              1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    constexpr std::uint64_t kExactMantissa = std::uint64_t{1} << 53;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    std::uint64_t mantissa = 0;
+    int significantDigits = 0;
+    long long exponent = 0;
+    bool anyDigits = false;
+    for (; p < end && isDigit(*p); ++p) {
+        anyDigits = true;
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+            significantDigits += mantissa != 0;
+        } else {
+            ++exponent;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && isDigit(*p); ++p) {
+            anyDigits = true;
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+                significantDigits += mantissa != 0;
+                --exponent;
+            }
+        }
+    }
+    if (!anyDigits) {
+        return false;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        long long written = 0;
+        if (!parseInteger(p, end, written)) {
+            return false;
+        }
+        exponent += written;
+    }
+
+    double value = static_cast<double>(mantissa);
+    if (mantissa != 0) {
+        if (mantissa <= kExactMantissa && exponent >= 0 && exponent <= 22) {
+            value *= kPowersOfTen[exponent];
+        } else if (mantissa <= kExactMantissa && exponent < 0 && exponent >= -22) {
+            value /= kPowersOfTen[-exponent];
+        } else {
+            value *= std::pow(10.0, static_cast<double>(std::clamp<long long>(exponent, -400, 400)));
+        }
+    }
+    out = negative ? -value : value;
+    return true;
+}
+
+// --- OBJ ---
+// Two passes over newline-aligned chunks: the first counts the vertices and triangles of each chunk, a prefix sum
+// turns the counts into output offsets, and the second parses each chunk straight into its slice of the arrays.
+
+struct ObjChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    std::size_t vertexCount = 0;
+    std::size_t triangleCount = 0;
+    std::size_t lineCount = 0;
+    std::size_t vertexOffset = 0;
+    std::size_t triangleOffset = 0;
+    std::size_t firstLine = 0;
+    const char* error = nullptr;  // First problem found, as a static message
+    std::size_t errorLine = 0;    // Within the chunk
+};
+
+bool isRecord(const char* p, const char* lineEnd, char tag) {
+    return lineEnd - p >= 2 && p[0] == tag && isBlank(p[1]);
+}
+
+void countObjChunk(ObjChunk& chunk) {
+    for (const char* line = chunk.begin; line < chunk.end; ++chunk.lineCount) {
+        const char* lineEnd = findLineEnd(line, chunk.end);
+        const char* p = skipBlanks(line, lineEnd);
+        if (isRecord(p, lineEnd, 'v')) {
+            ++chunk.vertexCount;
+        } else if (isRecord(p, lineEnd, 'f')) {
+            std::size_t corners = 0;
+            for (p = skipBlanks(p + 1, lineEnd); p < lineEnd; p = skipBlanks(skipToken(p, lineEnd), lineEnd)) {
+                ++corners;
+            }
+            if (corners < 3 && !chunk.error) {
+                chunk.error = "face with fewer than three vertices";
+                chunk.errorLine = chunk.lineCount;
+            }
+            chunk.triangleCount += corners >= 3 ? corners - 2 : 0;
+        }
+        line = lineEnd + 1;
+    }
+}
+
+void parseObjChunk(ObjChunk& chunk, std::size_t totalVertices, Vertex* vertices, Simplex* simplices) {
+    std::size_t vertexIndex = chunk.vertexOffset;
+    std::size_t triangleIndex = chunk.triangleOffset;
+    std::size_t lineIndex = 0;
+    auto fail = [&](const char* message) {
+        chunk.error = message;
+        chunk.errorLine = lineIndex;
+    };
+
+    for (const char* line = chunk.begin; line < chunk.end; ++lineIndex) {
+        const char* lineEnd = findLineEnd(line, chunk.end);
+        const char* p = skipBlanks(line, lineEnd);
+        if (isRecord(p, lineEnd, 'v')) {
+            Vertex& vertex = vertices[vertexIndex++];
+            ++p;
+            for (int k = 0; k < amb_dim; ++k) {
+                p = skipBlanks(p, lineEnd);
+                double value = 0.0;
+                if (!parseReal(p, lineEnd, value) || (p < lineEnd && !isBlank(*p))) {
+                    return fail("malformed vertex coordinates");
+                }
+                vertex[k] = value;
+            }
+        } else if (isRecord(p, lineEnd, 'f')) {
+            // Fan around the first corner: (0, 1, 2), (0, 2, 3), ...
+            Int first = 0;
+            Int previous = 0;
+            int corner = 0;
+            for (p = skipBlanks(p + 1, lineEnd); p < lineEnd; p = skipBlanks(skipToken(p, lineEnd), lineEnd)) {
+                long long index = 0;
+                const char* q = p;
+                if (!parseInteger(q, lineEnd, index) || (q < lineEnd && *q != '/' && !isBlank(*q))) {
+                    return fail("malformed face index");
+                }
+                // 1-based, or negative to count back from the last vertex read so far
+                long long resolved = index > 0 ? index - 1 : static_cast<long long>(vertexIndex) + index;
+                if (index == 0 || resolved < 0 || resolved >= static_cast<long long>(totalVertices)) {
+                    return fail("face index out of range");
+                }
+                Int current = static_cast<Int>(resolved);
+                if (corner == 0) {
+                    first = current;
+                } else if (corner >= 2) {
+                    simplices[triangleIndex++] = {first, previous, current};
+                }
+                previous = current;
+                ++corner;
+            }
+        }
+        line = lineEnd + 1;
+    }
+}
+
+void throwFirstObjError(const std::vector<ObjChunk>& chunks) {
+    for (const ObjChunk& chunk : chunks) {
+        if (chunk.error) {
+            throw std::runtime_error("Line " + std::to_string(chunk.firstLine + chunk.errorLine + 1) + ": " +
+                                     chunk.error);
+        }
+    }
+}
+
+std::shared_ptr<MeshData> parseObj(std::span<const char> text, Utils::ThreadPool& pool) {
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+
+    // Chunk boundaries sit just after a newline, so no line straddles two chunks
+    std::size_t count = chunkCount(text.size(), kMinChunkBytes, pool);
+    std::vector<ObjChunk> chunks(count);
+    const char* cursor = begin;
+    for (std::size_t c = 0; c < count; ++c) {
+        chunks[c].begin = cursor;
+        if (c + 1 == count) {
+            cursor = end;
+        } else {
+            const char* lineEnd = findLineEnd(std::max(cursor, begin + text.size() * (c + 1) / count), end);
+            cursor = lineEnd < end ? lineEnd + 1 : end;
+        }
+        chunks[c].end = cursor;
+    }
+
+    pool.ParallelFor(count, [&](std::size_t c, int) { countObjChunk(chunks[c]); });
+
+    std::size_t totalVertices = 0;
+    std::size_t totalTriangles = 0;
+    std::size_t totalLines = 0;
+    for (ObjChunk& chunk : chunks) {
+        chunk.vertexOffset = totalVertices;
+        chunk.triangleOffset = totalTriangles;
+        chunk.firstLine = totalLines;
+        totalVertices += chunk.vertexCount;
+        totalTriangles += chunk.triangleCount;
+        totalLines += chunk.lineCount;
+    }
+    throwFirstObjError(chunks);
+    checkVertexCount(totalVertices);
+
+    auto mesh = std::make_shared<MeshData>();
+    mesh->vertices.resize(totalVertices);
+    std::vector<Simplex> simplices(totalTriangles);
+    pool.ParallelFor(count, [&](std::size_t c, int) {
+        parseObjChunk(chunks[c], totalVertices, mesh->vertices.data(), simplices.data());
+    });
+    throwFirstObjError(chunks);
+
+    mesh->topology = makeMeshTopology(std::move(simplices), totalVertices);
+    return mesh;
+}
+
+// --- Binary PLY ---
+
+enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+struct PlyProperty {
+    std::string name;
+    PlyType type = PlyType::Float32;
+    bool isList = false;
+    PlyType countType = PlyType::UInt8;  // Lists only
+};
+
+struct PlyElement {
+    std::string name;
+    std::size_t count = 0;
+    std::vector<PlyProperty> properties;
+};
+
+std::size_t plyTypeSize(PlyType type) {
+    switch (type) {
+    case PlyType::Int8:
+    case PlyType::UInt8:
+        return 1;
+    case PlyType::Int16:
+    case PlyType::UInt16:
+        return 2;
+    case PlyType::Int32:
+    case PlyType::UInt32:
+    case PlyType::Float32:
+        return 4;
+    case PlyType::Float64:
+        return 8;
+    }
+    return 0;
+}
+
+PlyType parsePlyType(std::string_view name) {
+    struct Alias {
+        std::string_view name;
+        PlyType type;
+    };
+    static constexpr Alias kAliases[] = {
+        {"char", PlyType::Int8},     {"int8", PlyType::Int8},       {"uchar", PlyType::UInt8},
+        {"uint8", PlyType::UInt8},   {"short", PlyType::Int16},     {"int16", PlyType::Int16},
+        {"ushort", PlyType::UInt16}, {"uint16", PlyType::UInt16},   {"int", PlyType::Int32},
+        {"int32", PlyType::Int32},   {"uint", PlyType::UInt32},     {"uint32", PlyType::UInt32},
+        {"float", PlyType::Float32}, {"float32", PlyType::Float32}, {"double", PlyType::Float64},
+        {"float64", PlyType::Float64}};
+    for (const Alias& alias : kAliases) {
+        if (alias.name == name) {
+            return alias.type;
+        }
+    }
+    throw std::runtime_error("Unknown PLY property type '" + std::string(name) + "'");
+}
+
+template <typename T>
+T loadScalar(const char* p, bool swapBytes) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, p, sizeof(T));
+    if (swapBytes) {
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+double readPlyReal(const char* p, PlyType type, bool swapBytes) {
+    switch (type) {
+    case PlyType::Int8:
+        return loadScalar<std::int8_t>(p, swapBytes);
+    case PlyType::UInt8:
+        return loadScalar<std::uint8_t>(p, swapBytes);
+    case PlyType::Int16:
+        return loadScalar<std::int16_t>(p, swapBytes);
+    case PlyType::UInt16:
+        return loadScalar<std::uint16_t>(p, swapBytes);
+    case PlyType::Int32:
+        return loadScalar<std::int32_t>(p, swapBytes);
+    case PlyType::UInt32:
+        return loadScalar<std::uint32_t>(p, swapBytes);
+    case PlyType::Float32:
+        return loadScalar<float>(p, swapBytes);
+    case PlyType::Float64:
+        return loadScalar<double>(p, swapBytes);
+    }
+    return 0.0;
+}
+
+long long readPlyInteger(const char* p, PlyType type, bool swapBytes) {
+    switch (type) {
+    case PlyType::Int8:
+        return loadScalar<std::int8_t>(p, swapBytes);
+    case PlyType::UInt8:
+        return loadScalar<std::uint8_t>(p, swapBytes);
+    case PlyType::Int16:
+        return loadScalar<std::int16_t>(p, swapBytes);
+    case PlyType::UInt16:
+        return loadScalar<std::uint16_t>(p, swapBytes);
+    case PlyType::Int32:
+        return loadScalar<std::int32_t>(p, swapBytes);
+    case PlyType::UInt32:
+        return loadScalar<std::uint32_t>(p, swapBytes);
+    case PlyType::Float32:
+        return static_cast<long long>(loadScalar<float>(p, swapBytes));
+    case PlyType::Float64:
+        return static_cast<long long>(loadScalar<double>(p, swapBytes));
+    }
+    return -1;
+}
+
+bool isFaceIndexList(const PlyProperty& property) {
+    return property.isList && (property.name == "vertex_indices" || property.name == "vertex_index");
+}
+
+struct PlyHeader {
+    bool swapBytes = false;
+    std::vector<PlyElement> elements;
+    std::size_t dataOffset = 0;
+};
+
+PlyHeader parsePlyHeader(std::span<const char> contents) {
+    const char* begin = contents.data();
+    const char* end = begin + contents.size();
+    PlyHeader header;
+    bool sawFormat = false;
+
+    std::vector<std::string_view> tokens;
+    for (const char* line = begin; line < end;) {
+        const char* lineEnd = findLineEnd(line, end);
+        tokens.clear();
+        for (const char* p = skipBlanks(line, lineEnd); p < lineEnd;) {
+            const char* tokenEnd = skipToken(p, lineEnd);
+            tokens.emplace_back(p, static_cast<std::size_t>(tokenEnd - p));
+            p = skipBlanks(tokenEnd, lineEnd);
+        }
+        std::size_t next = static_cast<std::size_t>((lineEnd < end ? lineEnd + 1 : end) - begin);
+
+        if (line == begin) {
+            if (tokens.size() != 1 || tokens[0] != "ply") {
+                throw std::runtime_error("Not a PLY file");
+            }
+        } else if (tokens.empty() || tokens[0] == "comment" || tokens[0] == "obj_info") {
+            // Nothing to read
+        } else if (tokens[0] == "format") {
+            if (tokens.size() < 2) {
+                throw std::runtime_error("Malformed PLY format line");
+            }
+            if (tokens[1] == "ascii") {
+                throw std::runtime_error("ASCII PLY is not supported; convert the file to binary PLY or OBJ");
+            }
+            if (tokens[1] != "binary_little_endian" && tokens[1] != "binary_big_endian") {
+                throw std::runtime_error("Unknown PLY format '" + std::string(tokens[1]) + "'");
+            }
+            bool fileLittleEndian = tokens[1] == "binary_little_endian";
+            header.swapBytes = fileLittleEndian != (std::endian::native == std::endian::little);
+            sawFormat = true;
+        } else if (tokens[0] == "element") {
+            long long count = -1;
+            const char* p = tokens.size() == 3 ? tokens[2].data() : nullptr;
+            if (!p || !parseInteger(p, tokens[2].data() + tokens[2].size(), count) || count < 0) {
+                throw std::runtime_error("Malformed PLY element line");
+            }
+            header.elements.push_back({std::string(tokens[1]), static_cast<std::size_t>(count), {}});
+        } else if (tokens[0] == "property") {
+            if (header.elements.empty()) {
+                throw std::runtime_error("PLY property outside of an element");
+            }
+            PlyProperty property;
+            if (tokens.size() == 5 && tokens[1] == "list") {
+                property.isList = true;
+                property.countType = parsePlyType(tokens[2]);
+                property.type = parsePlyType(tokens[3]);
+                property.name = tokens[4];
+            } else if (tokens.size() == 3) {
+                property.type = parsePlyType(tokens[1]);
+                property.name = tokens[2];
+            } else {
+                throw std::runtime_error("Malformed PLY property line");
+            }
+            header.elements.back().properties.push_back(std::move(property));
+        } else if (tokens[0] == "end_header") {
+            if (!sawFormat) {
+                throw std::runtime_error("PLY header has no format line");
+            }
+            header.dataOffset = next;
+            return header;
+        } else {
+            throw std::runtime_error("Unknown PLY header line '" + std::string(tokens[0]) + "'");
+        }
+        line = begin + next;
+    }
+    throw std::runtime_error("PLY header has no end_header line");
+}
+
+// Bytes per record of an element without list properties
+std::size_t plyFixedStride(const PlyElement& element) {
+    std::size_t stride = 0;
+    for (const PlyProperty& property : element.properties) {
+        stride += plyTypeSize(property.type);
+    }
+    return stride;
+}
+
+// Bytes taken by one record of the element starting at p, or 0 if it runs past end.
+std::size_t plyRecordSize(const PlyElement& element, const char* p, const char* end, bool swapBytes) {
+    std::size_t size = 0;
+    for (const PlyProperty& property : element.properties) {
+        if (!property.isList) {
+            size += plyTypeSize(property.type);
+            continue;
+        }
+        std::size_t countSize = plyTypeSize(property.countType);
+        if (static_cast<std::size_t>(end - p) < size + countSize) {
+            return 0;
+        }
+        long long items = readPlyInteger(p + size, property.countType, swapBytes);
+        if (items < 0) {
+            return 0;
+        }
+        size += countSize + static_cast<std::size_t>(items) * plyTypeSize(property.type);
+    }
+    return static_cast<std::size_t>(end - p) < size ? 0 : size;
+}
+
+void parsePlyVertices(const PlyElement& element, const char* data, bool swapBytes, Utils::ThreadPool& pool,
+                      std::vector<Vertex>& vertices) {
+    static constexpr const char* kAxes[] = {"x", "y", "z"};
+    std::array<std::size_t, amb_dim> offsets{};
+    std::array<PlyType, amb_dim> types{};
+    std::array<bool, amb_dim> found{};
+    std::size_t stride = 0;
+    for (const PlyProperty& property : element.properties) {
+        for (int k = 0; k < amb_dim; ++k) {
+            if (property.name == kAxes[k]) {
+                offsets[k] = stride;
+                types[k] = property.type;
+                found[k] = true;
+            }
+        }
+        stride += plyTypeSize(property.type);
+    }
+    if (!found[0] || !found[1] || !found[2]) {
+        throw std::runtime_error("PLY vertex element lacks x, y or z");
+    }
+
+    vertices.resize(element.count);
+    std::size_t chunks = chunkCount(element.count, kMinChunkRecords, pool);
+    pool.ParallelFor(chunks, [&](std::size_t c, int) {
+        std::size_t first = element.count * c / chunks;
+        std::size_t last = element.count * (c + 1) / chunks;
+        for (std::size_t i = first; i < last; ++i) {
+            const char* record = data + i * stride;
+            for (int k = 0; k < amb_dim; ++k) {
+                vertices[i][k] = readPlyReal(record + offsets[k], types[k], swapBytes);
+            }
+        }
+    });
+}
+
+// Faces of exactly three corners in a face element whose only list is the index list have a fixed stride, so they
+// parse in parallel like vertices. Returns false, leaving `simplices` unspecified, if a face has another corner count.
+bool parsePlyTriangles(const PlyElement& element, const char* data, std::size_t available, bool swapBytes,
+                       std::size_t vertexCount, Utils::ThreadPool& pool, std::vector<Simplex>& simplices) {
+    const PlyProperty* list = nullptr;
+    std::size_t listOffset = 0;
+    std::size_t stride = 0;
+    for (const PlyProperty& property : element.properties) {
+        if (property.isList) {
+            if (list) {
+                return false;
+            }
+            list = &property;
+            listOffset = stride;
+            stride += plyTypeSize(property.countType) + 3 * plyTypeSize(property.type);
+        } else {
+            stride += plyTypeSize(property.type);
+        }
+    }
+    if (!list || element.count * stride > available) {
+        return false;
+    }
+
+    // Each record sits at i * stride only if every earlier face is a triangle, so the first record that is not
+    // still reads its true corner count and stops the fast path
+    std::size_t countSize = plyTypeSize(list->countType);
+    std::size_t indexSize = plyTypeSize(list->type);
+    std::atomic<bool> allTriangles{true};
+    std::atomic<bool> inRange{true};
+    simplices.resize(element.count);
+    std::size_t chunks = chunkCount(element.count, kMinChunkRecords, pool);
+    pool.ParallelFor(chunks, [&](std::size_t c, int) {
+        std::size_t first = element.count * c / chunks;
+        std::size_t last = element.count * (c + 1) / chunks;
+        for (std::size_t i = first; i < last; ++i) {
+            const char* record = data + i * stride + listOffset;
+            if (readPlyInteger(record, list->countType, swapBytes) != 3) {
+                allTriangles.store(false, std::memory_order_relaxed);
+                return;
+            }
+            for (int k = 0; k < 3; ++k) {
+                long long index = readPlyInteger(record + countSize + k * indexSize, list->type, swapBytes);
+                if (index < 0 || index >= static_cast<long long>(vertexCount)) {
+                    inRange.store(false, std::memory_order_relaxed);
+                    return;
+                }
+                simplices[i][k] = static_cast<Int>(index);
+            }
+        }
+    });
+    if (!allTriangles) {
+        return false;
+    }
+    if (!inRange) {
+        throw std::runtime_error("PLY face index out of range");
+    }
+    return true;
+}
+
+// Any corner count, walked record by record: one pass to size the output, one to fill it
+void parsePlyPolygons(const PlyElement& element, const char* data, const char* end, bool swapBytes,
+                      std::size_t vertexCount, std::vector<Simplex>& simplices) {
+    std::size_t triangleCount = 0;
+    const char* record = data;
+    for (std::size_t i = 0; i < element.count; ++i) {
+        std::size_t size = plyRecordSize(element, record, end, swapBytes);
+        if (size == 0) {
+            throw std::runtime_error("PLY face data is truncated");
+        }
+        std::size_t offset = 0;
+        for (const PlyProperty& property : element.properties) {
+            if (!property.isList) {
+                offset += plyTypeSize(property.type);
+                continue;
+            }
+            long long corners = readPlyInteger(record + offset, property.countType, swapBytes);
+            if (isFaceIndexList(property)) {
+                if (corners < 3) {
+                    throw std::runtime_error("PLY face with fewer than three vertices");
+                }
+                triangleCount += static_cast<std::size_t>(corners - 2);
+            }
+            offset += plyTypeSize(property.countType) + static_cast<std::size_t>(corners) * plyTypeSize(property.type);
+        }
+        record += size;
+    }
+
+    simplices.resize(triangleCount);
+    std::size_t triangle = 0;
+    record = data;
+    for (std::size_t i = 0; i < element.count; ++i) {
+        std::size_t offset = 0;
+        for (const PlyProperty& property : element.properties) {
+            if (!property.isList) {
+                offset += plyTypeSize(property.type);
+                continue;
+            }
+            long long corners = readPlyInteger(record + offset, property.countType, swapBytes);
+            std::size_t countSize = plyTypeSize(property.countType);
+            std::size_t indexSize = plyTypeSize(property.type);
+            if (isFaceIndexList(property)) {
+                std::array<Int, 3> fan{};
+                for (long long k = 0; k < corners; ++k) {
+                    long long index = readPlyInteger(record + offset + countSize + k * indexSize, property.type,
+                                                     swapBytes);
+                    if (index < 0 || index >= static_cast<long long>(vertexCount)) {
+                        throw std::runtime_error("PLY face index out of range");
+                    }
+                    fan[std::min<long long>(k, 2)] = static_cast<Int>(index);
+                    if (k >= 2) {
+                        simplices[triangle++] = {fan[0], fan[1], fan[2]};
+                        fan[1] = fan[2];
+                    }
+                }
+            }
+            offset += countSize + static_cast<std::size_t>(corners) * indexSize;
+        }
+        record += offset;
+    }
+}
+
+std::shared_ptr<MeshData> parsePly(std::span<const char> contents, Utils::ThreadPool& pool) {
+    PlyHeader header = parsePlyHeader(contents);
+    const char* cursor = contents.data() + header.dataOffset;
+    const char* end = contents.data() + contents.size();
+
+    auto mesh = std::make_shared<MeshData>();
+    std::vector<Simplex> simplices;
+    bool haveVertices = false;
+    bool haveFaces = false;
+    for (const PlyElement& element : header.elements) {
+        if (haveVertices && haveFaces) {
+            break;  // Trailing elements are not needed
+        }
+        bool fixedSize = std::none_of(element.properties.begin(), element.properties.end(),
+                                      [](const PlyProperty& property) { return property.isList; });
+        std::size_t available = static_cast<std::size_t>(end - cursor);
+
+        if (element.name == "vertex") {
+            if (!fixedSize) {
+                throw std::runtime_error("PLY vertex element with list properties is not supported");
+            }
+            checkVertexCount(element.count);
+            std::size_t stride = plyFixedStride(element);
+            if (element.count * stride > available) {
+                throw std::runtime_error("PLY vertex data is truncated");
+            }
+            parsePlyVertices(element, cursor, header.swapBytes, pool, mesh->vertices);
+            cursor += element.count * stride;
+            haveVertices = true;
+        } else if (element.name == "face") {
+            if (!haveVertices) {
+                throw std::runtime_error("PLY face element precedes the vertex element");
+            }
+            auto indexList = std::find_if(element.properties.begin(), element.properties.end(), isFaceIndexList);
+            if (indexList == element.properties.end()) {
+                throw std::runtime_error("PLY face element has no vertex_indices list");
+            }
+            std::size_t vertexCount = mesh->vertices.size();
+            if (!parsePlyTriangles(element, cursor, available, header.swapBytes, vertexCount, pool, simplices)) {
+                parsePlyPolygons(element, cursor, end, header.swapBytes, vertexCount, simplices);
+            }
+            haveFaces = true;
+        } else {
+            // Skip elements we do not read (edges, materials, ...)
+            if (fixedSize) {
+                std::size_t stride = plyFixedStride(element);
+                if (element.count * stride > available) {
+                    throw std::runtime_error("PLY element '" + element.name + "' is truncated");
+                }
+                cursor += element.count * stride;
+                continue;
+            }
+            for (std::size_t i = 0; i < element.count; ++i) {
+                std::size_t size = plyRecordSize(element, cursor, end, header.swapBytes);
+                if (size == 0) {
+                    throw std::runtime_error("PLY element '" + element.name + "' is truncated");
+                }
+                cursor += size;
+            }
+        }
+    }
+    if (!haveVertices || !haveFaces) {
+        throw std::runtime_error("PLY file needs both a vertex and a face element");
+    }
+
+    std::size_t vertexCount = mesh->vertices.size();
+    mesh->topology = makeMeshTopology(std::move(simplices), vertexCount);
+    return mesh;
+}
+
+std::string lowercaseExtension(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension.empty() ? extension : extension.substr(1);
+}
+
+}  // namespace
+
+std::shared_ptr<MeshData> parseMesh(std::span<const char> contents, const std::string& format, int threadCount) {
+    Utils::ThreadPool pool(resolveThreadCount(threadCount));
+    std::shared_ptr<MeshData> mesh;
+    if (format == "obj") {
+        mesh = parseObj(contents, pool);
+    } else if (format == "ply") {
+        mesh = parsePly(contents, pool);
+    } else {
+        throw std::runtime_error("Unsupported mesh format '" + format + "' (expected obj or ply)");
+    }
+    if (mesh->simplices().empty()) {
+        throw std::runtime_error("Mesh has no faces");
+    }
+    return mesh;
+}
+
+std::shared_ptr<MeshData> importMesh(const std::string& path, MeshImportStats* stats, int threadCount) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file(path);
+    std::shared_ptr<MeshData> mesh;
+    try {
+        mesh = parseMesh(file.Data(), lowercaseExtension(path), threadCount);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Cannot import '" + path + "': " + e.what());
+    }
+
+    MeshImportStats result;
+    result.bytes = file.Size();
+    result.vertexCount = mesh->vertices.size();
+    result.triangleCount = mesh->simplices().size();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TPE_LOG_INFO("Imported ", path, ": ", result.vertexCount, " vertices, ", result.triangleCount, " triangles in ",
+                 result.seconds * 1000.0, " ms (", result.MegabytesPerSecond(), " MB/s)");
+    if (stats) {
+        *stats = result;
+    }
+    return mesh;
+}
+
+SceneDefinition createMeshScene(const std::vector<std::string>& paths, int threadCount) {
+    if (paths.empty()) {
+        throw std::runtime_error("No mesh files given.");
+    }
+
+    SceneDefinition scene;
+    scene.sceneName = paths.size() == 1 ? std::filesystem::path(paths[0]).filename().string() : "Imported Meshes";
+
+    glm::vec3 lower(std::numeric_limits<float>::max());
+    glm::vec3 upper(std::numeric_limits<float>::lowest());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        std::shared_ptr<MeshData> mesh = importMesh(paths[i], nullptr, threadCount);
+        for (const Vertex& vertex : mesh->vertices) {
+            glm::vec3 point(vertex[0], vertex[1], vertex[2]);
+            lower = glm::min(lower, point);
+            upper = glm::max(upper, point);
+        }
+
+        scene.objectDefs.emplace_back(static_cast<int>(i),                              // id
+                                      std::filesystem::path(paths[i]).stem().string(),  // baseName
+                                      std::move(mesh),                                  // meshData
+                                      true,                                             // isInteractive
+                                      true,                                             // isObstacleSource
+                                      true,                                             // isSimulated
+                                      std::vector<int>{-1}                              // obstacleDefinitionIds
+        );
+    }
+
+    // --- Set camera position and look at ---
+    glm::vec3 center = 0.5f * (lower + upper);
+    float radius = std::max(0.5f * glm::length(upper - lower), 1e-3f);
+    scene.initialCameraPosition = center + glm::vec3(0.f, 0.f, 2.5f * radius);
+    scene.initialCameraLookAt = center;
+
+    return scene;
+}
+
+}  // namespace IO
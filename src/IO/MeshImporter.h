@@ -0,0 +1,44 @@
+#ifndef MESH_IMPORTER_H
+#define MESH_IMPORTER_H
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../Data/MeshData.h"
+#include "../Data/SceneDefinition.h"
+
+namespace IO {
+
+struct MeshImportStats {
+    std::size_t bytes = 0;
+    std::size_t vertexCount = 0;
+    std::size_t triangleCount = 0;
+    double seconds = 0.0;  // Mapping and parsing
+
+    double MegabytesPerSecond() const {
+        return seconds > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+};
+
+// --- Mesh Import ---
+// Reads a triangle mesh from an OBJ or a binary PLY file, chosen by extension. The file is memory-mapped and parsed
+// in parallel chunks that write straight into the MeshData arrays; polygons are split into triangle fans.
+// OBJ: `v` and `f` records (texture and normal indices are ignored, negative indices are supported).
+// PLY: binary_little_endian and binary_big_endian with a `vertex` element holding x, y, z of any scalar type and a
+// `face` element with one index list. ASCII PLY is not supported.
+// threadCount 0 uses every hardware thread. Throws std::runtime_error on unreadable or malformed files.
+std::shared_ptr<MeshData> importMesh(const std::string& path, MeshImportStats* stats = nullptr, int threadCount = 0);
+
+// Same, for file contents already in memory. `format` is "obj" or "ply".
+std::shared_ptr<MeshData> parseMesh(std::span<const char> contents, const std::string& format, int threadCount = 0);
+
+// A scene with one simulated, interactive object per file, each repelling all others. Meshes keep their file
+// coordinates; the camera frames their combined bounding box.
+SceneDefinition createMeshScene(const std::vector<std::string>& paths, int threadCount = 0);
+
+}  // namespace IO
+
+#endif  // MESH_IMPORTER_H
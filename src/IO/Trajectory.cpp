@@ -0,0 +1,533 @@
+#include "Trajectory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../Utils/Log.h"
+
+// --- File Layout ---
+// All values in the host byte order.
+//
+//   char[8] magic "TPETRAJ", u32 version, u32 byte order mark 0x01020304, u8 flags (1: fields), f64 quantum
+//   u32 object count, then per object: i32 id, u64 vertex count
+//   Frames, each a u32 record size followed by the record:
+//       u8 kind (0: keyframe, 1: delta), u64 step, f32[16] column-major transform per object,
+//       keyframe: f64[vertex count * 3] local vertices of all objects,
+//       delta: per coordinate a zigzag LEB128 varint, the change since the previous frame in multiples of quantum,
+//       with fields: f32[vertex count * 3] differential, then f32[vertex count * 3] gradient
+//   Index, once the recording is closed: per frame u64 record offset, u64 keyframe number, u64 step
+//   u64 frame count, u64 index offset, char[8] magic "TPEINDX"
+
+namespace IO {
+
+namespace {
+
+constexpr char kMagic[8] = {'T', 'P', 'E', 'T', 'R', 'A', 'J', '\0'};
+constexpr char kIndexMagic[8] = {'T', 'P', 'E', 'I', 'N', 'D', 'X', '\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+constexpr std::uint8_t kFieldsFlag = 1;
+constexpr std::uint64_t kTrailerSize = 2 * sizeof(std::uint64_t) + sizeof(kIndexMagic);
+constexpr std::uint64_t kIndexEntrySize = 3 * sizeof(std::uint64_t);
+// Record start: kind and step
+constexpr std::uint32_t kRecordPrefixSize = sizeof(std::uint8_t) + sizeof(std::uint64_t);
+// Largest delta stored as an integer, in quanta; exact in a double, so rounding is the only error
+constexpr double kMaxDelta = 4503599627370496.0;  // 2^52
+
+enum class FrameKind : std::uint8_t { Keyframe = 0, Delta = 1 };
+
+static_assert(sizeof(std::array<Real, amb_dim>) == amb_dim * sizeof(double), "Vertices are stored as packed doubles");
+static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "Transforms are stored as 16 floats");
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "Field vectors are stored as 3 floats");
+
+// Writer and reader reconstruct positions with this one expression, so both arrive at bit-identical values.
+inline Real applyDelta(Real previous, std::int64_t delta, double quantum) {
+    return previous + static_cast<Real>(static_cast<double>(delta) * quantum);
+}
+
+template <typename T>
+void appendValue(std::vector<std::uint8_t>& out, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void appendBytes(std::vector<std::uint8_t>& out, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+void appendVarint(std::vector<std::uint8_t>& out, std::int64_t value) {
+    // Zigzag: small magnitudes of either sign become small unsigned numbers
+    std::uint64_t bits = (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    while (bits >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(bits | 0x80));
+        bits >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(bits));
+}
+
+// Bounds-checked sequential reads from the mapped file
+class Cursor {
+  public:
+    Cursor(std::span<const char> data, std::uint64_t begin, std::uint64_t end)
+        : m_cursor(data.data() + begin), m_end(data.data() + end) {
+    }
+
+    void Bytes(void* out, std::size_t size) {
+        if (size > static_cast<std::size_t>(m_end - m_cursor)) {
+            throw std::runtime_error("Trajectory is truncated");
+        }
+        if (size > 0) {
+            std::memcpy(out, m_cursor, size);
+        }
+        m_cursor += size;
+    }
+    template <typename T>
+    T Value() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        Bytes(&value, sizeof(T));
+        return value;
+    }
+    std::int64_t Varint() {
+        std::uint64_t bits = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_cursor == m_end) {
+                throw std::runtime_error("Trajectory is truncated");
+            }
+            const auto byte = static_cast<std::uint8_t>(*m_cursor++);
+            bits |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return static_cast<std::int64_t>((bits >> 1) ^ (~(bits & 1) + 1));
+            }
+        }
+        throw std::runtime_error("Trajectory has a malformed delta");
+    }
+    std::size_t Remaining() const {
+        return static_cast<std::size_t>(m_end - m_cursor);
+    }
+
+  private:
+    const char* m_cursor;
+    const char* m_end;
+};
+
+}  // namespace
+
+// --- Recording ---
+
+TrajectoryRecorder::TrajectoryRecorder(const std::string& path, std::vector<TrajectoryObject> objects,
+                                       const TrajectoryOptions& options)
+    : m_path(path), m_objects(std::move(objects)), m_options(options),
+      m_queue(static_cast<std::size_t>(std::max(options.queueFrames, 1))) {
+    if (!(m_options.quantum > 0.0)) {
+        throw std::runtime_error("Trajectory quantum must be positive");
+    }
+    m_options.keyframeInterval = std::max(m_options.keyframeInterval, 1);
+    for (const TrajectoryObject& object : m_objects) {
+        m_vertexCount += object.vertexCount;
+    }
+
+    m_out.open(m_path, std::ios::binary | std::ios::trunc);
+    if (!m_out) {
+        throw std::runtime_error("Cannot open '" + m_path + "' for writing");
+    }
+    m_record.clear();
+    appendBytes(m_record, kMagic, sizeof(kMagic));
+    appendValue(m_record, kVersion);
+    appendValue(m_record, kByteOrderMark);
+    appendValue(m_record, static_cast<std::uint8_t>(m_options.recordFields ? kFieldsFlag : 0));
+    appendValue(m_record, m_options.quantum);
+    appendValue(m_record, static_cast<std::uint32_t>(m_objects.size()));
+    for (const TrajectoryObject& object : m_objects) {
+        appendValue(m_record, static_cast<std::int32_t>(object.id));
+        appendValue(m_record, static_cast<std::uint64_t>(object.vertexCount));
+    }
+    Write(m_record.data(), m_record.size());
+
+    m_writer = std::thread([this] { WriterLoop(); });
+}
+
+TrajectoryRecorder::~TrajectoryRecorder() {
+    Close();
+}
+
+bool TrajectoryRecorder::Record(std::uint64_t step, std::span<const RecordedObject> objects) {
+    if (objects.size() != m_objects.size()) {
+        throw std::invalid_argument("Trajectory records " + std::to_string(m_objects.size()) + " objects, got " +
+                                    std::to_string(objects.size()));
+    }
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        if (objects[i].vertices.size() != m_objects[i].vertexCount) {
+            throw std::invalid_argument("Vertex count of object " + std::to_string(m_objects[i].id) +
+                                        " changed during recording");
+        }
+    }
+
+    Slot* slot = m_closed || HasFailed() ? nullptr : m_queue.BeginPush();
+    if (!slot) {
+        m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // The slot's buffers keep their size from earlier frames, so resizing them does not allocate
+    TrajectoryFrame& frame = slot->frame;
+    frame.step = step;
+    frame.transforms.resize(objects.size());
+    frame.vertices.resize(m_vertexCount);
+    if (m_options.recordFields) {
+        frame.differential.resize(m_vertexCount);
+        frame.gradient.resize(m_vertexCount);
+    }
+    auto copyField = [](const std::vector<glm::vec3>* source, glm::vec3* target, std::size_t count) {
+        if (source && source->size() == count) {
+            std::copy(source->begin(), source->end(), target);
+        } else {
+            std::fill(target, target + count, glm::vec3(0.0f));
+        }
+    };
+
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        const RecordedObject& object = objects[i];
+        const std::size_t count = object.vertices.size();
+        frame.transforms[i] = object.transform;
+        std::copy(object.vertices.begin(), object.vertices.end(), frame.vertices.begin() + offset);
+        if (m_options.recordFields) {
+            copyField(object.differential, frame.differential.data() + offset, count);
+            copyField(object.gradient, frame.gradient.data() + offset, count);
+        }
+        offset += count;
+    }
+
+    slot->last = false;
+    m_queue.CommitPush();
+    m_recordedFrames.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void TrajectoryRecorder::Close() {
+    if (m_closed) {
+        return;
+    }
+    m_closed = true;
+
+    // Closing is the one place that waits for the writer: the end marker needs a free slot
+    Slot* slot = m_queue.BeginPush();
+    while (!slot) {
+        std::this_thread::yield();
+        slot = m_queue.BeginPush();
+    }
+    slot->last = true;
+    m_queue.CommitPush();
+    m_writer.join();
+    m_out.close();
+}
+
+void TrajectoryRecorder::WriterLoop() {
+    for (;;) {
+        m_queue.WaitForData();
+        Slot* slot = m_queue.Front();
+        if (slot->last) {
+            m_queue.Pop();
+            break;
+        }
+        if (!HasFailed()) {
+            try {
+                EncodeFrame(slot->frame);
+            } catch (const std::exception& e) {
+                m_failed.store(true, std::memory_order_relaxed);
+                Log::error("Trajectory recording stopped: " + std::string(e.what()));
+            }
+        }
+        m_queue.Pop();
+    }
+
+    if (HasFailed()) {
+        return;
+    }
+    try {
+        const std::uint64_t indexOffset = m_offset;
+        m_record.clear();
+        for (const IndexEntry& entry : m_index) {
+            appendValue(m_record, entry.offset);
+            appendValue(m_record, entry.keyframe);
+            appendValue(m_record, entry.step);
+        }
+        appendValue(m_record, static_cast<std::uint64_t>(m_index.size()));
+        appendValue(m_record, indexOffset);
+        appendBytes(m_record, kIndexMagic, sizeof(kIndexMagic));
+        Write(m_record.data(), m_record.size());
+        m_out.flush();
+        if (!m_out) {
+            throw std::runtime_error("Cannot write '" + m_path + "'");
+        }
+    } catch (const std::exception& e) {
+        m_failed.store(true, std::memory_order_relaxed);
+        Log::error("Trajectory index not written: " + std::string(e.what()));
+    }
+}
+
+void TrajectoryRecorder::EncodeFrame(const TrajectoryFrame& frame) {
+    const std::uint64_t frameNumber = m_index.size();
+    m_record.clear();
+    appendValue(m_record, FrameKind::Keyframe);  // Patched below for delta frames
+    appendValue(m_record, frame.step);
+    appendBytes(m_record, frame.transforms.data(), frame.transforms.size() * sizeof(glm::mat4));
+
+    const std::size_t verticesStart = m_record.size();
+    bool keyframe = frameNumber % static_cast<std::uint64_t>(m_options.keyframeInterval) == 0;
+    if (!keyframe && !EncodeDeltas(frame)) {
+        m_record.resize(verticesStart);
+        keyframe = true;
+    }
+    if (keyframe) {
+        appendBytes(m_record, frame.vertices.data(), frame.vertices.size() * sizeof(frame.vertices[0]));
+        m_reconstructed = frame.vertices;
+    } else {
+        m_record[0] = static_cast<std::uint8_t>(FrameKind::Delta);
+    }
+
+    if (m_options.recordFields) {
+        appendBytes(m_record, frame.differential.data(), frame.differential.size() * sizeof(glm::vec3));
+        appendBytes(m_record, frame.gradient.data(), frame.gradient.size() * sizeof(glm::vec3));
+    }
+
+    IndexEntry entry;
+    entry.offset = m_offset;
+    entry.keyframe = keyframe ? frameNumber : m_index.back().keyframe;
+    entry.step = frame.step;
+
+    const auto recordSize = static_cast<std::uint32_t>(m_record.size());
+    if (recordSize != m_record.size()) {
+        throw std::runtime_error("Frame is too large for the trajectory format");
+    }
+    Write(&recordSize, sizeof(recordSize));
+    Write(m_record.data(), m_record.size());
+    m_index.push_back(entry);
+}
+
+bool TrajectoryRecorder::EncodeDeltas(const TrajectoryFrame& frame) {
+    const double quantum = m_options.quantum;
+    const std::size_t vertexCount = frame.vertices.size();
+    for (std::size_t v = 0; v < vertexCount; ++v) {
+        for (int k = 0; k < amb_dim; ++k) {
+            Real& previous = m_reconstructed[v][k];
+            const double scaled = (frame.vertices[v][k] - previous) / quantum;
+            if (!(std::abs(scaled) <= kMaxDelta)) {  // Also catches NaN
+                return false;  // m_reconstructed is replaced by the keyframe written instead
+            }
+            const auto delta = static_cast<std::int64_t>(std::llround(scaled));
+            appendVarint(m_record, delta);
+            previous = applyDelta(previous, delta, quantum);
+        }
+    }
+    return true;
+}
+
+void TrajectoryRecorder::Write(const void* data, std::size_t size) {
+    m_out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!m_out) {
+        throw std::runtime_error("Cannot write '" + m_path + "'");
+    }
+    m_offset += size;
+    m_bytesWritten.fetch_add(size, std::memory_order_relaxed);
+}
+
+// --- Playback ---
+
+TrajectoryReader::TrajectoryReader(const std::string& path) : m_file(path) {
+    try {
+        ReadHeader();
+        if (!ReadIndex()) {
+            RebuildIndex();
+        }
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Cannot play back '" + path + "': " + e.what());
+    }
+    if (m_indexRebuilt) {
+        Log::warning("Trajectory '" + path + "' was not closed properly; recovered " +
+                     std::to_string(m_index.size()) + " frame(s)");
+    }
+
+    m_frame.transforms.resize(m_objects.size());
+    m_frame.vertices.resize(m_vertexCount);
+    if (m_hasFields) {
+        m_frame.differential.resize(m_vertexCount);
+        m_frame.gradient.resize(m_vertexCount);
+    }
+}
+
+std::uint64_t TrajectoryReader::GetStep(std::size_t frame) const {
+    return m_index.at(frame).step;
+}
+
+void TrajectoryReader::ReadHeader() {
+    std::span<const char> data = m_file.Data();
+    Cursor cursor(data, 0, data.size());
+    char magic[sizeof(kMagic)];
+    cursor.Bytes(magic, sizeof(magic));
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a trajectory file");
+    }
+    std::uint32_t version = cursor.Value<std::uint32_t>();
+    if (version != kVersion) {
+        throw std::runtime_error("Unsupported trajectory version " + std::to_string(version));
+    }
+    if (cursor.Value<std::uint32_t>() != kByteOrderMark) {
+        throw std::runtime_error("Trajectory was written on a machine of the other byte order");
+    }
+    m_hasFields = (cursor.Value<std::uint8_t>() & kFieldsFlag) != 0;
+    m_quantum = cursor.Value<double>();
+    if (!(m_quantum > 0.0)) {
+        throw std::runtime_error("Trajectory has an invalid quantum");
+    }
+
+    std::uint32_t objectCount = cursor.Value<std::uint32_t>();
+    if (objectCount > cursor.Remaining() / (sizeof(std::int32_t) + sizeof(std::uint64_t))) {
+        throw std::runtime_error("Trajectory is truncated");
+    }
+    m_objects.resize(objectCount);
+    std::uint64_t vertexCount = 0;
+    for (TrajectoryObject& object : m_objects) {
+        object.id = cursor.Value<std::int32_t>();
+        std::uint64_t count = cursor.Value<std::uint64_t>();
+        vertexCount += count;
+        // Every vertex takes at least a byte per coordinate in each frame; this also bounds the allocations below
+        if (count > data.size() || vertexCount > data.size()) {
+            throw std::runtime_error("Trajectory header is corrupt");
+        }
+        object.vertexCount = static_cast<std::size_t>(count);
+    }
+    m_vertexCount = static_cast<std::size_t>(vertexCount);
+    m_firstRecord = data.size() - cursor.Remaining();
+}
+
+bool TrajectoryReader::ReadIndex() {
+    std::span<const char> data = m_file.Data();
+    const std::uint64_t size = data.size();
+    if (size < m_firstRecord + kTrailerSize) {
+        return false;
+    }
+    Cursor trailer(data, size - kTrailerSize, size);
+    const auto frameCount = trailer.Value<std::uint64_t>();
+    const auto indexOffset = trailer.Value<std::uint64_t>();
+    char magic[sizeof(kIndexMagic)];
+    trailer.Bytes(magic, sizeof(magic));
+    if (std::memcmp(magic, kIndexMagic, sizeof(kIndexMagic)) != 0 || indexOffset < m_firstRecord ||
+        indexOffset > size - kTrailerSize || frameCount != (size - kTrailerSize - indexOffset) / kIndexEntrySize ||
+        (size - kTrailerSize - indexOffset) % kIndexEntrySize != 0) {
+        return false;
+    }
+
+    Cursor cursor(data, indexOffset, size - kTrailerSize);
+    std::vector<IndexEntry> index(static_cast<std::size_t>(frameCount));
+    std::uint64_t nextOffset = m_firstRecord;
+    for (std::size_t i = 0; i < index.size(); ++i) {
+        IndexEntry& entry = index[i];
+        entry.offset = cursor.Value<std::uint64_t>();
+        entry.keyframe = cursor.Value<std::uint64_t>();
+        entry.step = cursor.Value<std::uint64_t>();
+        if (entry.offset < nextOffset || entry.offset >= indexOffset || entry.keyframe > i) {
+            return false;  // Rebuilt from the records instead
+        }
+        nextOffset = entry.offset + sizeof(std::uint32_t);
+    }
+    m_index = std::move(index);
+    return true;
+}
+
+void TrajectoryReader::RebuildIndex() {
+    std::span<const char> data = m_file.Data();
+    const std::uint64_t size = data.size();
+    std::uint64_t offset = m_firstRecord;
+    std::uint64_t keyframe = 0;
+    bool haveKeyframe = false;
+    m_index.clear();
+    while (size - offset >= sizeof(std::uint32_t) + kRecordPrefixSize) {
+        Cursor cursor(data, offset, size);
+        const auto recordSize = cursor.Value<std::uint32_t>();
+        if (recordSize < kRecordPrefixSize || recordSize > cursor.Remaining()) {
+            break;  // Truncated by the interruption
+        }
+        const auto kind = cursor.Value<FrameKind>();
+        if (kind == FrameKind::Keyframe) {
+            keyframe = m_index.size();
+            haveKeyframe = true;
+        } else if (kind != FrameKind::Delta || !haveKeyframe) {
+            break;
+        }
+        IndexEntry entry;
+        entry.offset = offset;
+        entry.keyframe = keyframe;
+        entry.step = cursor.Value<std::uint64_t>();
+        m_index.push_back(entry);
+        offset += sizeof(std::uint32_t) + recordSize;
+    }
+    m_indexRebuilt = true;
+}
+
+const TrajectoryFrame& TrajectoryReader::Seek(std::size_t frame) {
+    if (frame >= m_index.size()) {
+        throw std::out_of_range("Trajectory frame " + std::to_string(frame) + " out of range");
+    }
+    if (frame == m_decoded) {
+        return m_frame;
+    }
+
+    // Continue from the frame already decoded when it lies between the keyframe and the target
+    std::size_t first = static_cast<std::size_t>(m_index[frame].keyframe);
+    if (m_decoded != static_cast<std::size_t>(-1) && m_decoded >= first && m_decoded < frame) {
+        first = m_decoded + 1;
+    }
+    try {
+        for (std::size_t f = first; f <= frame; ++f) {
+            DecodeFrame(f);
+        }
+    } catch (...) {
+        m_decoded = static_cast<std::size_t>(-1);
+        throw;
+    }
+    return m_frame;
+}
+
+void TrajectoryReader::DecodeFrame(std::size_t frame) {
+    std::span<const char> data = m_file.Data();
+    const std::uint64_t offset = m_index[frame].offset;
+    Cursor sizeCursor(data, offset, data.size());
+    const auto recordSize = sizeCursor.Value<std::uint32_t>();
+    if (recordSize > sizeCursor.Remaining()) {
+        throw std::runtime_error("Trajectory is truncated");
+    }
+    const std::uint64_t recordStart = offset + sizeof(std::uint32_t);
+    Cursor cursor(data, recordStart, recordStart + recordSize);
+
+    const auto kind = cursor.Value<FrameKind>();
+    m_frame.step = cursor.Value<std::uint64_t>();
+    cursor.Bytes(m_frame.transforms.data(), m_frame.transforms.size() * sizeof(glm::mat4));
+    if (kind == FrameKind::Keyframe) {
+        cursor.Bytes(m_frame.vertices.data(), m_frame.vertices.size() * sizeof(m_frame.vertices[0]));
+    } else if (kind == FrameKind::Delta && m_decoded + 1 == frame) {
+        for (auto& vertex : m_frame.vertices) {
+            for (Real& coordinate : vertex) {
+                coordinate = applyDelta(coordinate, cursor.Varint(), m_quantum);
+            }
+        }
+    } else {
+        throw std::runtime_error("Trajectory frame " + std::to_string(frame) + " has no valid predecessor");
+    }
+    if (m_hasFields) {
+        cursor.Bytes(m_frame.differential.data(), m_frame.differential.size() * sizeof(glm::vec3));
+        cursor.Bytes(m_frame.gradient.data(), m_frame.gradient.size() * sizeof(glm::vec3));
+    }
+    if (cursor.Remaining() != 0) {
+        throw std::runtime_error("Trajectory frame " + std::to_string(frame) + " has trailing data");
+    }
+    m_decoded = frame;
+}
+
+}  // namespace IO
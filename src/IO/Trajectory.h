@@ -0,0 +1,183 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <glm/glm.hpp>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Utils/GlobalTypes.h"
+#include "../Utils/Helpers.h"
+#include "../Utils/SpscQueue.h"
+#include "MappedFile.h"
+
+namespace IO {
+
+// An object as recorded in a trajectory; playback matches recorded objects to scene objects by id.
+struct TrajectoryObject {
+    int id = -1;
+    std::size_t vertexCount = 0;
+};
+
+struct TrajectoryOptions {
+    bool recordFields = false;  // Store a differential and a gradient per vertex with every frame
+    double quantum = 1e-7;      // Vertex deltas are rounded to multiples of this, in local units
+    int keyframeInterval = 30;  // Every this many frames is stored at full precision
+    int queueFrames = 16;       // Frames buffered for the writer thread
+};
+
+// One physics step of every recorded object. Objects are stored back to back in the order of the trajectory's
+// object list: one transform each, and their vertices (and field vectors) one after the other.
+struct TrajectoryFrame {
+    std::uint64_t step = 0;
+    std::vector<glm::mat4> transforms;
+    std::vector<std::array<Real, amb_dim>> vertices;  // Local coordinates
+    std::vector<glm::vec3> differential;              // Empty unless the trajectory records fields
+    std::vector<glm::vec3> gradient;
+};
+
+// What Record copies of one object. Missing fields are recorded as zero vectors.
+struct RecordedObject {
+    Utils::VertexSpan vertices;
+    glm::mat4 transform{1.0f};
+    const std::vector<glm::vec3>* differential = nullptr;
+    const std::vector<glm::vec3>* gradient = nullptr;
+};
+
+// --- Recording ---
+// Streams frames to a file without ever blocking the caller on I/O. Record copies a frame into a slot of a lock-free
+// queue; a writer thread encodes it and writes it out. Keyframes hold the vertices at full precision, the frames in
+// between only their change since the previous frame, rounded to `quantum` and stored as variable-length integers.
+// The rounding error does not accumulate: each delta is taken against the positions a reader will reconstruct.
+// If the writer falls behind and the queue is full, the frame is dropped and counted; the next frame's deltas span
+// the gap. Closing appends an index of all frames, which lets readers seek directly. Not thread-safe on the
+// recording side: Record must always be called from the same thread.
+class TrajectoryRecorder {
+  public:
+    // Creates the file and writes its header. Throws std::runtime_error if it cannot be created.
+    TrajectoryRecorder(const std::string& path, std::vector<TrajectoryObject> objects,
+                       const TrajectoryOptions& options);
+    ~TrajectoryRecorder();  // Closes the file, waiting for queued frames to be written
+
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    // `objects` follows the order given on construction. Returns false if the frame was dropped because the writer
+    // is behind or has failed. Throws std::invalid_argument if the objects do not match the recording.
+    bool Record(std::uint64_t step, std::span<const RecordedObject> objects);
+    void Close();  // Writes the remaining frames and the index; idempotent
+
+    const std::string& GetPath() const {
+        return m_path;
+    }
+    std::uint64_t GetRecordedFrames() const {
+        return m_recordedFrames.load(std::memory_order_relaxed);
+    }
+    std::uint64_t GetDroppedFrames() const {
+        return m_droppedFrames.load(std::memory_order_relaxed);
+    }
+    std::uint64_t GetBytesWritten() const {
+        return m_bytesWritten.load(std::memory_order_relaxed);
+    }
+    bool HasFailed() const {  // A write failed; later frames are dropped
+        return m_failed.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct Slot {
+        TrajectoryFrame frame;
+        bool last = false;  // Sent by Close: nothing follows
+    };
+    struct IndexEntry {
+        std::uint64_t offset = 0;
+        std::uint64_t keyframe = 0;  // Frame to start decoding from
+        std::uint64_t step = 0;
+    };
+
+    void WriterLoop();
+    void EncodeFrame(const TrajectoryFrame& frame);
+    bool EncodeDeltas(const TrajectoryFrame& frame);  // False if a delta is too large; nothing is kept then
+    void Write(const void* data, std::size_t size);
+
+    std::string m_path;
+    std::vector<TrajectoryObject> m_objects;
+    TrajectoryOptions m_options;
+    std::size_t m_vertexCount = 0;  // Over all objects
+    bool m_closed = false;
+
+    // --- Writer thread state ---
+    std::ofstream m_out;
+    std::vector<std::array<Real, amb_dim>> m_reconstructed;  // What a reader holds after the last written frame
+    std::vector<std::uint8_t> m_record;                      // Encoding buffer, reused
+    std::vector<IndexEntry> m_index;
+    std::uint64_t m_offset = 0;
+
+    std::atomic<std::uint64_t> m_recordedFrames{0};
+    std::atomic<std::uint64_t> m_droppedFrames{0};
+    std::atomic<std::uint64_t> m_bytesWritten{0};
+    std::atomic<bool> m_failed{false};
+    Utils::SpscQueue<Slot> m_queue;
+    std::thread m_writer;  // Declared last so the state above exists before the thread starts
+};
+
+// --- Playback ---
+// Memory-maps a trajectory for random access. Seeking decodes from the frame's keyframe on, at most
+// keyframeInterval - 1 delta frames; stepping forward one frame decodes a single record. A file whose recording was
+// interrupted has no index: it is rebuilt from the records, and a truncated last record is ignored.
+class TrajectoryReader {
+  public:
+    // Throws std::runtime_error on unreadable, corrupt or foreign-endian files.
+    explicit TrajectoryReader(const std::string& path);
+
+    const std::vector<TrajectoryObject>& GetObjects() const {
+        return m_objects;
+    }
+    bool HasFields() const {
+        return m_hasFields;
+    }
+    std::size_t GetFrameCount() const {
+        return m_index.size();
+    }
+    std::uint64_t GetStep(std::size_t frame) const;
+    bool WasIndexRebuilt() const {
+        return m_indexRebuilt;
+    }
+
+    // The decoded frame; valid until the next Seek. Throws std::out_of_range for frame >= GetFrameCount() and
+    // std::runtime_error on corrupt records.
+    const TrajectoryFrame& Seek(std::size_t frame);
+
+  private:
+    struct IndexEntry {
+        std::uint64_t offset = 0;
+        std::uint64_t keyframe = 0;
+        std::uint64_t step = 0;
+    };
+
+    void ReadHeader();
+    bool ReadIndex();  // False if the file has no valid index
+    void RebuildIndex();
+    void DecodeFrame(std::size_t frame);
+
+    MappedFile m_file;
+    std::vector<TrajectoryObject> m_objects;
+    bool m_hasFields = false;
+    double m_quantum = 0.0;
+    std::size_t m_vertexCount = 0;
+    std::uint64_t m_firstRecord = 0;  // Offset just past the header
+    std::vector<IndexEntry> m_index;
+    bool m_indexRebuilt = false;
+
+    TrajectoryFrame m_frame;
+    std::size_t m_decoded = static_cast<std::size_t>(-1);  // Frame held in m_frame
+};
+
+}  // namespace IO
+
+#endif  // TRAJECTORY_H
@@ -1,24 +1,30 @@
 #include "SceneManager.h"
 
-#include <polyscope/polyscope.h>
-
-#include <glm/gtc/matrix_inverse.hpp>
+#include <algorithm>
 
 #include "../Config/Config.h"
 #include "../Engine/RepulsorEngine.h"
 #include "../Engine/VisualizationEngine.h"
+#include "../Utils/BroadPhase.h"
 #include "../Utils/Helpers.h"
+#include "../Utils/Log.h"
+#include "../Utils/Profiler.h"
 #include "SceneObject.h"
 
+namespace {
+// Kept obstacle sources are only dropped beyond this multiple of the interaction radius.
+constexpr Real kCullingHysteresis = 1.25;
+}  // namespace
+
 SceneManager::SceneManager(RepulsorEngine& repulsorEngine, VisualizationEngine& vizEngine, const ConfigType& config)
     : m_repulsorEngine(repulsorEngine), m_vizEngine(vizEngine), m_config(config) {
 }
 
-Utils::CombinedObstacleGeometry SceneManager::CalculateCombinedObstacleGeometryForObject(int targetObjectId) {
-    Utils::CombinedObstacleGeometry result;
+bool SceneManager::CollectObstacleSources(int targetObjectId, std::vector<int>& sourceIds) const {
+    sourceIds.clear();
     if (!m_currentSceneDef) {
-        polyscope::error("CalcCombineObstacle: No scene loaded.");
-        return result;
+        Log::error("BuildObstacleLayout: No scene loaded.");
+        return false;
     }
 
     // Find Target SceneObjectDefinition
@@ -30,24 +36,22 @@ Utils::CombinedObstacleGeometry SceneManager::CalculateCombinedObstacleGeometryF
         }
     }
     if (!targetObjDefPtr) {
-        polyscope::warning("CalcCombineObstacle: Could not find SceneObjectDefinition for target ID " +
-                           std::to_string(targetObjectId));
-        return result;
+        Log::warning("BuildObstacleLayout: Could not find SceneObjectDefinition for target ID " +
+                     std::to_string(targetObjectId));
+        return false;
     }
     const auto& targetObjDef = *targetObjDefPtr;
 
-    // Determine Source SceneObjectDefinitions
-    std::vector<const SceneObjectDefinition*> sourceDefs;
+    // No obstacle defined, or no valid sources found, is a success (empty result)
     if (targetObjDef.obstacleDefinitionIds.empty()) {
-        result.success = true;  // No obstacle defined is a success (empty result)
-        return result;
+        return true;
     }
 
     if (targetObjDef.obstacleDefinitionIds.size() == 1 && targetObjDef.obstacleDefinitionIds[0] == -1) {
         // Combine all OTHER obstacle sources
         for (const auto& sourceDef : m_currentSceneDef->objectDefs) {
             if (sourceDef.id != targetObjDef.id && sourceDef.isObstacleSource) {
-                sourceDefs.push_back(&sourceDef);
+                sourceIds.push_back(sourceDef.id);
             }
         }
     } else {
@@ -60,162 +64,386 @@ Utils::CombinedObstacleGeometry SceneManager::CalculateCombinedObstacleGeometryF
         }
         for (int source_id : targetObjDef.obstacleDefinitionIds) {
             if (source_id != targetObjDef.id && sourceMap.count(source_id)) {
-                sourceDefs.push_back(sourceMap.at(source_id));
+                sourceIds.push_back(source_id);
             }
         }
     }
+    return true;
+}
 
-    if (sourceDefs.empty()) {
-        result.success = true;  // No valid sources found is a success (empty result)
-        return result;
-    }
-
-    // Combine Source Geometries Using Current World Coordinates from runtime state (m_objects)
-    int current_vertex_offset = 0;
-    for (const auto* sourceDefPtr : sourceDefs) {
-        const auto& sourceDef = *sourceDefPtr;
+Utils::CombinedObstacleGeometry SceneManager::BuildObstacleLayout(const std::vector<int>& sourceIds) {
+    Utils::CombinedObstacleGeometry result;
 
-        // Find the corresponding runtime SceneObject for this source definition
-        SceneObject* sourceRuntimeObj = GetObjectById(sourceDef.id);  // Use helper
+    // Validate sources first so the combined simplices are allocated once, even for thousands of sources.
+    std::vector<SceneObject*> sources;
+    sources.reserve(sourceIds.size());
+    size_t simplexCount = 0;
+    for (int sourceId : sourceIds) {
+        SceneObject* sourceRuntimeObj = GetObjectById(sourceId);
         if (!sourceRuntimeObj) {
-            polyscope::warning("CalcCombineObstacle: Could not find Runtime Object for source ID " +
-                               std::to_string(sourceDef.id));
+            Log::warning("BuildObstacleLayout: Could not find Runtime Object for source ID " +
+                         std::to_string(sourceId));
             continue;  // Skip this source
         }
-
-        // Get source's INITIAL vertices, CURRENT transform, and simplices definition
-        const auto& sourceInitialVertices = sourceRuntimeObj->GetInitialVertices();  // Get from runtime obj
-        const auto& sourceTransform = sourceRuntimeObj->GetCurrentTransform();       // Get from runtime obj
-        const auto* sourceSimplicesPtr =
-            sourceDef.meshData ? &sourceDef.meshData->simplices : nullptr;  // Get from definition
-
-        if (sourceInitialVertices.empty() || !sourceSimplicesPtr || sourceSimplicesPtr->empty()) {
-            polyscope::warning("CalcCombineObstacle: Skipping source " + sourceDef.baseName +
-                               std::to_string(sourceDef.id) + " (missing geom).");
+        if (sourceRuntimeObj->GetInitialVertices().empty() || sourceRuntimeObj->GetSimplices().empty()) {
+            Log::warning("BuildObstacleLayout: Skipping source " + sourceRuntimeObj->GetUniqueName() +
+                         " (missing geom).");
             continue;  // Skip invalid source
         }
-        const auto& sourceSimplices = *sourceSimplicesPtr;
-
-        // Calculate CURRENT WORLD coordinates for this source
-        std::vector<std::array<Real, amb_dim>> transformedSourceVerts =
-            Utils::applyTransform(sourceInitialVertices, sourceTransform);
-
-        // Append transformed vertices and adjusted simplices
-        result.combined_world_vertices.insert(result.combined_world_vertices.end(), transformedSourceVerts.begin(),
-                                              transformedSourceVerts.end());
+        sources.push_back(sourceRuntimeObj);
+        simplexCount += sourceRuntimeObj->GetSimplices().size();
+    }
+    result.source_ids.reserve(sources.size());
+    result.source_vertex_offsets.reserve(sources.size() + 1);
+    result.combined_simplices.reserve(simplexCount);
+
+    // Concatenate the (shared) source topologies once; vertex positions are filled by WriteObstacleWorldCoordinates.
+    Int current_vertex_offset = 0;
+    for (SceneObject* sourceRuntimeObj : sources) {
+        const auto& sourceInitialVertices = sourceRuntimeObj->GetInitialVertices();
+        const auto& sourceSimplices = sourceRuntimeObj->GetSimplices();
+
+        result.source_ids.push_back(sourceRuntimeObj->GetId());
+        result.source_vertex_offsets.push_back(current_vertex_offset);
         for (const auto& simplex_orig : sourceSimplices) {
             result.combined_simplices.push_back({simplex_orig[0] + current_vertex_offset,
                                                  simplex_orig[1] + current_vertex_offset,
                                                  simplex_orig[2] + current_vertex_offset});
         }
-        current_vertex_offset += transformedSourceVerts.size();
-    }  // End loop over sources
+        current_vertex_offset += static_cast<Int>(sourceInitialVertices.size());
+    }
+    result.source_vertex_offsets.push_back(current_vertex_offset);
+    result.combined_world_vertices.resize(current_vertex_offset);
+    result.source_versions.assign(result.source_ids.size(), Utils::CombinedObstacleGeometry::kNotWritten);
+    result.source_transforms.resize(result.source_ids.size());
+    result.source_drift_at_build.assign(result.source_ids.size(), 0.0);
 
     result.success = true;
     return result;
 }
 
+void SceneManager::BuildObstacleLayouts() {
+    m_obstacleGeometries.clear();
+    m_obstacleCandidates.clear();
+    m_obstacleDependents.clear();
+    m_obstacleTargetIds.clear();
+    for (auto& objPtr : m_objects) {
+        if (!objPtr->IsSimulated()) {
+            continue;
+        }
+        m_obstacleTargetIds.insert(objPtr->GetId());
+        std::vector<int>& candidates = m_obstacleCandidates[objPtr->GetId()];
+        if (CollectObstacleSources(objPtr->GetId(), candidates)) {
+            m_obstacleGeometries[objPtr->GetId()] = BuildObstacleLayout(candidates);
+            for (int sourceId : candidates) {
+                m_obstacleDependents[sourceId].push_back(objPtr->GetId());
+            }
+        } else {
+            m_obstacleGeometries[objPtr->GetId()] = Utils::CombinedObstacleGeometry();  // success == false
+        }
+    }
+}
+
+void SceneManager::SelectObstacleSources(const std::set<int>& targetIds) {
+    const bool culling = m_config.Obstacles.distanceCulling;
+    const Real radius = std::max(0.0, m_config.Obstacles.interactionRadius);
+    const Real keepRadius = radius * kCullingHysteresis;
+
+    // World boxes of all objects, indexed like m_objects (so m_objectIndexById doubles as the box index).
+    Utils::ScratchArena::Scope scratch(m_stepArena);
+    std::span<Utils::Aabb> boxes;
+    std::span<char> selected;
+    std::span<char> wasKept;  // The target's current sources, so the query below tests membership in O(1)
+    if (culling) {
+        boxes = m_stepArena.Allocate<Utils::Aabb>(m_objects.size());
+        selected = m_stepArena.Allocate<char>(m_objects.size());
+        wasKept = m_stepArena.Allocate<char>(m_objects.size());
+        Real extentSum = 0.0;
+        for (size_t i = 0; i < m_objects.size(); ++i) {
+            boxes[i] = Utils::computeWorldAabb(m_objects[i]->GetInitialVertices(), m_objects[i]->GetCurrentTransform());
+            extentSum += Utils::aabbMaxExtent(boxes[i]);
+        }
+        const Real meanExtent = boxes.empty() ? 0.0 : extentSum / static_cast<Real>(boxes.size());
+        m_cullingGrid.Build(boxes, std::max(keepRadius, meanExtent));
+    }
+
+    const long long rebuildsBefore = m_broadPhaseStats.layoutRebuilds;
+    std::vector<int>& nearby = m_cullingNearby;
+    std::vector<int>& kept = m_cullingKept;
+
+    for (int targetId : targetIds) {
+        auto geoIt = m_obstacleGeometries.find(targetId);
+        if (geoIt == m_obstacleGeometries.end() || !geoIt->second.success) {
+            continue;
+        }
+        Utils::CombinedObstacleGeometry& obsGeo = geoIt->second;
+        const std::vector<int>& candidates = m_obstacleCandidates[targetId];
+
+        if (!culling) {
+            kept = candidates;
+        } else {
+            // Sources inside the radius are kept; already kept ones stay until they leave the wider hysteresis band,
+            // so objects hovering at the boundary do not force a rebuild every step.
+            const Utils::Aabb& targetBox = boxes[m_objectIndexById.at(targetId)];
+            for (int id : obsGeo.source_ids) {
+                auto it = m_objectIndexById.find(id);
+                if (it != m_objectIndexById.end()) {
+                    wasKept[it->second] = 1;
+                }
+            }
+            m_cullingGrid.Query(targetBox, keepRadius, nearby);
+            for (int index : nearby) {
+                selected[index] = wasKept[index] || Utils::aabbDistance(targetBox, boxes[index]) <= radius;
+            }
+            kept.clear();
+            for (int id : candidates) {
+                auto it = m_objectIndexById.find(id);
+                if (it != m_objectIndexById.end() && selected[it->second]) {
+                    kept.push_back(id);
+                }
+            }
+            for (int index : nearby) {
+                selected[index] = 0;
+            }
+            for (int id : obsGeo.source_ids) {
+                auto it = m_objectIndexById.find(id);
+                if (it != m_objectIndexById.end()) {
+                    wasKept[it->second] = 0;
+                }
+            }
+
+            // Repulsor cannot unload an obstacle, so a target whose neighbours all left keeps its last set.
+            SceneObject* target = GetObjectById(targetId);
+            if (kept.empty() && target && target->GetObstacleMesh()) {
+                kept = obsGeo.source_ids;
+            }
+        }
+
+        if (kept != obsGeo.source_ids) {
+            obsGeo = BuildObstacleLayout(kept);
+            obsGeo.layoutChanged = true;
+            ++m_broadPhaseStats.layoutRebuilds;
+        }
+    }
+
+    m_broadPhaseStats.keptSources = 0;
+    m_broadPhaseStats.culledSources = 0;
+    for (const auto& [targetId, obsGeo] : m_obstacleGeometries) {
+        const int candidateCount = static_cast<int>(m_obstacleCandidates[targetId].size());
+        m_broadPhaseStats.keptSources += static_cast<int>(obsGeo.source_ids.size());
+        m_broadPhaseStats.culledSources += std::max(0, candidateCount - static_cast<int>(obsGeo.source_ids.size()));
+    }
+
+    if (m_broadPhaseStats.layoutRebuilds != rebuildsBefore) {
+        TPE_LOG_INFO("Obstacle sources changed: ", m_broadPhaseStats.keptSources, " kept, ",
+                     m_broadPhaseStats.culledSources, " culled.");
+    }
+}
+
+bool SceneManager::WriteObstacleWorldCoordinates(Utils::CombinedObstacleGeometry& obsGeo) {
+    obsGeo.coordinatesChanged = false;
+    for (size_t s = 0; s < obsGeo.source_ids.size(); ++s) {
+        SceneObject* source = GetObjectById(obsGeo.source_ids[s]);
+        const Int offset = obsGeo.source_vertex_offsets[s];
+        const Int count = obsGeo.source_vertex_offsets[s + 1] - offset;
+        if (!source || static_cast<Int>(source->GetInitialVertices().size()) != count) {
+            Log::error("WriteObstacleWorldCoordinates: Source " + std::to_string(obsGeo.source_ids[s]) +
+                       " no longer matches the obstacle layout.");
+            return false;
+        }
+        // Only moved or deformed sources are rewritten; dragging one object leaves the other blocks alone
+        const std::uint64_t version = source->GetCoordinateVersion();
+        const glm::mat4& transform = source->GetCurrentTransform();
+        if (obsGeo.source_versions[s] == version && obsGeo.source_transforms[s] == transform) {
+            ++m_broadPhaseStats.sourcesUnchanged;
+            continue;
+        }
+        Utils::applyTransformInto(source->GetInitialVertices(), transform,
+                                  obsGeo.combined_world_vertices.data() + offset);
+        obsGeo.source_versions[s] = version;
+        obsGeo.source_transforms[s] = transform;
+        obsGeo.coordinatesChanged = true;
+        ++m_broadPhaseStats.sourcesRewritten;
+    }
+    return true;
+}
+
+bool SceneManager::ObstacleDrifted(const Utils::CombinedObstacleGeometry& obsGeo) {
+    for (size_t s = 0; s < obsGeo.source_ids.size(); ++s) {
+        const SceneObject* source = GetObjectById(obsGeo.source_ids[s]);
+        if (!source) {
+            continue;
+        }
+        const ClusterTreeState& tree = source->GetClusterTreeState();
+        if (clusterTreeDrifted(tree.drift - obsGeo.source_drift_at_build[s], tree.extent,
+                               m_config.TPE.treeRebuildDrift)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SceneManager::RecordObstacleBuild(Utils::CombinedObstacleGeometry& obsGeo) {
+    for (size_t s = 0; s < obsGeo.source_ids.size(); ++s) {
+        const SceneObject* source = GetObjectById(obsGeo.source_ids[s]);
+        obsGeo.source_drift_at_build[s] = source ? source->GetClusterTreeState().drift : 0.0;
+    }
+}
+
 void SceneManager::UpdateRepulsorObstacleForObject(SceneObject& targetObject,
-                                                   const Utils::CombinedObstacleGeometry& obsGeo) {
+                                                   Utils::CombinedObstacleGeometry& obsGeo) {
     Mesh_T* targetMesh = targetObject.GetRepulsorMesh();
     if (!targetMesh) {
-        polyscope::warning("UpdateRepulsorObstacle: Target object " + targetObject.GetUniqueName() +
-                           " has no Repulsor mesh.");
+        Log::warning("UpdateRepulsorObstacle: Target object " + targetObject.GetUniqueName() +
+                     " has no Repulsor mesh.");
         return;
     }
     if (!obsGeo.success) {
-        polyscope::error("UpdateRepulsorObstacle: Input geometry calculation failed for " +
-                         targetObject.GetUniqueName() + ". Obstacle not updated.");
+        Log::error("UpdateRepulsorObstacle: Input geometry calculation failed for " +
+                   targetObject.GetUniqueName() + ". Obstacle not updated.");
         return;
     }
 
     size_t v_count = obsGeo.combined_world_vertices.size();
     size_t f_count = obsGeo.combined_simplices.size();
+    if (v_count == 0 || f_count == 0) {
+        return;  // Nothing to load
+    }
 
-    std::unique_ptr<Mesh_T> newObstacleMesh = nullptr;
-
-    if (v_count > 0 && f_count > 0) {
-        newObstacleMesh =
-            m_repulsorEngine.CreateObstacleMesh(obsGeo.combined_world_vertices, obsGeo.combined_simplices);
-        if (!newObstacleMesh) {
-            polyscope::error("UpdateRepulsorObstacle: RepulsorEngine failed to create new obstacle mesh for " +
-                             targetObject.GetUniqueName() + ". Obstacle not updated.");
-            return;
-        }
-
-    } else {
-        polyscope::info("UpdateRepulsorObstacle: Combined obstacle for " + targetObject.GetUniqueName() +
-                        " is empty. No obstacle loaded/cleared.");
+    // Fast paths: the obstacle already exists with this layout, and either none of its sources changed (e.g. only
+    // the target itself moved) or only its coordinates move, which refits the existing cluster tree.
+    const bool layoutChanged = obsGeo.layoutChanged;
+    obsGeo.layoutChanged = false;
+    if (!layoutChanged && !obsGeo.coordinatesChanged && targetObject.GetObstacleMesh()) {
+        ++m_broadPhaseStats.obstaclesUnchanged;
+        return;
+    }
+    if (!layoutChanged && m_repulsorEngine.UpdateObstacleCoordinates(targetObject, obsGeo.combined_world_vertices)) {
+        return;
     }
 
-    // --- Load the new mesh ---
-    if (newObstacleMesh) {  // Only attempt load if we have a valid mesh ptr
-        try {
-            targetMesh->LoadObstacle(std::move(newObstacleMesh));
-        } catch (const std::exception& e) {
-            polyscope::error("UpdateRepulsorObstacle: Exception during LoadObstacle for " +
-                             targetObject.GetUniqueName() + ": " + std::string(e.what()));
-        }
-    } else {
-        polyscope::info("UpdateRepulsorObstacle: No valid new obstacle mesh created/provided for " +
-                        targetObject.GetUniqueName() + ". Existing obstacle remains unchanged.");
+    std::unique_ptr<Mesh_T> newObstacleMesh =
+        m_repulsorEngine.CreateObstacleMesh(obsGeo.combined_world_vertices, obsGeo.combined_simplices);
+    if (!newObstacleMesh) {
+        Log::error("UpdateRepulsorObstacle: RepulsorEngine failed to create new obstacle mesh for " +
+                   targetObject.GetUniqueName() + ". Obstacle not updated.");
+        return;
+    }
+    if (m_repulsorEngine.LoadObstacle(targetObject, std::move(newObstacleMesh))) {
+        RecordObstacleBuild(obsGeo);
     }
 }
 
 void SceneManager::UpdateObstaclesForAllObjects() {
+    UpdateObstaclesForTargets(m_obstacleTargetIds);
+}
+
+void SceneManager::UpdateObstaclesForTargets(const std::set<int>& targetIds) {
     if (!m_currentSceneDef) {
         return;
     }
+    if (m_sceneMesh) {
+        UpdateSharedSceneObstacle();
+        return;
+    }
 
-    polyscope::info("Updating obstacles for all relevant objects...");
-    std::vector<int> updated_object_ids;
+    TPE_LOG_DEBUG("Updating obstacles for ", targetIds.size(), " object(s)...");
+    SelectObstacleSources(targetIds);
+    Utils::ScratchArena::Scope scratch(m_stepArena);
+    std::span<int> updated_object_ids = m_stepArena.Allocate<int>(targetIds.size());
+    size_t updatedCount = 0;
 
-    for (auto& objPtr : m_objects) {
-        if (!objPtr->IsSimulated()) {
+    for (int targetId : targetIds) {
+        SceneObject* target = GetObjectById(targetId);
+        auto it = m_obstacleGeometries.find(targetId);
+        if (!target || !target->IsSimulated() || it == m_obstacleGeometries.end()) {
             continue;
         }
+        Utils::CombinedObstacleGeometry& obsGeo = it->second;
+        if (obsGeo.success && !WriteObstacleWorldCoordinates(obsGeo)) {
+            continue;
+        }
+        if (obsGeo.success && !obsGeo.layoutChanged && target->GetObstacleMesh() && ObstacleDrifted(obsGeo)) {
+            obsGeo.layoutChanged = true;  // Rebuilt below instead of refitted
+            ++m_broadPhaseStats.driftRebuilds;
+        }
 
-        Utils::CombinedObstacleGeometry obsGeo = CalculateCombinedObstacleGeometryForObject(objPtr->GetId());
-
-        UpdateRepulsorObstacleForObject(*objPtr, obsGeo);
-        updated_object_ids.push_back(objPtr->GetId());
+        UpdateRepulsorObstacleForObject(*target, obsGeo);
+        updated_object_ids[updatedCount++] = targetId;
     }
 
-    for (int id : updated_object_ids) {
+    for (int id : updated_object_ids.first(updatedCount)) {
         SceneObject* obj = GetObjectById(id);
         if (obj) {
             m_vizEngine.UpdateSingleObstacleVisual(*obj);
         }
     }
 
-    polyscope::info("Obstacle updates complete.");
+    TPE_LOG_DEBUG("Obstacle updates complete.");
+}
+
+void SceneManager::RefreshObstacles() {
+    FlushPendingUpdates();
+    if (m_sceneMesh && !SharedSceneObstacleEnabled()) {
+        ReleaseSharedSceneObstacle();  // Loads fresh per-object obstacles
+        m_vizEngine.RequestRedraw();
+        return;
+    }
+    // An explicit refresh rewrites and refits every obstacle, whether its sources changed or not
+    for (auto& [targetId, obsGeo] : m_obstacleGeometries) {
+        std::fill(obsGeo.source_versions.begin(), obsGeo.source_versions.end(),
+                  Utils::CombinedObstacleGeometry::kNotWritten);
+    }
+    std::fill(m_sceneLayout.source_versions.begin(), m_sceneLayout.source_versions.end(),
+              Utils::CombinedObstacleGeometry::kNotWritten);
+    UpdateObstaclesForAllObjects();
+    m_vizEngine.RequestRedraw();
 }
 
 bool SceneManager::LoadScene(const SceneDefinition& sceneDef) {
     UnloadScene();
     m_currentSceneDef = std::make_unique<SceneDefinition>(sceneDef);
 
-    polyscope::info("Loading scene: " + m_currentSceneDef->sceneName);
+    Log::info("Loading scene: " + m_currentSceneDef->sceneName);
 
     m_objects.reserve(m_currentSceneDef->objectDefs.size());
+    std::vector<size_t> simulatedVertexCounts;
     for (const auto& objDef : m_currentSceneDef->objectDefs) {
         m_objects.push_back(std::make_unique<SceneObject>(objDef));
+        m_objectIndexById[objDef.id] = m_objects.size() - 1;
+        if (m_objects.back()->IsSimulated()) {
+            simulatedVertexCounts.push_back(m_objects.back()->GetInitialVertices().size());
+        }
+    }
 
-        SceneObject* newObj = m_objects.back().get();
+    // Meshes take their Repulsor thread count from the plan, so it has to exist before they are created
+    m_repulsorEngine.PlanThreads(simulatedVertexCounts);
 
+    // Meshes are independent, so large scenes build them in parallel
+    std::vector<SceneObject*> simulated;
+    for (const auto& newObj : m_objects) {
         if (newObj->IsSimulated()) {
-            bool meshCreated = m_repulsorEngine.InitializeRepulsorMesh(*newObj);
-            if (!meshCreated) {
-                polyscope::error("Failed to initialize Repulsor mesh for " + newObj->GetUniqueName());
-                UnloadScene();
-                return false;
-            }
+            simulated.push_back(newObj.get());
         }
+    }
+    std::vector<BatchResult<bool>> meshResults = m_repulsorEngine.InitializeRepulsorMeshes(simulated);
+    for (size_t i = 0; i < meshResults.size(); ++i) {
+        if (!meshResults[i].ok) {
+            Log::error("Failed to initialize Repulsor mesh for " + simulated[i]->GetUniqueName() + ": " +
+                       meshResults[i].error);
+            UnloadScene();
+            return false;
+        }
+    }
 
-        // Register with visualization
+    // Register with visualization
+    for (const auto& newObj : m_objects) {
         m_vizEngine.RegisterObject(*newObj);
     }
 
+    if (!SharedSceneObstacleEnabled() || !BuildSharedSceneObstacle()) {
+        BuildObstacleLayouts();
+    }
     UpdateObstaclesForAllObjects();
 
     // --- Set initial active object ---
@@ -232,17 +460,52 @@ bool SceneManager::LoadScene(const SceneDefinition& sceneDef) {
     // Tell VisualizationEngine about the initial active object (no previous one)
     m_vizEngine.UpdateActiveGizmo("", activeObjectName);  // Pass empty string for old name
 
-    polyscope::info("Scene loaded successfully.");
+    Log::info("Scene loaded successfully.");
     return true;
 }
 
 void SceneManager::UnloadScene() {
-    polyscope::info("SceneManager: Unloading current scene...");
+    Log::info("SceneManager: Unloading current scene...");
     m_vizEngine.RemoveAllObjects();
     m_currentSceneDef.reset();
     m_activeObjectId = -1;
+    m_completedSteps = 0;
+    m_obstacleGeometries.clear();
+    m_obstacleCandidates.clear();
+    m_obstacleDependents.clear();
+    m_obstacleTargetIds.clear();
+    ClearPendingUpdates();
+    m_broadPhaseStats = Utils::BroadPhaseStats();
+    m_lastLineSearch = LineSearchSummary();
+    m_sceneMesh.reset();
+    m_sceneLayout = Utils::CombinedObstacleGeometry();
+    m_sceneSourceIndex.clear();
+    m_sceneSolverState = Utils::SolverState();
+    m_sceneWorkspace = PhysicsWorkspace();
     m_objects.clear();
-    polyscope::info("SceneManager: Scene unloaded.");
+    m_objectIndexById.clear();
+    Log::info("SceneManager: Scene unloaded.");
+}
+
+SceneDefinition SceneManager::SnapshotScene() const {
+    if (!m_currentSceneDef) {
+        return SceneDefinition();
+    }
+    SceneDefinition snapshot = *m_currentSceneDef;
+    for (SceneObjectDefinition& objDef : snapshot.objectDefs) {
+        auto it = m_objectIndexById.find(objDef.id);
+        if (it == m_objectIndexById.end()) {
+            continue;
+        }
+        const SceneObject& object = *m_objects[it->second];
+        Utils::VertexSpan vertices = object.GetInitialVertices();
+        auto meshData = std::make_shared<MeshData>();
+        meshData->vertices.assign(vertices.begin(), vertices.end());
+        meshData->topology = object.GetTopology();
+        objDef.meshData = std::move(meshData);
+        objDef.initialTransform = object.GetCurrentTransform();
+    }
+    return snapshot;
 }
 
 void SceneManager::UpdateObjectTransform(int objectId, const glm::mat4& newTransform) {
@@ -255,43 +518,73 @@ void SceneManager::UpdateObjectTransform(int objectId, const glm::mat4& newTrans
         return;
     }
 
-    SynchronizeObjectState(objectId, newTransform);
+    // Only record the change; the Repulsor state follows in FlushPendingUpdates.
+    obj->SetCurrentTransform(newTransform);
+    MarkTransformDirty(objectId);
+}
+
+bool SceneManager::SetObjectState(int objectId, Utils::VertexSpan localVertices, const glm::mat4& transform) {
+    SceneObject* obj = GetObjectById(objectId);
+    if (!obj || localVertices.size() != obj->GetInitialVertices().size()) {
+        return false;
+    }
+
+    obj->SetCurrentTransform(transform);
+    obj->SetLocalCoordinates(localVertices);  // Restarts the object's optimizer history
+    m_sceneWorkspace.optimizer.Reset();
+    MarkTransformDirty(objectId);
+    m_vizEngine.UpdateObjectVertices(*obj);
+    m_vizEngine.UpdateObjectTransform(*obj);
+    return true;
 }
 
-void SceneManager::ApplyPhysicsStep(int iterations) {
-    polyscope::info("SceneManager: Applying " + std::to_string(iterations) + " physics step(s)...");
+bool SceneManager::ApplyPhysicsStep(int iterations) {
+    TPE_LOG_INFO("SceneManager: Applying ", iterations, " physics step(s)...");
     bool step_ok = true;
-    std::map<int, Utils::IterationData> iteration_results;
+    FlushPendingUpdates();
 
     for (int iter = 0; iter < iterations && step_ok; ++iter) {
-        polyscope::info(" === Physics Step " + std::to_string(iter + 1) + " ===");
+        TPE_LOG_DEBUG(" === Physics Step ", iter + 1, " ===");
+        TPE_PROFILE_SCOPE(PhysicsStep);
+        m_stepArena.Reset();
 
         // Calculate and apply updates for one step
-        step_ok = CalculateAndApplyPhysicsUpdates(iteration_results);
+        step_ok = CalculateAndApplyPhysicsUpdates();
 
         if (!step_ok) {
-            polyscope::error("Physics step " + std::to_string(iter + 1) +
-                             " failed during calculation or application. Stopping iterations.");
+            Log::error("Physics step " + std::to_string(iter + 1) +
+                       " failed during calculation or application. Stopping iterations.");
             break;
         }
 
         UpdateObstaclesForAllObjects();
+        ++m_completedSteps;
     }
 
-    polyscope::info("Physics step(s) application attempt finished.");
+    TPE_LOG_DEBUG("Physics step(s) application attempt finished.");
     m_vizEngine.RequestRedraw();
+    return step_ok;
 }
 
 void SceneManager::UpdateEngineParametersForAllObjects() {
-    polyscope::info("SceneManager: Updating Repulsor parameters from config...");
+    Log::info("SceneManager: Updating Repulsor parameters from config...");
     m_repulsorEngine.UpdateEngineParameters();  // Handles p/q changes
+    if (m_sceneMesh && !SharedSceneObstacleEnabled()) {
+        ReleaseSharedSceneObstacle();  // Self energy was turned off, which the scene mesh cannot leave out
+    }
 
     for (auto& objPtr : m_objects) {
         if (objPtr->IsSimulated() && objPtr->GetRepulsorMesh()) {
             m_repulsorEngine.ApplyCurrentConfigToMesh(*objPtr);
+            objPtr->ResetSolverState();  // Previous gradients are no longer a valid guess after p/q changes
         }
     }
-    polyscope::info("SceneManager: Parameter update request complete.");
+    if (m_sceneMesh) {
+        m_repulsorEngine.ApplyCurrentConfigToMesh(*m_sceneMesh);
+        m_sceneSolverState = Utils::SolverState();
+        m_sceneWorkspace.optimizer.Reset();
+    }
+    Log::info("SceneManager: Parameter update request complete.");
 }
 
 SceneObject* SceneManager::GetActiveObject() {
@@ -310,7 +603,7 @@ bool SceneManager::SetActiveObjectId(int id) {
 
         std::string oldName = oldActiveObj ? oldActiveObj->GetUniqueName() : "";
         std::string newName = newActiveObj->GetUniqueName();
-        polyscope::info("SceneManager: Calling UpdateActiveGizmo with old='" + oldName + "', new='" + newName + "'");
+        TPE_LOG_DEBUG("SceneManager: Calling UpdateActiveGizmo with old='", oldName, "', new='", newName, "'");
 
         m_vizEngine.UpdateActiveGizmo(oldName, newName);
 
@@ -326,100 +619,388 @@ bool SceneManager::SetActiveObjectId(int id) {
 }
 
 SceneObject* SceneManager::GetObjectById(int id) {
-    if (id == -1) {
-        return nullptr;
-    }
-    for (auto& objPtr : m_objects) {
-        if (objPtr->GetId() == id) {
-            return objPtr.get();
-        }
-    }
-    return nullptr;
+    auto it = m_objectIndexById.find(id);
+    return it != m_objectIndexById.end() ? m_objects[it->second].get() : nullptr;
 }
 
 const std::vector<std::unique_ptr<SceneObject>>& SceneManager::GetObjects() const {
     return m_objects;
 }
 
-void SceneManager::SynchronizeObjectState(int objectId, const glm::mat4& newTransform) {
-    // NOTE: This function assumes the caller (UpdateObjectTransform) has already
-    //       validated the objectId and checked if the transform actually changed.
+std::vector<SceneObject*> SceneManager::GetSimulatedObjects() const {
+    std::vector<SceneObject*> simulated;
+    simulated.reserve(m_objects.size());
+    for (const auto& objPtr : m_objects) {
+        if (objPtr->IsSimulated() && objPtr->GetRepulsorMesh()) {
+            simulated.push_back(objPtr.get());
+        }
+    }
+    return simulated;
+}
+
+void SceneManager::MarkTransformDirty(int objectId) {
+    ++m_pendingTransformChanges;
     SceneObject* obj = GetObjectById(objectId);
-    if (!obj) {
+    if (obj && obj->IsSimulated()) {
+        m_pendingMeshSyncIds.insert(objectId);
+        // With culling the object's own source selection depends on where it is.
+        if (m_config.Obstacles.distanceCulling) {
+            m_pendingObstacleIds.insert(objectId);
+        }
+    }
+
+    auto it = m_obstacleDependents.find(objectId);
+    if (it != m_obstacleDependents.end()) {
+        m_pendingObstacleIds.insert(it->second.begin(), it->second.end());
+    }
+}
+
+bool SceneManager::HasPendingUpdates() const {
+    return m_pendingTransformChanges > 0;
+}
+
+void SceneManager::FlushPendingUpdates() {
+    if (!HasPendingUpdates()) {
         return;
     }
 
-    obj->SetCurrentTransform(newTransform);
+    TPE_LOG_DEBUG("SceneManager: Flushing ", m_pendingTransformChanges, " transform change(s) (",
+                  m_pendingMeshSyncIds.size(), " mesh(es), ", m_pendingObstacleIds.size(), " obstacle(s)).");
 
-    bool synced = m_repulsorEngine.UpdateRepulsorMeshState(*obj);
+    for (int id : m_pendingMeshSyncIds) {
+        SceneObject* obj = GetObjectById(id);
+        if (!obj) {
+            continue;
+        }
+        if (m_sceneMesh) {
+            // The object's own mesh is not evaluated in shared mode; ReleaseSharedSceneObstacle catches it up
+            obj->SyncWorldCoordinates();
+            continue;
+        }
+        const long long rebuildsBefore = obj->GetClusterTreeState().rebuilds;
+        if (!m_repulsorEngine.UpdateRepulsorMeshState(*obj)) {
+            Log::error("Failed to sync Repulsor state for " + obj->GetUniqueName() + " after transform update.");
+        } else if (obj->GetClusterTreeState().rebuilds != rebuildsBefore) {
+            // Replaced coordinates deformed the object far enough to be rebuilt; its new mesh needs its obstacle again
+            auto geoIt = m_obstacleGeometries.find(id);
+            if (geoIt != m_obstacleGeometries.end()) {
+                geoIt->second.layoutChanged = true;
+                m_pendingObstacleIds.insert(id);
+            }
+        }
+    }
 
-    if (synced) {
-        UpdateObstaclesForAllObjects();
-    } else {
-        polyscope::error("Failed to sync Repulsor state for " + obj->GetUniqueName() + " after transform update.");
+    if (m_sceneMesh) {
+        UpdateSharedSceneObstacle();
+    } else if (!m_pendingObstacleIds.empty()) {
+        UpdateObstaclesForTargets(m_pendingObstacleIds);
     }
+
+    m_pendingMeshSyncIds.clear();
+    m_pendingObstacleIds.clear();
+    m_pendingTransformChanges = 0;
 }
 
-bool SceneManager::CalculateAndApplyPhysicsUpdates(std::map<int, Utils::IterationData>& results) {
-    bool any_calc_failed = false;
-    results.clear();
+void SceneManager::ClearPendingUpdates() {
+    m_pendingMeshSyncIds.clear();
+    m_pendingObstacleIds.clear();
+    m_pendingTransformChanges = 0;
+}
 
+bool SceneManager::CalculateAndApplyPhysicsUpdates() {
     // --- Calculate Updates ---
-    for (auto& objPtr : m_objects) {
-        if (!objPtr->IsSimulated() || !objPtr->GetRepulsorMesh()) {
-            continue;
+    // The object list lives in the step arena; each object's displacement lands in its own workspace.
+    std::span<SceneObject*> simulatedObjects = m_stepArena.Allocate<SceneObject*>(m_objects.size());
+    size_t simulatedCount = 0;
+    for (const auto& objPtr : m_objects) {
+        if (objPtr->IsSimulated() && objPtr->GetRepulsorMesh()) {
+            simulatedObjects[simulatedCount++] = objPtr.get();
+        }
+    }
+    simulatedObjects = simulatedObjects.first(simulatedCount);
+
+    FlushPendingUpdates();
+    const bool calc_ok = m_sceneMesh ? CalculateSharedSceneDisplacements(simulatedObjects)
+                                     : m_repulsorEngine.CalculateStepDisplacements(simulatedObjects);
+    if (!calc_ok) {
+        for (SceneObject* obj : simulatedObjects) {
+            const PhysicsWorkspace& workspace = obj->GetPhysicsWorkspace();
+            if (!workspace.ok) {
+                Log::error("Physics calc failed for " + obj->GetUniqueName() + ": " + workspace.error);
+            }
         }
+        Log::warning("Aborting physics application due to calculation errors.");
+        return false;
+    }
 
-        int id = objPtr->GetId();
-        results[id] = Utils::IterationData();
+    if (m_config.Opt.lineSearch) {
+        SummarizeLineSearch(simulatedObjects);
+    }
+    if (m_config.Opt.optimizer != OptimizerType::GradientDescent && Log::enabled(Log::Level::Debug)) {
+        int fellBack = 0;
+        if (m_sceneMesh) {
+            fellBack = m_sceneWorkspace.optimizer.fellBack ? 1 : 0;
+        } else {
+            for (SceneObject* obj : simulatedObjects) {
+                fellBack += obj->GetPhysicsWorkspace().optimizer.fellBack ? 1 : 0;
+            }
+        }
+        TPE_LOG_DEBUG("Step ", m_completedSteps + 1, ": ", fellBack, " optimizer step(s) fell back to the gradient");
+    }
 
+    // --- Apply Updates ---
+    bool any_apply_failed = false;
+    for (SceneObject* obj : simulatedObjects) {
         try {
-            results[id].world_displacement = m_repulsorEngine.CalculateWorldDisplacement(*objPtr);
-            results[id].updated = true;
+            // Local update and new world coordinates come out of one pass over the object's own buffers
+            obj->ApplyWorldDisplacement(obj->GetPhysicsWorkspace().evaluation.gradient);
+
+            // In shared mode only the scene mesh is evaluated; the object's own mesh is caught up when that ends
+            if (!m_sceneMesh && m_repulsorEngine.RefitRepulsorMesh(*obj)) {
+                // The rebuilt mesh has no obstacle yet; the obstacle update after the step builds and loads one
+                auto geoIt = m_obstacleGeometries.find(obj->GetId());
+                if (geoIt != m_obstacleGeometries.end()) {
+                    geoIt->second.layoutChanged = true;
+                }
+            }
+
+            m_vizEngine.UpdateObjectVertices(*obj);
+
         } catch (const std::exception& e) {
-            polyscope::error("Physics calc failed for " + objPtr->GetUniqueName() + ": " + e.what());
-            results[id].updated = false;
-            any_calc_failed = true;
+            Log::error("Failed applying physics update for " + obj->GetUniqueName() + ": " + e.what());
+            any_apply_failed = true;
+        }
+    }
+
+    return !any_apply_failed;
+}
+
+void SceneManager::SummarizeLineSearch(std::span<SceneObject* const> objects) {
+    LineSearchSummary summary;
+    auto add = [&summary](const LineSearchState& search) {
+        summary.minStep = summary.searches == 0 ? search.acceptedStep : std::min(summary.minStep, search.acceptedStep);
+        summary.maxStep = std::max(summary.maxStep, search.acceptedStep);
+        ++summary.searches;
+        summary.accepted += search.acceptedStep > 0.0 ? 1 : 0;
+        summary.trials += search.trials;
+        summary.energyBefore += search.initialEnergy;
+        summary.energyAfter += search.energy;
+    };
+    if (m_sceneMesh) {  // The whole scene is one search
+        add(m_sceneWorkspace.lineSearch);
+        objects = {};
+    }
+    for (SceneObject* obj : objects) {
+        const LineSearchState& search = obj->GetPhysicsWorkspace().lineSearch;
+        add(search);
+        TPE_LOG_DEBUG("Line search ", obj->GetUniqueName(), ": step ", search.acceptedStep, ", energy ",
+                      search.initialEnergy, " -> ", search.energy, " in ", search.trials, " trial(s)");
+    }
+    m_lastLineSearch = summary;
+    TPE_LOG_INFO("Step ", m_completedSteps + 1, ": line search accepted ", summary.accepted, "/", summary.searches,
+                 " step(s) in [", summary.minStep, ", ", summary.maxStep, "], energy ", summary.energyBefore, " -> ",
+                 summary.energyAfter, " (", summary.trials, " trial(s))");
+}
+
+// --- Shared Scene Obstacle ---
+
+bool SceneManager::SharedSceneObstacleEnabled() const {
+    // The scene mesh cannot leave an object's self-repulsion out, so it is only used when that is wanted anyway
+    return m_config.Obstacles.sharedSceneObstacle && m_config.TPE.includeSelfEnergy;
+}
+
+bool SceneManager::CanShareSceneObstacle() const {
+    // The shared mesh moves as a whole, so it must consist of exactly the simulated objects, each repelling all
+    // others. Scenes with static sources or explicit obstacle lists keep per-object obstacles.
+    bool anySource = false;
+    for (const auto& def : m_currentSceneDef->objectDefs) {
+        if (def.isObstacleSource != def.isSimulated) {
+            return false;
+        }
+        if (def.isSimulated && (def.obstacleDefinitionIds.size() != 1 || def.obstacleDefinitionIds[0] != -1)) {
+            return false;
         }
+        anySource |= def.isObstacleSource;
     }
+    return anySource;
+}
 
-    if (any_calc_failed) {
-        polyscope::warning("Aborting physics application due to calculation errors.");
+bool SceneManager::BuildSharedSceneObstacle() {
+    if (!m_config.TPE.includeSelfEnergy) {
+        Log::warning("SceneManager: The shared scene obstacle includes self-repulsion and needs Self Energy, "
+                     "using per-object obstacles.");
+        return false;
+    }
+    if (!m_currentSceneDef || !CanShareSceneObstacle()) {
+        Log::warning("SceneManager: Scene does not qualify for a shared obstacle, using per-object obstacles.");
         return false;
     }
 
-    // --- Apply Updates ---
+    std::vector<int> sourceIds;
+    for (const auto& def : m_currentSceneDef->objectDefs) {
+        sourceIds.push_back(def.id);
+    }
+    Utils::CombinedObstacleGeometry layout = BuildObstacleLayout(sourceIds);
+    layout.success = WriteObstacleWorldCoordinates(layout);
+
+    std::unique_ptr<Mesh_T> sceneMesh;
+    if (layout.success) {
+        sceneMesh = m_repulsorEngine.CreateSceneMesh(layout.combined_world_vertices, layout.combined_simplices);
+    }
+    if (!sceneMesh) {
+        Log::error("SceneManager: Failed to build the shared scene obstacle, using per-object obstacles.");
+        return false;
+    }
+
+    RecordObstacleBuild(layout);
+    m_sceneSourceIndex.clear();
+    for (size_t s = 0; s < layout.source_ids.size(); ++s) {
+        m_sceneSourceIndex[layout.source_ids[s]] = s;
+    }
+    m_sceneLayout = std::move(layout);
+    m_sceneMesh = std::move(sceneMesh);
+    m_sceneSolverState = Utils::SolverState();
+    m_sceneWorkspace = PhysicsWorkspace();
+    const Int sceneVertexCount = static_cast<Int>(m_sceneLayout.combined_world_vertices.size());
+    Utils::ensureShape(m_sceneWorkspace.evaluation.gradient, sceneVertexCount, amb_dim);
+    Log::info("SceneManager: Shared scene obstacle built over " + std::to_string(m_sceneSourceIndex.size()) +
+              " objects (" + std::to_string(m_sceneLayout.combined_world_vertices.size()) + " vertices).");
+    return true;
+}
+
+void SceneManager::ReleaseSharedSceneObstacle() {
+    Log::info("SceneManager: Releasing the shared scene obstacle, switching to per-object obstacles.");
+    m_sceneMesh.reset();
+    m_sceneLayout = Utils::CombinedObstacleGeometry();
+    m_sceneSourceIndex.clear();
+    m_sceneSolverState = Utils::SolverState();
+    m_sceneWorkspace = PhysicsWorkspace();
+
+    // The objects' own meshes were left as they were while the scene mesh was stepped. Their drift kept growing, so
+    // objects that moved far are rebuilt here rather than refitted.
     for (auto& objPtr : m_objects) {
-        if (!objPtr->IsSimulated() || !results.count(objPtr->GetId()) || !results[objPtr->GetId()].updated) {
+        if (!objPtr->IsSimulated() || !objPtr->GetRepulsorMesh()) {
             continue;
         }
+        if (!m_repulsorEngine.UpdateRepulsorMeshState(*objPtr)) {
+            Log::error("Failed to sync Repulsor state for " + objPtr->GetUniqueName() + " after shared mode.");
+        }
+        objPtr->ResetSolverState();  // Its history predates the shared steps
+    }
+    BuildObstacleLayouts();
+    UpdateObstaclesForAllObjects();
+}
+
+void SceneManager::UpdateSharedSceneObstacle() {
+    if (!WriteObstacleWorldCoordinates(m_sceneLayout)) {
+        Log::error("SceneManager: Shared scene obstacle update failed.");
+        return;
+    }
+    if (m_sceneLayout.coordinatesChanged && ObstacleDrifted(m_sceneLayout)) {
+        std::unique_ptr<Mesh_T> sceneMesh =
+            m_repulsorEngine.CreateSceneMesh(m_sceneLayout.combined_world_vertices, m_sceneLayout.combined_simplices);
+        if (sceneMesh) {
+            m_sceneMesh = std::move(sceneMesh);
+            RecordObstacleBuild(m_sceneLayout);
+            ++m_broadPhaseStats.driftRebuilds;
+            return;
+        }
+        // Keep refitting the old mesh; it stays correct, only slower
+    }
+    if (m_sceneLayout.coordinatesChanged &&
+        !m_repulsorEngine.UpdateMeshCoordinates(*m_sceneMesh, m_sceneLayout.combined_world_vertices)) {
+        Log::error("SceneManager: Shared scene obstacle update failed.");
+    }
+}
 
-        int id = objPtr->GetId();
-        const auto& resultData = results[id];
+std::vector<BatchResult<EvaluationResult>> SceneManager::EvaluateObjects(std::span<SceneObject* const> objects,
+                                                                         EvalFlags what) {
+    FlushPendingUpdates();
+    return EvaluateCurrentState(objects, what);
+}
 
-        try {
-            glm::mat4 invTransform = glm::affineInverse(objPtr->GetCurrentTransform());
-            std::vector<std::array<Real, 3>> local_delta_vec;
-            const auto& world_disp = resultData.world_displacement;
-            local_delta_vec.reserve(world_disp.Dimension(0));
-
-            for (int v = 0; v < world_disp.Dimension(0); ++v) {
-                glm::vec4 world_d = {(float)world_disp(v, 0), (float)world_disp(v, 1), (float)world_disp(v, 2), 0.0f};
-                glm::vec4 local_d = invTransform * world_d;
-                local_delta_vec.push_back({(Real)local_d.x, (Real)local_d.y, (Real)local_d.z});
-            }
+std::vector<BatchResult<EvaluationResult>> SceneManager::EvaluateCurrentState(std::span<SceneObject* const> objects,
+                                                                              EvalFlags what,
+                                                                              std::span<const glm::mat4> frames) {
+    if (m_sceneMesh) {
+        return EvaluateSharedScene(objects, what);
+    }
+    return m_repulsorEngine.EvaluateBatch(objects, what, frames);
+}
 
-            objPtr->UpdateInitialVertices(local_delta_vec);
+std::vector<BatchResult<EvaluationResult>> SceneManager::EvaluateSharedScene(std::span<SceneObject* const> objects,
+                                                                             EvalFlags what) {
+    std::vector<BatchResult<EvaluationResult>> results(objects.size());
+
+    // One evaluation of the whole scene; each object's rows are then sliced out by its source offset.
+    EvaluationResult scene;
+    try {
+        scene = m_repulsorEngine.EvaluateSceneMesh(*m_sceneMesh, m_sceneSolverState, what);
+    } catch (const std::exception& e) {
+        for (auto& result : results) {
+            result.error = e.what();
+        }
+        return results;
+    }
 
-            m_repulsorEngine.UpdateRepulsorMeshState(*objPtr);
+    const bool hasDiff = HasFlag(scene.computed, EvalFlags::Differential);
+    const bool hasGrad = HasFlag(scene.computed, EvalFlags::Gradient);
+    for (size_t i = 0; i < objects.size(); ++i) {
+        auto it = objects[i] ? m_sceneSourceIndex.find(objects[i]->GetId()) : m_sceneSourceIndex.end();
+        if (it == m_sceneSourceIndex.end()) {
+            results[i].error = "object is not part of the shared scene obstacle";
+            continue;
+        }
 
-            m_vizEngine.UpdateObjectVertices(*objPtr);
+        const Int offset = m_sceneLayout.source_vertex_offsets[it->second];
+        const Int count = m_sceneLayout.source_vertex_offsets[it->second + 1] - offset;
+        EvaluationResult& value = results[i].value;
+        value.energy = scene.energy;
+        value.stepSize = scene.stepSize;
+        value.computed = scene.computed;
+        if (hasDiff) {
+            value.differential = Tensors::Tensor2<Real, Int>(scene.differential.data() + offset * amb_dim, count,
+                                                             amb_dim);
+        }
+        if (hasGrad) {
+            value.gradient = Tensors::Tensor2<Real, Int>(scene.gradient.data() + offset * amb_dim, count, amb_dim);
+        }
+        results[i].ok = true;
+    }
+    return results;
+}
 
-        } catch (const std::exception& e) {
-            polyscope::error("Failed applying physics update for " + objPtr->GetUniqueName() + ": " + e.what());
-            any_calc_failed = true;
+bool SceneManager::CalculateSharedSceneDisplacements(std::span<SceneObject* const> objects) {
+    // One step of the whole scene, then each object's rows are copied into its own workspace.
+    EvaluationResult& scene = m_sceneWorkspace.evaluation;
+    try {
+        m_repulsorEngine.CalculateSceneMeshStep(*m_sceneMesh, m_sceneSolverState,
+                                                m_sceneLayout.combined_world_vertices[0].data(), m_sceneWorkspace);
+    } catch (const std::exception& e) {
+        for (SceneObject* object : objects) {
+            object->GetPhysicsWorkspace().ok = false;
+            object->GetPhysicsWorkspace().error = e.what();
         }
+        return false;
     }
 
-    return !any_calc_failed;
+    bool all_ok = true;
+    for (SceneObject* object : objects) {
+        PhysicsWorkspace& workspace = object->GetPhysicsWorkspace();
+        auto it = m_sceneSourceIndex.find(object->GetId());
+        if (it == m_sceneSourceIndex.end()) {
+            workspace.ok = false;
+            workspace.error = "object is not part of the shared scene obstacle";
+            all_ok = false;
+            continue;
+        }
+
+        const Int offset = m_sceneLayout.source_vertex_offsets[it->second];
+        const Int count = m_sceneLayout.source_vertex_offsets[it->second + 1] - offset;
+        workspace.evaluation.stepSize = scene.stepSize;
+        workspace.evaluation.computed = scene.computed;
+        Utils::copyInto(workspace.evaluation.gradient, scene.gradient.data() + offset * amb_dim, count, amb_dim);
+        workspace.ok = true;
+    }
+    return all_ok;
 }
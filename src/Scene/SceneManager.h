@@ -2,18 +2,33 @@
 #define SCENE_MANAGER_H
 
 #include <map>
+#include <set>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "../Data/SceneDefinition.h"
 #include "../Engine/RepulsorEngine.h"
+#include "../Utils/BroadPhase.h"
 #include "../Utils/Helpers.h"
+#include "../Utils/ScratchArena.h"
 
 class RepulsorEngine;
 class VisualizationEngine;
 struct ConfigType;
 
+// Line searches of the last physics step (Opt.lineSearch), summed over the simulated objects, or the shared scene
+struct LineSearchSummary {
+    int searches = 0;
+    int accepted = 0;  // Searches that found a sufficient decrease; the others did not move
+    int trials = 0;
+    Real minStep = 0.0;
+    Real maxStep = 0.0;
+    Real energyBefore = 0.0;
+    Real energyAfter = 0.0;
+};
+
 class SceneManager {
   public:
     SceneManager(RepulsorEngine& repulsorEngine, VisualizationEngine& vizEngine, const ConfigType& config);
@@ -21,16 +36,65 @@ class SceneManager {
 
     bool LoadScene(const SceneDefinition& sceneDef);
     void UnloadScene();
+    // The loaded scene as it is now: each object's definition carries its current vertices and transform, so
+    // loading the result resumes from this state. Topologies are shared, not copied. Empty if no scene is loaded.
+    SceneDefinition SnapshotScene() const;
 
-    // Updates triggered by user interaction (e.g., gizmo)
+    // Updates triggered by user interaction (e.g., gizmo). Transform changes are only recorded; the Repulsor
+    // meshes and the affected obstacles are brought up to date once by FlushPendingUpdates, however many changes
+    // arrived. Evaluations and physics steps flush on their own.
     void UpdateObjectTransform(int objectId, const glm::mat4& newTransform);
+    bool HasPendingUpdates() const;
+    // Replaces an object's vertices and transform, e.g. with a recorded frame, and updates its visuals. Like a
+    // transform change, the Repulsor state only follows in FlushPendingUpdates. False if the object does not exist
+    // or has a different vertex count.
+    bool SetObjectState(int objectId, Utils::VertexSpan localVertices, const glm::mat4& transform);
+    void FlushPendingUpdates();
     void UpdateEngineParametersForAllObjects();
 
     // Updates triggered by physics step
-    void ApplyPhysicsStep(int iterations);
+    bool ApplyPhysicsStep(int iterations);  // False if a step failed; later iterations are skipped
+    unsigned long long GetCompletedSteps() const {  // Successful steps since the scene was loaded
+        return m_completedSteps;
+    }
+    void SetCompletedSteps(unsigned long long steps) {  // E.g. when resuming from a checkpoint
+        m_completedSteps = steps;
+    }
+
+    // Physics queries for the given simulated objects, answered from the shared scene obstacle when it is active.
+    // In shared mode every result carries the total scene energy and the scene-wide step size.
+    std::vector<BatchResult<EvaluationResult>> EvaluateObjects(std::span<SceneObject* const> objects, EvalFlags what);
+    // Same as EvaluateObjects, but without flushing pending transform changes first. Logs nothing, so it may run
+    // on a background thread as long as the main thread does not flush or otherwise touch Repulsor state meanwhile.
+    // There, `frames` must hold the objects' transforms as of the last flush: the main thread may move them.
+    std::vector<BatchResult<EvaluationResult>> EvaluateCurrentState(std::span<SceneObject* const> objects,
+                                                                    EvalFlags what,
+                                                                    std::span<const glm::mat4> frames = {});
+    bool IsSharedObstacleActive() const {
+        return m_sceneMesh != nullptr;
+    }
+    const Utils::SolverState& GetSharedSolverState() const {
+        return m_sceneSolverState;
+    }
+    const Utils::BroadPhaseStats& GetBroadPhaseStats() const {
+        return m_broadPhaseStats;
+    }
+    const LineSearchSummary& GetLastLineSearch() const {
+        return m_lastLineSearch;
+    }
+    const PhysicsWorkspace* GetScenePhysicsWorkspace() const {  // Null unless the shared scene obstacle is used
+        return m_sceneMesh ? &m_sceneWorkspace : nullptr;
+    }
+    const Utils::ThreadSplit& GetThreadSplit() const {
+        return m_repulsorEngine.GetThreadSplit();
+    }
+    // Re-runs source selection and obstacle updates, e.g. after culling settings change. Switches to per-object
+    // obstacles if the shared scene obstacle was turned off.
+    void RefreshObstacles();
 
     // Getters for UI or other components
     const std::vector<std::unique_ptr<SceneObject>>& GetObjects() const;
+    std::vector<SceneObject*> GetSimulatedObjects() const;  // Simulated objects with a Repulsor mesh
     SceneObject* GetObjectById(int id);  // Returns nullptr if not found
     SceneObject* GetActiveObject();
     int GetActiveObjectId() const {
@@ -41,14 +105,36 @@ class SceneManager {
 
   private:
     // Core simulation logic separated for clarity
-    bool CalculateAndApplyPhysicsUpdates(std::map<int, Utils::IterationData>& results);
-    void SynchronizeObjectState(int objectId,
-                                const glm::mat4& newTransform);  // Internal gizmo update handler
+    bool CalculateAndApplyPhysicsUpdates();  // One step; displacements land in the objects' PhysicsWorkspaces
+    void MarkTransformDirty(int objectId);  // Queues the object and every obstacle that may contain it
+    void SummarizeLineSearch(std::span<SceneObject* const> objects);  // Logs the step's searches
+    void ClearPendingUpdates();
 
     // --- Obstacle Logic ---
+    void BuildObstacleLayouts();          // Once per LoadScene: fixed topology and source offsets
     void UpdateObstaclesForAllObjects();  // Called after any state change
-    Utils::CombinedObstacleGeometry CalculateCombinedObstacleGeometryForObject(int targetObjectId);
-    void UpdateRepulsorObstacleForObject(SceneObject& targetObject, const Utils::CombinedObstacleGeometry& obsGeo);
+    void UpdateObstaclesForTargets(const std::set<int>& targetIds);
+    bool CollectObstacleSources(int targetObjectId, std::vector<int>& sourceIds) const;
+    Utils::CombinedObstacleGeometry BuildObstacleLayout(const std::vector<int>& sourceIds);
+    // Distance culling; rebuilds a layout only when its kept source set changes
+    void SelectObstacleSources(const std::set<int>& targetIds);
+    bool WriteObstacleWorldCoordinates(Utils::CombinedObstacleGeometry& obsGeo);
+    void UpdateRepulsorObstacleForObject(SceneObject& targetObject, Utils::CombinedObstacleGeometry& obsGeo);
+    // Obstacle meshes follow their sources' cluster tree drift (ClusterTreeState): refitted while every source stays
+    // close to where it was when the mesh was built, rebuilt otherwise.
+    bool ObstacleDrifted(const Utils::CombinedObstacleGeometry& obsGeo);
+    void RecordObstacleBuild(Utils::CombinedObstacleGeometry& obsGeo);
+
+    // --- Shared Scene Obstacle ---
+    bool SharedSceneObstacleEnabled() const;  // Obstacles.sharedSceneObstacle, which also needs TPE.includeSelfEnergy
+    bool CanShareSceneObstacle() const;
+    bool BuildSharedSceneObstacle();
+    // Back to per-object obstacles: refits (or rebuilds) the objects' own meshes, which shared steps leave alone
+    void ReleaseSharedSceneObstacle();
+    void UpdateSharedSceneObstacle();
+    std::vector<BatchResult<EvaluationResult>> EvaluateSharedScene(std::span<SceneObject* const> objects,
+                                                                   EvalFlags what);
+    bool CalculateSharedSceneDisplacements(std::span<SceneObject* const> objects);
 
     RepulsorEngine& m_repulsorEngine;
     VisualizationEngine& m_vizEngine;
@@ -56,7 +142,34 @@ class SceneManager {
 
     std::unique_ptr<SceneDefinition> m_currentSceneDef;
     std::vector<std::unique_ptr<SceneObject>> m_objects;
+    std::map<int, size_t> m_objectIndexById;  // Object id -> index in m_objects, for lookups in large scenes
+    std::map<int, Utils::CombinedObstacleGeometry> m_obstacleGeometries;  // Keyed by target object id
+    std::map<int, std::vector<int>> m_obstacleCandidates;  // Target id -> every source its definition allows
+    std::map<int, std::vector<int>> m_obstacleDependents;  // Source id -> targets that may include it
+    std::set<int> m_obstacleTargetIds;                     // Keys of m_obstacleGeometries
+    Utils::BroadPhaseStats m_broadPhaseStats;
+    LineSearchSummary m_lastLineSearch;
+
+    // Shared mode: one mesh over every obstacle source, laid out like a combined obstacle
+    std::unique_ptr<Mesh_T> m_sceneMesh;
+    Utils::CombinedObstacleGeometry m_sceneLayout;
+    std::map<int, size_t> m_sceneSourceIndex;  // Object id -> source index in m_sceneLayout
+    Utils::SolverState m_sceneSolverState;
+    PhysicsWorkspace m_sceneWorkspace;
     int m_activeObjectId = -1;
+    unsigned long long m_completedSteps = 0;
+
+    // Coalesced transform changes, applied by FlushPendingUpdates
+    std::set<int> m_pendingMeshSyncIds;
+    std::set<int> m_pendingObstacleIds;
+    int m_pendingTransformChanges = 0;
+
+    // Scratch reused by every physics step, so steps on a loaded scene do not allocate. Arena memory is released
+    // at the start of each step; the culling buffers below just keep their capacity.
+    Utils::ScratchArena m_stepArena;
+    Utils::UniformGrid m_cullingGrid;
+    std::vector<int> m_cullingNearby;
+    std::vector<int> m_cullingKept;
 };
 
 #endif  // SCENE_MANAGER_H
\ No newline at end of file
@@ -1,42 +1,83 @@
 #include "SceneObject.h"
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
+#include "../Utils/TransformKernels.h"
+
 SceneObject::SceneObject(const SceneObjectDefinition& def)
     : m_id(def.id), m_baseName(def.baseName), m_isInteractive(def.isInteractive),
-      m_isObstacleSource(def.isObstacleSource), m_isSimulated(def.isSimulated), m_meshDataRef(def.meshData) {
+      m_isObstacleSource(def.isObstacleSource), m_isSimulated(def.isSimulated),
+      m_currentTransform(def.initialTransform) {
     m_uniqueName = m_baseName + "_" + std::to_string(m_id);
 
-    if (m_meshDataRef) {
-        m_initialVertices = m_meshDataRef->vertices;
-    } else {
-        throw;
+    if (!def.meshData || !def.meshData->topology) {
+        throw std::runtime_error("Missing mesh data for " + m_uniqueName);
+    }
+    if (def.meshData->vertices.size() != def.meshData->topology->vertexCount) {
+        throw std::runtime_error("Vertex count does not match the shared topology for " + m_uniqueName);
+    }
+    m_topology = def.meshData->topology;
+
+    const Int vertexCount = static_cast<Int>(def.meshData->vertices.size());
+    const Real* source = vertexCount > 0 ? def.meshData->vertices[0].data() : nullptr;
+    m_localCoords = Tensors::Tensor2<Real, Int>(source, vertexCount, amb_dim);
+    m_worldCoords = Tensors::Tensor2<Real, Int>(source, vertexCount, amb_dim);
+    if (m_currentTransform != glm::mat4(1.0f)) {
+        SyncWorldCoordinates();
+    }
+    if (m_isSimulated) {
+        Utils::ensureShape(m_physicsWorkspace.evaluation.gradient, vertexCount, amb_dim);
     }
 }
 
-const std::vector<std::array<Real, amb_dim>>& SceneObject::GetInitialVertices() const {
-    return m_initialVertices;
+Utils::VertexSpan SceneObject::GetInitialVertices() const {
+    return Utils::tensorRows(m_localCoords);
 }
 
 const std::vector<std::array<Int, 3>>& SceneObject::GetSimplices() const {
-    if (!m_meshDataRef) {
-        static const std::vector<std::array<Int, 3>> empty_simplices;
-        return empty_simplices;
+    return m_topology->simplices;
+}
+
+void SceneObject::SyncWorldCoordinates() {
+    Utils::transformPoints(Utils::AffineTransform::FromMat4(m_currentTransform), m_localCoords.data(),
+                           m_worldCoords.data(), static_cast<size_t>(m_localCoords.Dimension(0)));
+}
+
+void SceneObject::SetLocalCoordinates(Utils::VertexSpan vertices) {
+    if (vertices.size() != static_cast<size_t>(m_localCoords.Dimension(0))) {
+        throw std::runtime_error("Vertex count mismatch in SetLocalCoordinates for " + m_uniqueName);
     }
-    return m_meshDataRef->simplices;
+    auto* local = reinterpret_cast<std::array<Real, amb_dim>*>(m_localCoords.data());
+    Real maxSquared = 0.0;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        Real squared = 0.0;
+        for (int k = 0; k < amb_dim; ++k) {
+            squared += (vertices[i][k] - local[i][k]) * (vertices[i][k] - local[i][k]);
+        }
+        maxSquared = std::max(maxSquared, squared);
+    }
+    m_clusterTree.drift += std::sqrt(maxSquared);  // In local units; transforms are expected to be rigid
+    std::copy(vertices.begin(), vertices.end(), local);
+    m_selfEnergyCache.valid = false;
+    m_physicsWorkspace.optimizer.Reset();  // The history describes a path the vertices are no longer on
+    ++m_coordinateVersion;
+    SyncWorldCoordinates();
 }
 
-void SceneObject::UpdateInitialVertices(const std::vector<std::array<Real, amb_dim>>& local_deltas) {
+void SceneObject::ApplyWorldDisplacement(const Tensors::Tensor2<Real, Int>& worldDisplacement) {
     if (!m_isSimulated) {
         return;
     }
-    if (local_deltas.size() != m_initialVertices.size()) {
-        throw std::runtime_error("Vertex count mismatch in UpdateInitialVertices for " + m_uniqueName);
+    if (worldDisplacement.Dimension(0) != m_localCoords.Dimension(0) || worldDisplacement.Dimension(1) != amb_dim) {
+        throw std::runtime_error("Vertex count mismatch in ApplyWorldDisplacement for " + m_uniqueName);
     }
 
-    for (size_t i = 0; i < m_initialVertices.size(); ++i) {
-        m_initialVertices[i][0] += local_deltas[i][0];
-        m_initialVertices[i][1] += local_deltas[i][1];
-        m_initialVertices[i][2] += local_deltas[i][2];
-    }
-}
\ No newline at end of file
+    m_selfEnergyCache.valid = false;
+    ++m_coordinateVersion;
+    m_clusterTree.drift += Utils::maxRowNorm(worldDisplacement);
+    Utils::AffineTransform transform = Utils::AffineTransform::FromMat4(m_currentTransform);
+    Utils::applyWorldDisplacement(transform, transform.Inverse(), worldDisplacement.data(), m_localCoords.data(),
+                                  m_worldCoords.data(), static_cast<size_t>(m_localCoords.Dimension(0)));
+}
@@ -2,13 +2,16 @@
 #define SCENE_OBJECT_H
 
 #include <array>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "../Data/SceneDefinition.h"
+#include "../Engine/RepulsorEngine.h"
 #include "../Utils/GlobalTypes.h"
+#include "../Utils/Helpers.h"
 
 class SceneObject {
   public:
@@ -34,8 +37,12 @@ class SceneObject {
     bool IsSimulated() const {
         return m_isSimulated;
     }
-    const std::vector<std::array<Real, amb_dim>>& GetInitialVertices() const;
-    const std::vector<std::array<Int, 3>>& GetSimplices() const;
+    // Local (base) vertices, viewed in place. Tensor-compatible storage, see GetLocalCoordinates.
+    Utils::VertexSpan GetInitialVertices() const;
+    const std::vector<std::array<Int, 3>>& GetSimplices() const;  // Shared with every instance of the mesh
+    const std::shared_ptr<const MeshTopology>& GetTopology() const {
+        return m_topology;
+    }
 
     // --- Getters/Setters for runtime state ---
     const glm::mat4& GetCurrentTransform() const {
@@ -50,10 +57,75 @@ class SceneObject {
     }
     void SetRepulsorMesh(std::unique_ptr<Mesh_T> mesh) {
         m_repulsorMesh = std::move(mesh);
+        m_obstacleMesh = nullptr;
+        m_selfEnergyCache.valid = false;
+    }
+
+    // Non-owning handle to the obstacle loaded into the Repulsor mesh, which owns it.
+    Mesh_T* GetObstacleMesh() const {
+        return m_obstacleMesh;
+    }
+    void SetObstacleMesh(Mesh_T* obstacle) {
+        m_obstacleMesh = obstacle;
+    }
+
+    Utils::SolverState& GetSolverState() {
+        return m_solverState;
+    }
+    const Utils::SolverState& GetSolverState() const {
+        return m_solverState;
+    }
+    void ResetSolverState() {  // Also restarts the optimizer history
+        m_solverState = Utils::SolverState();
+        m_physicsWorkspace.optimizer.Reset();
+    }
+
+    ClusterTreeState& GetClusterTreeState() {
+        return m_clusterTree;
+    }
+    const ClusterTreeState& GetClusterTreeState() const {
+        return m_clusterTree;
+    }
+
+    SelfEnergyCache& GetSelfEnergyCache() {
+        return m_selfEnergyCache;
+    }
+    const SelfEnergyCache& GetSelfEnergyCache() const {
+        return m_selfEnergyCache;
+    }
+
+    // Step buffers reused by every physics step, sized for the object's vertex count on construction
+    PhysicsWorkspace& GetPhysicsWorkspace() {
+        return m_physicsWorkspace;
+    }
+    const PhysicsWorkspace& GetPhysicsWorkspace() const {
+        return m_physicsWorkspace;
+    }
+
+    // --- Coordinate buffers ---
+    // Both are N x 3 row-major tensors owned by the object, so they can be handed to Repulsor or read back
+    // without intermediate containers.
+    const Tensors::Tensor2<Real, Int>& GetLocalCoordinates() const {
+        return m_localCoords;
+    }
+    // World coordinates as of the last SyncWorldCoordinates or ApplyWorldDisplacement.
+    const Tensors::Tensor2<Real, Int>& GetWorldCoordinates() const {
+        return m_worldCoords;
+    }
+    void SyncWorldCoordinates();  // Recomputes the world buffer from the local one and the current transform
+    // Incremented by every change to the local coordinates, so copies of them (obstacle blocks) can tell whether
+    // they are stale. A transform change does not count; compare the transform as well.
+    std::uint64_t GetCoordinateVersion() const {
+        return m_coordinateVersion;
     }
+    // Replaces the base vertices, e.g. with a recorded frame, and refreshes the world buffer. The vertex count must
+    // stay the same. Both this and ApplyWorldDisplacement invalidate the self energy cache and add the largest vertex
+    // movement to the cluster tree drift.
+    void SetLocalCoordinates(Utils::VertexSpan vertices);
 
-    // Method to update base vertices (used by physics step)
-    void UpdateInitialVertices(const std::vector<std::array<Real, amb_dim>>& local_deltas);
+    // Physics step: moves the base vertices by a world-space displacement and refreshes the world buffer,
+    // in one pass.
+    void ApplyWorldDisplacement(const Tensors::Tensor2<Real, Int>& worldDisplacement);
 
   private:
     // --- Static properties from definition ---
@@ -63,12 +135,19 @@ class SceneObject {
     bool m_isInteractive;
     bool m_isObstacleSource;
     bool m_isSimulated;
-    std::shared_ptr<MeshData> m_meshDataRef;
+    std::shared_ptr<const MeshTopology> m_topology;
 
     // --- Runtime state ---
     glm::mat4 m_currentTransform = glm::mat4(1.0f);
-    std::vector<std::array<Real, amb_dim>> m_initialVertices;  // THIS GETS MODIFIED BY PHYSICS
+    Tensors::Tensor2<Real, Int> m_localCoords;  // THIS GETS MODIFIED BY PHYSICS
+    Tensors::Tensor2<Real, Int> m_worldCoords;
+    std::uint64_t m_coordinateVersion = 0;
     std::unique_ptr<Mesh_T> m_repulsorMesh = nullptr;
+    Mesh_T* m_obstacleMesh = nullptr;
+    Utils::SolverState m_solverState;
+    PhysicsWorkspace m_physicsWorkspace;
+    SelfEnergyCache m_selfEnergyCache;  // Invalidated by every change to the local coordinates
+    ClusterTreeState m_clusterTree;     // Drift grows with every change to the local coordinates
 };
 
 #endif  // SCENE_OBJECT_H
\ No newline at end of file
@@ -0,0 +1,18 @@
+#include "UIHelpers.h"
+
+#include <imgui.h>
+
+namespace Utils {
+
+// --- UI Helpers ---
+void HelpMarker(const char* desc) {
+    ImGui::TextDisabled("(?)");
+    if (ImGui::BeginItemTooltip()) {
+        ImGui::PushTextWrapPos(ImGui::GetFontSize() * 35.0f);
+        ImGui::TextUnformatted(desc);
+        ImGui::PopTextWrapPos();
+        ImGui::EndTooltip();
+    }
+}
+
+}  // namespace Utils
@@ -0,0 +1,11 @@
+#ifndef UI_HELPERS_H
+#define UI_HELPERS_H
+
+namespace Utils {
+
+// --- UI Helpers ---
+void HelpMarker(const char* desc);
+
+}  // namespace Utils
+
+#endif  // UI_HELPERS_H
@@ -1,5 +1,6 @@
 #include "UIManager.h"
 
+#include <algorithm>
 #include <imgui.h>
 #include <polyscope/polyscope.h>  // For logging if needed
 
@@ -8,6 +9,8 @@
 #include "../Scene/SceneManager.h"
 #include "../Scene/SceneObject.h"
 #include "../Utils/Helpers.h"
+#include "../Utils/Profiler.h"
+#include "UIHelpers.h"
 
 UIManager::UIManager(ConfigType& config, SceneManager& sceneManager, Application& application)
     : m_config(config), m_sceneManager(sceneManager), m_application(application) {
@@ -24,8 +27,11 @@ void UIManager::DrawUI() {
     DrawInteractivityControls();
     DrawVectorVisualizationControls();
     DrawTPEControls();
+    DrawObstacleControls();
     DrawActionControls();
+    DrawRecordingControls();
     DrawDebugControls();
+    DrawPerformanceControls();
 
     ImGui::PopItemWidth();
 }
@@ -113,6 +119,10 @@ void UIManager::DrawVectorVisualizationControls() {
     }
     ImGui::SameLine();
     Utils::HelpMarker("Updates gradients while dragging. Very slow! Requires Real-time Differentials.");
+    ImGui::Checkbox("Background Evaluation", &m_config.Interactivity.asyncRealTime);
+    ImGui::SameLine();
+    Utils::HelpMarker("Computes real-time vectors on a background thread so dragging stays smooth. Arrows appear "
+                      "once ready; results for positions the object has already left are discarded.");
     ImGui::EndDisabled();
 
     // Scaling controls
@@ -153,6 +163,12 @@ void UIManager::DrawTPEControls() {
     ImGui::SameLine();
     Utils::HelpMarker("Tangent point energy exponent p.");
 
+    pq_changed |= ImGui::Checkbox("Self Energy", &m_config.TPE.includeSelfEnergy);
+    ImGui::SameLine();
+    Utils::HelpMarker("Adds each object's self-repulsion to its obstacle interaction. It is evaluated once per "
+                      "deformation and reused while an object is only moved or rotated. The shared scene obstacle "
+                      "always includes it, so turning this off also switches back to per-object obstacles.");
+
     if (pq_changed) {
         m_application.RequestRepulsorParamUpdate();
         // Note: RequestRepulsorParamUpdate might also trigger mesh param updates, which is fine.
@@ -186,13 +202,161 @@ void UIManager::DrawTPEControls() {
     mesh_params_changed |= ImGui::InputInt("Parallel Perc Depth", &m_config.TPE.parallelPercolationDepth);
     ImGui::SameLine();
     Utils::HelpMarker("Depth for parallel tree traversal.");
+    mesh_params_changed |= ImGui::InputInt("Thread Budget", &m_config.TPE.threadBudget);
+    ImGui::SameLine();
+    Utils::HelpMarker("Threads shared by object-level and per-mesh parallelism. 0 uses all hardware threads.");
     mesh_params_changed |= ImGui::InputInt("Thread Count", &m_config.TPE.threadCount);
     ImGui::SameLine();
-    Utils::HelpMarker("Number of threads for parallel processing.");
+    Utils::HelpMarker("Repulsor threads per mesh. 0 splits the budget by vertex count. "
+                      "Takes effect when the scene is reloaded.");
+    mesh_params_changed |= ImGui::InputInt("Object Threads", &m_config.TPE.objectThreadCount);
+    ImGui::SameLine();
+    Utils::HelpMarker("Objects processed in parallel. 0 takes them from the thread budget.");
+    mesh_params_changed |= ImGui::Checkbox("Pin Threads", &m_config.TPE.pinThreads);
+    ImGui::SameLine();
+    Utils::HelpMarker("Binds worker threads to CPUs, filling one NUMA node before the next. Linux only.");
+    const Utils::ThreadSplit& split = m_sceneManager.GetThreadSplit();
+    ImGui::TextDisabled("%d object(s) at once, up to %d mesh thread(s) each", split.objectWorkers, split.meshShare);
+
+    // Read on every physics step, no engine update required.
+    ImGui::InputDouble("Tree Rebuild Drift", &m_config.TPE.treeRebuildDrift, 0.05, 0.1, "%.2f");
+    ImGui::SameLine();
+    Utils::HelpMarker("Bounds how loose a cluster tree gets. Coordinate updates keep each tree's structure, which "
+                      "deformation loosens; moving or rotating an object does not. Once an object has deformed by "
+                      "this fraction of its size since its tree was built, the tree is rebuilt. 0 never rebuilds.");
+    long long refits = 0;
+    long long rebuilds = 0;
+    for (SceneObject* obj : m_sceneManager.GetSimulatedObjects()) {
+        refits += obj->GetClusterTreeState().refits;
+        rebuilds += obj->GetClusterTreeState().rebuilds;
+    }
+    ImGui::TextDisabled("Cluster trees: %lld refit(s), %lld rebuild(s); %lld obstacle rebuild(s)", refits, rebuilds,
+                        m_sceneManager.GetBroadPhaseStats().driftRebuilds);
 
     if (mesh_params_changed) {
         m_application.RequestRepulsorParamUpdate();
     }
+
+    DrawSolverControls();
+}
+
+void UIManager::DrawSolverControls() {
+    ImGui::Text("Metric Solver");
+
+    // Solver settings are read on every solve, no engine update required.
+    ImGui::Checkbox("Warm Start", &m_config.TPE.solverWarmStart);
+    ImGui::SameLine();
+    Utils::HelpMarker("Starts each metric solve from the object's previous gradient.");
+    ImGui::Checkbox("Adaptive Tolerance", &m_config.TPE.solverAdaptiveTolerance);
+    ImGui::SameLine();
+    Utils::HelpMarker("Loose tolerance far from convergence, tightening as the differential shrinks. "
+                      "When disabled, the minimum tolerance is always used.");
+    ImGui::InputDouble("Min Tolerance", &m_config.TPE.solverToleranceMin, 0.0, 0.0, "%.1e");
+    ImGui::SameLine();
+    Utils::HelpMarker("Tightest relative tolerance, reached near convergence.");
+    ImGui::BeginDisabled(!m_config.TPE.solverAdaptiveTolerance);
+    ImGui::InputDouble("Max Tolerance", &m_config.TPE.solverToleranceMax, 0.0, 0.0, "%.1e");
+    ImGui::SameLine();
+    Utils::HelpMarker("Loosest relative tolerance, used at the start of an optimization.");
+    ImGui::EndDisabled();
+    if (ImGui::InputInt("Max Iterations", &m_config.TPE.solverMaxIterations) &&
+        m_config.TPE.solverMaxIterations < 1) {
+        m_config.TPE.solverMaxIterations = 1;
+    }
+    ImGui::SameLine();
+    Utils::HelpMarker("Iteration cap for each metric solve.");
+
+    if (ImGui::TreeNode("Solver Statistics")) {
+        Utils::HelpMarker("Warm Residual is the initial guess's residual relative to the differential; 1 means a cold "
+                          "start. Repulsor does not expose the exact CG count, so solves that ran are shown against "
+                          "their iteration cap; 0 means the warm start already met the tolerance. Self Energy "
+                          "counts self terms reused from the cache against those evaluated.");
+        if (ImGui::BeginTable("SolverStats", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Object");
+            ImGui::TableSetupColumn("Solves");
+            ImGui::TableSetupColumn("Tolerance");
+            ImGui::TableSetupColumn("Warm Residual");
+            ImGui::TableSetupColumn("Iterations");
+            ImGui::TableSetupColumn("Self Energy");
+            ImGui::TableHeadersRow();
+            auto drawRow = [](const char* name, const Utils::SolverState& state, const SelfEnergyCache* self) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(name);
+                ImGui::TableNextColumn();
+                ImGui::Text("%lld", state.solveCount);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1e", state.lastTolerance);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2e", state.lastWarmStartResidual);
+                ImGui::TableNextColumn();
+                if (state.lastSkipped) {
+                    ImGui::Text("0");
+                } else {
+                    ImGui::Text("<= %d", state.lastIterationCap);
+                }
+                ImGui::TableNextColumn();
+                if (self) {
+                    ImGui::Text("%lld / %lld", self->reuses, self->evaluations);
+                } else {
+                    ImGui::TextDisabled("-");
+                }
+            };
+            if (m_application.IsAsyncEvaluationRunning()) {
+                // The background evaluation is writing the solver states; show them once it is done.
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextDisabled("Updating...");
+            } else if (m_sceneManager.IsSharedObstacleActive()) {
+                drawRow("Scene (shared)", m_sceneManager.GetSharedSolverState(), nullptr);
+            } else {
+                for (SceneObject* obj : m_sceneManager.GetSimulatedObjects()) {
+                    drawRow(obj->GetUniqueName().c_str(), obj->GetSolverState(),
+                            m_config.TPE.includeSelfEnergy ? &obj->GetSelfEnergyCache() : nullptr);
+                }
+            }
+            ImGui::EndTable();
+        }
+        ImGui::TreePop();
+    }
+}
+
+void UIManager::DrawObstacleControls() {
+    ImGui::Separator();
+    ImGui::Text("Obstacles");
+    // Turning it on needs a reload; turning it off switches the loaded scene back to per-object obstacles
+    if (ImGui::Checkbox("Shared Scene Obstacle", &m_config.Obstacles.sharedSceneObstacle) &&
+        m_sceneManager.IsSharedObstacleActive()) {
+        m_application.RequestObstacleUpdate();
+    }
+    ImGui::SameLine();
+    Utils::HelpMarker("Builds one mesh over all objects instead of a separate obstacle per object. Memory grows "
+                      "linearly with the scene and the obstacle is updated once per step. The scene is evaluated as a "
+                      "whole, so each object also repels itself; it is therefore only used with Self Energy on. Only "
+                      "for scenes where every object repels all others; applied when an example is (re)loaded.");
+
+    bool culling_changed = ImGui::Checkbox("Distance Culling", &m_config.Obstacles.distanceCulling);
+    ImGui::SameLine();
+    Utils::HelpMarker("Only objects whose bounding boxes are within the interaction radius become part of an "
+                      "object's obstacle. Not used by the shared scene obstacle.");
+    ImGui::BeginDisabled(!m_config.Obstacles.distanceCulling);
+    culling_changed |=
+        ImGui::InputDouble("Interaction Radius", &m_config.Obstacles.interactionRadius, 0.1, 1.0, "%.2f");
+    ImGui::SameLine();
+    Utils::HelpMarker("Maximum gap between bounding boxes. Kept sources are dropped at 1.25x this distance.");
+    ImGui::EndDisabled();
+
+    if (culling_changed) {
+        m_application.RequestObstacleUpdate();
+    }
+
+    if (!m_sceneManager.IsSharedObstacleActive()) {
+        const Utils::BroadPhaseStats& stats = m_sceneManager.GetBroadPhaseStats();
+        ImGui::Text("Sources kept: %d, culled: %d", stats.keptSources, stats.culledSources);
+        ImGui::Text("Obstacle rebuilds: %lld", stats.layoutRebuilds);
+        ImGui::Text("Source blocks rewritten: %lld, unchanged: %lld", stats.sourcesRewritten, stats.sourcesUnchanged);
+        ImGui::Text("Obstacles left unchanged: %lld", stats.obstaclesUnchanged);
+    }
 }
 
 void UIManager::UpdateRepulsorParams() {
@@ -212,6 +376,77 @@ void UIManager::DrawActionControls() {
     ImGui::SameLine();
     Utils::HelpMarker("Displaces mesh coordinates in the direction minimizing the tangent point energy.");
 
+    // Read on every physics step, no engine update required.
+    const char* optimizerNames[] = {"Gradient Descent", "L-BFGS", "Nesterov"};
+    int optimizer = static_cast<int>(m_config.Opt.optimizer);
+    if (ImGui::Combo("Optimizer", &optimizer, optimizerNames, IM_ARRAYSIZE(optimizerNames))) {
+        m_config.Opt.optimizer = static_cast<OptimizerType>(optimizer);
+    }
+    ImGui::SameLine();
+    Utils::HelpMarker("Step rule of Update Mesh. L-BFGS builds a quasi-Newton step from the last steps, starting "
+                      "from the tangent-point metric. Nesterov adds accelerated momentum to the gradient step. Both "
+                      "take a plain gradient step whenever the safe step size would shorten theirs.");
+    if (m_config.Opt.optimizer == OptimizerType::LBFGS) {
+        ImGui::InputInt("L-BFGS History", &m_config.Opt.lbfgsHistory);
+        ImGui::SameLine();
+        Utils::HelpMarker("Number of previous steps the quasi-Newton approximation is built from.");
+        m_config.Opt.lbfgsHistory = std::clamp(m_config.Opt.lbfgsHistory, 1, 64);
+    } else if (m_config.Opt.optimizer == OptimizerType::Nesterov) {
+        ImGui::InputDouble("Momentum", &m_config.Opt.momentum, 0.05, 0.1, "%.2f");
+        ImGui::SameLine();
+        Utils::HelpMarker("Fraction of the previous step carried into the next. Momentum that points uphill is "
+                          "dropped.");
+        m_config.Opt.momentum = std::clamp(m_config.Opt.momentum, 0.0, 0.99);
+    }
+    if (m_config.Opt.optimizer != OptimizerType::GradientDescent) {
+        long long steps = 0;
+        long long fallbacks = 0;
+        auto add = [&](const OptimizerState& state) {
+            steps += state.steps;
+            fallbacks += state.fallbacks;
+        };
+        if (const PhysicsWorkspace* scene = m_sceneManager.GetScenePhysicsWorkspace()) {
+            add(scene->optimizer);
+        } else {
+            for (SceneObject* obj : m_sceneManager.GetSimulatedObjects()) {
+                add(obj->GetPhysicsWorkspace().optimizer);
+            }
+        }
+        ImGui::TextDisabled("%lld of %lld step(s) fell back to the gradient", fallbacks, steps);
+    }
+
+    ImGui::Checkbox("Line Search", &m_config.Opt.lineSearch);
+    ImGui::SameLine();
+    Utils::HelpMarker("Chooses each step's length by backtracking until the energy decreases enough (Armijo), "
+                      "instead of taking the largest safe step. Each trial costs one energy evaluation.");
+    if (m_config.Opt.lineSearch && ImGui::TreeNode("Line Search Parameters")) {
+        ImGui::InputDouble("Max Step", &m_config.Opt.lineSearchMaxStep, 0.5, 1.0, "%.2f");
+        ImGui::SameLine();
+        Utils::HelpMarker("Upper bound on the step; the safe step size may lower it further.");
+        ImGui::InputDouble("Growth", &m_config.Opt.lineSearchGrowth, 0.1, 0.5, "%.2f");
+        ImGui::SameLine();
+        Utils::HelpMarker("Each search starts at the object's last accepted step times this.");
+        ImGui::InputDouble("Shrink", &m_config.Opt.lineSearchShrink, 0.05, 0.1, "%.2f");
+        ImGui::SameLine();
+        Utils::HelpMarker("Factor applied to the step after each rejected trial.");
+        ImGui::InputDouble("Armijo Constant", &m_config.Opt.armijoConstant, 1e-4, 1e-3, "%.0e");
+        ImGui::SameLine();
+        Utils::HelpMarker("Fraction of the predicted decrease a trial must achieve.");
+        ImGui::InputInt("Max Trials", &m_config.Opt.lineSearchMaxTrials);
+        m_config.Opt.lineSearchMaxStep = std::max(m_config.Opt.lineSearchMaxStep, 0.0);
+        m_config.Opt.lineSearchGrowth = std::max(m_config.Opt.lineSearchGrowth, 1.0);
+        m_config.Opt.lineSearchShrink = std::clamp(m_config.Opt.lineSearchShrink, 0.05, 0.95);
+        m_config.Opt.armijoConstant = std::clamp(m_config.Opt.armijoConstant, 0.0, 0.5);
+        m_config.Opt.lineSearchMaxTrials = std::max(m_config.Opt.lineSearchMaxTrials, 1);
+        ImGui::TreePop();
+    }
+    const LineSearchSummary& search = m_sceneManager.GetLastLineSearch();
+    if (m_config.Opt.lineSearch && search.searches > 0) {
+        ImGui::TextDisabled("Last step: %d/%d accepted, step %.3g to %.3g, %d trial(s)", search.accepted,
+                            search.searches, search.minStep, search.maxStep, search.trials);
+        ImGui::TextDisabled("Energy %.6g -> %.6g", search.energyBefore, search.energyAfter);
+    }
+
     if (ImGui::Button("Print Energy")) {
         m_application.RequestPrintEnergy();
     }
@@ -230,6 +465,96 @@ void UIManager::DrawActionControls() {
     ImGui::SameLine();
     Utils::HelpMarker("Calculates the energy gradient vectors. Creates and/or updates visuals. If "
                       "differentials are invalid, calculates them beforehand.");
+
+    ImGui::Text("Completed steps: %llu", m_sceneManager.GetCompletedSteps());
+    ImGui::BeginDisabled(m_application.IsCheckpointSaving());
+    if (ImGui::Button("Save Checkpoint")) {
+        m_application.RequestCheckpointSave();
+    }
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    if (ImGui::Button("Restore Checkpoint")) {
+        m_application.RequestCheckpointRestore();
+    }
+    ImGui::SameLine();
+    Utils::HelpMarker(("Saves the vertices and transforms of every object, the settings and the step count to " +
+                       m_config.Checkpoint.path + " without pausing, or resumes from that file.")
+                          .c_str());
+    if (ImGui::InputInt("Autosave every", &m_config.Checkpoint.autosaveSteps) &&
+        m_config.Checkpoint.autosaveSteps < 0) {
+        m_config.Checkpoint.autosaveSteps = 0;
+    }
+    ImGui::SameLine();
+    Utils::HelpMarker("Saves a checkpoint after every this many physics steps. 0 turns autosaving off.");
+}
+
+void UIManager::DrawRecordingControls() {
+    ImGui::Separator();
+    ImGui::Text("Recording");
+    const IO::TrajectoryRecorder* recorder = m_application.GetRecorder();
+    const IO::TrajectoryReader* player = m_application.GetPlayer();
+
+    if (recorder) {
+        if (ImGui::Button("Stop Recording")) {
+            m_application.RequestRecordingStop();
+        }
+    } else {
+        ImGui::BeginDisabled(player != nullptr);
+        if (ImGui::Button("Start Recording")) {
+            m_application.RequestRecordingStart();
+        }
+        ImGui::EndDisabled();
+    }
+    ImGui::SameLine();
+    Utils::HelpMarker(("Writes the vertices and transforms of every following physics step to " +
+                       m_config.Recording.path +
+                       ". A background thread writes the file; if it falls behind, frames are dropped rather than "
+                       "holding the simulation back.")
+                          .c_str());
+    ImGui::BeginDisabled(recorder != nullptr);
+    ImGui::Checkbox("Record Vector Fields", &m_config.Recording.recordFields);
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    Utils::HelpMarker("Also stores the differential and gradient of every recorded step. They are evaluated for "
+                      "each step, which slows stepping down.");
+    if (recorder) {
+        ImGui::Text("Frames: %llu (%llu dropped), %.1f MiB",
+                    static_cast<unsigned long long>(recorder->GetRecordedFrames()),
+                    static_cast<unsigned long long>(recorder->GetDroppedFrames()),
+                    static_cast<double>(recorder->GetBytesWritten()) / (1024.0 * 1024.0));
+    }
+
+    if (!player) {
+        ImGui::BeginDisabled(recorder != nullptr);
+        if (ImGui::Button("Open Playback")) {
+            m_application.RequestPlaybackOpen();
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        Utils::HelpMarker(("Shows the frames recorded in " + m_config.Recording.path +
+                           " on the loaded scene, without evaluating the energy.")
+                              .c_str());
+        return;
+    }
+
+    const bool playing = m_application.IsPlaybackPlaying();
+    if (ImGui::Button(playing ? "Pause" : "Play")) {
+        m_application.SetPlaybackPlaying(!playing);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Close Playback")) {
+        m_application.RequestPlaybackClose();
+        return;
+    }
+    ImGui::SameLine();
+    Utils::HelpMarker("Closing playback, or updating the mesh, resumes the simulation from the frame shown.");
+
+    int frame = static_cast<int>(m_application.GetPlaybackFrame());
+    if (ImGui::SliderInt("Frame", &frame, 0, static_cast<int>(player->GetFrameCount()) - 1)) {
+        m_application.RequestPlaybackSeek(frame);
+    }
+    ImGui::Text("Step: %llu", static_cast<unsigned long long>(player->GetStep(m_application.GetPlaybackFrame())));
+    ImGui::SliderFloat("Playback FPS", &m_config.Recording.playbackFps, 1.0f, 120.0f);
 }
 
 void UIManager::DrawDebugControls() {
@@ -282,3 +607,100 @@ void UIManager::DrawDebugControls() {
     ImGui::SameLine();
     Utils::HelpMarker("Prints the current camera position to the console.");
 }
+
+void UIManager::DrawPerformanceControls() {
+    ImGui::Separator();
+    ImGui::Text("Performance");
+#ifdef TPE_PROFILING
+    if (ImGui::Checkbox("Collect Timings", &m_config.Debug.profiling)) {
+        Profiler::setEnabled(m_config.Debug.profiling);
+    }
+    ImGui::SameLine();
+    Utils::HelpMarker("Times the hot paths every frame. Statistics cover the last 120 frames in which each zone ran; "
+                      "times are per-frame totals, summed over objects and threads.");
+    ImGui::SameLine();
+    if (ImGui::Button("Reset##Profiler")) {
+        Profiler::reset();
+    }
+
+    if (!Profiler::isTracing()) {
+        if (ImGui::Button("Start Trace")) {
+            Profiler::beginTrace();
+        }
+    } else if (ImGui::Button("Stop and Save Trace")) {
+        std::string error;
+        if (Profiler::writeTrace(m_config.Debug.traceFile, error)) {
+            polyscope::info("Profiler: Trace written to " + m_config.Debug.traceFile);
+        } else {
+            polyscope::error("Profiler: " + error);
+        }
+    }
+    ImGui::SameLine();
+    Utils::HelpMarker(("Records every timed call and writes a Chrome trace to " + m_config.Debug.traceFile +
+                       ". Open it in chrome://tracing or ui.perfetto.dev.")
+                          .c_str());
+
+    if (ImGui::TreeNode("Hot Paths")) {
+        if (ImGui::BeginTable("ProfilerZones", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Zone");
+            ImGui::TableSetupColumn("Last ms (calls)");
+            ImGui::TableSetupColumn("Mean");
+            ImGui::TableSetupColumn("p50");
+            ImGui::TableSetupColumn("p95");
+            ImGui::TableSetupColumn("Max");
+            ImGui::TableHeadersRow();
+            for (const Profiler::ZoneStats& zone : Profiler::zoneStats()) {
+                if (zone.frames == 0) {
+                    continue;
+                }
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(Profiler::zoneName(zone.zone));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f (%d)", zone.lastMs, zone.lastCalls);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", zone.meanMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", zone.p50Ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", zone.p95Ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", zone.maxMs);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("Per Object")) {
+        Utils::HelpMarker("Mean ms per frame. Evaluation is Energy + Differential + Solve + MaximumSafeStepSize. "
+                          "The shared scene obstacle is evaluated as a whole and not attributed to objects.");
+        if (ImGui::BeginTable("ProfilerObjects", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Object");
+            ImGui::TableSetupColumn("Evaluation");
+            ImGui::TableSetupColumn("Mesh Update");
+            ImGui::TableSetupColumn("Visualization");
+            ImGui::TableHeadersRow();
+            for (const Profiler::ObjectStats& object : Profiler::objectStats()) {
+                SceneObject* sceneObject = m_sceneManager.GetObjectById(object.objectId);
+                if (!sceneObject) {
+                    continue;  // From an unloaded scene
+                }
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(sceneObject->GetUniqueName().c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", object.evaluationMeanMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", object.meanMs[static_cast<size_t>(Profiler::Zone::UpdateMeshState)]);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", object.meanMs[static_cast<size_t>(Profiler::Zone::VisualizationUpdate)]);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::TreePop();
+    }
+#else
+    ImGui::TextDisabled("Built without profiling (TPE_ENABLE_PROFILING=OFF).");
+#endif
+}
@@ -23,8 +23,12 @@ class UIManager {
     void DrawInteractivityControls();
     void DrawVectorVisualizationControls();
     void DrawTPEControls();
+    void DrawSolverControls();
+    void DrawObstacleControls();
     void DrawActionControls();
+    void DrawRecordingControls();
     void DrawDebugControls();
+    void DrawPerformanceControls();
 
     void UpdateRepulsorParams();
 
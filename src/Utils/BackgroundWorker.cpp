@@ -0,0 +1,64 @@
+#include "BackgroundWorker.h"
+
+namespace Utils {
+
+BackgroundWorker::BackgroundWorker() : m_thread(&BackgroundWorker::Loop, this) {
+}
+
+BackgroundWorker::~BackgroundWorker() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool BackgroundWorker::Submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_busy || m_stopping) {
+            return false;
+        }
+        m_job = std::move(job);
+        m_busy = true;
+    }
+    m_wakeCondition.notify_one();
+    return true;
+}
+
+bool BackgroundWorker::IsBusy() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_busy;
+}
+
+void BackgroundWorker::Wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return !m_busy; });
+}
+
+void BackgroundWorker::Loop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCondition.wait(lock, [this] { return m_stopping || m_busy; });
+            if (m_stopping && !m_busy) {
+                return;
+            }
+            job = std::move(m_job);
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy = false;
+        }
+        m_idleCondition.notify_all();
+    }
+}
+
+}  // namespace Utils
@@ -0,0 +1,42 @@
+#ifndef BACKGROUND_WORKER_H
+#define BACKGROUND_WORKER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Utils {
+
+// Single background thread running one job at a time. The owner submits only while idle and
+// polls IsBusy() to learn when a job's results may be read.
+class BackgroundWorker {
+  public:
+    using Job = std::function<void()>;
+
+    BackgroundWorker();
+    ~BackgroundWorker();
+
+    BackgroundWorker(const BackgroundWorker&) = delete;
+    BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+
+    // Returns false (and drops the job) if a job is still running. Jobs must not throw.
+    bool Submit(Job job);
+    bool IsBusy() const;
+    void Wait();  // Blocks until the current job, if any, has finished
+
+  private:
+    void Loop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_idleCondition;
+    Job m_job;
+    bool m_busy = false;
+    bool m_stopping = false;
+    std::thread m_thread;  // Declared last so the state above exists before the thread starts
+};
+
+}  // namespace Utils
+
+#endif  // BACKGROUND_WORKER_H
@@ -0,0 +1,129 @@
+#include "BroadPhase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "TransformKernels.h"
+
+namespace Utils {
+
+Aabb computeWorldAabb(std::span<const std::array<Real, amb_dim>> localVerts, const glm::mat4& transform) {
+    Aabb local;
+    if (localVerts.empty()) {
+        return local;
+    }
+    local.min = localVerts[0];
+    local.max = localVerts[0];
+    for (const auto& v : localVerts) {
+        for (int d = 0; d < amb_dim; ++d) {
+            local.min[d] = std::min(local.min[d], v[d]);
+            local.max[d] = std::max(local.max[d], v[d]);
+        }
+    }
+
+    // Corners stay in double precision, so a source right at the culling radius is not decided by float rounding
+    std::array<std::array<Real, amb_dim>, 8> corners;
+    for (int corner = 0; corner < 8; ++corner) {
+        for (int d = 0; d < amb_dim; ++d) {
+            corners[corner][d] = (corner & (1 << d)) ? local.max[d] : local.min[d];
+        }
+    }
+    transformPoints(AffineTransform::FromMat4(transform), corners[0].data(), corners[0].data(), corners.size());
+
+    Aabb world;
+    world.min.fill(std::numeric_limits<Real>::max());
+    world.max.fill(std::numeric_limits<Real>::lowest());
+    for (const auto& w : corners) {
+        for (int d = 0; d < amb_dim; ++d) {
+            world.min[d] = std::min(world.min[d], w[d]);
+            world.max[d] = std::max(world.max[d], w[d]);
+        }
+    }
+    return world;
+}
+
+Real aabbDistance(const Aabb& a, const Aabb& b) {
+    Real sq = 0.0;
+    for (int d = 0; d < amb_dim; ++d) {
+        const Real gap = std::max({0.0, a.min[d] - b.max[d], b.min[d] - a.max[d]});
+        sq += gap * gap;
+    }
+    return std::sqrt(sq);
+}
+
+Real aabbMaxExtent(const Aabb& box) {
+    return std::max({box.max[0] - box.min[0], box.max[1] - box.min[1], box.max[2] - box.min[2]});
+}
+
+void UniformGrid::Build(std::span<const Aabb> boxes, Real cellSize) {
+    m_boxes.assign(boxes.begin(), boxes.end());
+    m_cells.clear();
+    m_cellSize = cellSize > 0.0 ? cellSize : 1.0;
+
+    for (int i = 0; i < static_cast<int>(m_boxes.size()); ++i) {
+        const CellCoord lo = CellOf(m_boxes[i].min);
+        const CellCoord hi = CellOf(m_boxes[i].max);
+        for (long long x = lo[0]; x <= hi[0]; ++x) {
+            for (long long y = lo[1]; y <= hi[1]; ++y) {
+                for (long long z = lo[2]; z <= hi[2]; ++z) {
+                    m_cells.emplace_back(CellKey({x, y, z}), i);
+                }
+            }
+        }
+    }
+    std::sort(m_cells.begin(), m_cells.end());
+}
+
+void UniformGrid::Query(const Aabb& query, Real radius, std::vector<int>& out) const {
+    out.clear();
+    Aabb grown = query;
+    for (int d = 0; d < amb_dim; ++d) {
+        grown.min[d] -= radius;
+        grown.max[d] += radius;
+    }
+
+    const CellCoord lo = CellOf(grown.min);
+    const CellCoord hi = CellOf(grown.max);
+    const double cellCount = double(hi[0] - lo[0] + 1) * double(hi[1] - lo[1] + 1) * double(hi[2] - lo[2] + 1);
+
+    if (cellCount > static_cast<double>(m_boxes.size())) {
+        // The query covers more cells than there are boxes; testing every box is cheaper.
+        for (int i = 0; i < static_cast<int>(m_boxes.size()); ++i) {
+            out.push_back(i);
+        }
+    } else {
+        for (long long x = lo[0]; x <= hi[0]; ++x) {
+            for (long long y = lo[1]; y <= hi[1]; ++y) {
+                for (long long z = lo[2]; z <= hi[2]; ++z) {
+                    const long long key = CellKey({x, y, z});
+                    auto it = std::lower_bound(m_cells.begin(), m_cells.end(), std::make_pair(key, 0),
+                                               [](const auto& a, const auto& b) { return a.first < b.first; });
+                    for (; it != m_cells.end() && it->first == key; ++it) {
+                        out.push_back(it->second);
+                    }
+                }
+            }
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    out.erase(std::remove_if(out.begin(), out.end(),
+                             [&](int i) { return aabbDistance(query, m_boxes[i]) > radius; }),
+              out.end());
+}
+
+UniformGrid::CellCoord UniformGrid::CellOf(const std::array<Real, amb_dim>& p) const {
+    CellCoord c;
+    for (int d = 0; d < amb_dim; ++d) {
+        c[d] = static_cast<long long>(std::floor(p[d] / m_cellSize));
+    }
+    return c;
+}
+
+long long UniformGrid::CellKey(const CellCoord& c) {
+    return (c[0] * 73856093LL) ^ (c[1] * 19349663LL) ^ (c[2] * 83492791LL);
+}
+
+}  // namespace Utils
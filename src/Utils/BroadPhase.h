@@ -0,0 +1,63 @@
+#ifndef BROAD_PHASE_H
+#define BROAD_PHASE_H
+
+#include <array>
+#include <glm/glm.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "GlobalTypes.h"
+
+namespace Utils {
+
+// --- Bounding Boxes ---
+struct Aabb {
+    std::array<Real, amb_dim> min{0.0, 0.0, 0.0};
+    std::array<Real, amb_dim> max{0.0, 0.0, 0.0};
+};
+
+// Conservative world box: the local box of the vertices with its eight corners transformed.
+Aabb computeWorldAabb(std::span<const std::array<Real, amb_dim>> localVerts, const glm::mat4& transform);
+Real aabbDistance(const Aabb& a, const Aabb& b);  // Gap between the boxes, 0 if they overlap
+Real aabbMaxExtent(const Aabb& box);
+
+// --- Uniform Grid ---
+// Object-level broad phase. Each box is binned into every cell it overlaps; queries visit the cells
+// covered by the query box grown by the radius and return exact box-distance matches.
+// Storage is kept across Build calls, so rebuilding a grid of similar size does not allocate.
+class UniformGrid {
+  public:
+    void Build(std::span<const Aabb> boxes, Real cellSize);
+
+    // Indices of boxes whose gap to `query` is at most `radius`, ascending. `out` is overwritten.
+    void Query(const Aabb& query, Real radius, std::vector<int>& out) const;
+
+  private:
+    using CellCoord = std::array<long long, amb_dim>;
+    CellCoord CellOf(const std::array<Real, amb_dim>& p) const;
+    static long long CellKey(const CellCoord& c);
+
+    std::vector<Aabb> m_boxes;
+    // (hashed cell, box index) pairs sorted by cell. Hash collisions only add candidates, which the distance
+    // test removes.
+    std::vector<std::pair<long long, int>> m_cells;
+    Real m_cellSize = 1.0;
+};
+
+// --- Culling Statistics ---
+struct BroadPhaseStats {
+    int keptSources = 0;    // Obstacle sources in use, summed over all targets
+    int culledSources = 0;  // Sources allowed by the scene definition but out of range
+    long long layoutRebuilds = 0;
+    // Obstacle coordinate updates, cumulative: source blocks rewritten or skipped because the source neither moved
+    // nor deformed, and obstacles left as they were because none of their sources changed
+    long long sourcesRewritten = 0;
+    long long sourcesUnchanged = 0;
+    long long obstaclesUnchanged = 0;
+    long long driftRebuilds = 0;  // Obstacle meshes rebuilt because a source drifted too far to refit them
+};
+
+}  // namespace Utils
+
+#endif  // BROAD_PHASE_H
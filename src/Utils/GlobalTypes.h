@@ -17,6 +17,7 @@ using Mesh_T = Repulsor::SimplicialMeshBase<Real, Int, LInt>;
 using Energy_T = Repulsor::EnergyBase<Mesh_T>;
 using Metric_T = Repulsor::MetricBase<Mesh_T>;
 using TPE_Factory_T = Repulsor::TangentPointObstacleEnergy_Factory<Mesh_T, 2, 2, 2, 2, 3, 3>;
+using TPSE_Factory_T = Repulsor::TangentPointEnergy_Factory<Mesh_T, 2, 2, 3, 3>;
 using TPM_Factory_T = Repulsor::TangentPointMetric0_Factory<Mesh_T, 2, 2, 3, 3>;
 
 // Dimensions
@@ -1,27 +1,31 @@
 #include "Helpers.h"
 
-#include <imgui.h>
-
+#include <algorithm>
 #include <cmath>
 #include <glm/gtc/type_ptr.hpp>
 #include <limits>
 #include <stdexcept>
 
+#include "Profiler.h"
+#include "TransformKernels.h"
+
 namespace Utils {
 
 // --- Geometry / Math ---
-std::vector<std::array<Real, amb_dim>> applyTransform(const std::vector<std::array<Real, amb_dim>>& originalVerts,
-                                                      const glm::mat4& transform) {
-    std::vector<std::array<Real, amb_dim>> transformedVerts;
-    transformedVerts.reserve(originalVerts.size());
-    for (const auto& v_orig_arr : originalVerts) {
-        glm::vec4 v_orig = {(float)v_orig_arr[0], (float)v_orig_arr[1], (float)v_orig_arr[2], 1.0f};
-        glm::vec4 v_transformed = transform * v_orig;
-        transformedVerts.push_back({(Real)v_transformed.x, (Real)v_transformed.y, (Real)v_transformed.z});
-    }
+std::vector<std::array<Real, amb_dim>> applyTransform(VertexSpan originalVerts, const glm::mat4& transform) {
+    std::vector<std::array<Real, amb_dim>> transformedVerts(originalVerts.size());
+    applyTransformInto(originalVerts, transform, transformedVerts.data());
     return transformedVerts;
 }
 
+void applyTransformInto(VertexSpan originalVerts, const glm::mat4& transform, std::array<Real, amb_dim>* out) {
+    if (originalVerts.empty()) {
+        return;
+    }
+    TPE_PROFILE_SCOPE(ApplyTransform);
+    transformPoints(AffineTransform::FromMat4(transform), originalVerts[0].data(), out[0].data(), originalVerts.size());
+}
+
 bool matricesAreClose(const glm::mat4& m1, const glm::mat4& m2, float epsilon) {
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 4; ++j) {
@@ -50,6 +54,15 @@ std::vector<std::array<Real, amb_dim>> tensorToVecArray(const Tensors::Tensor2<R
     return vec;
 }
 
+VertexSpan tensorRows(const Tensors::Tensor2<Real, Int>& tensor) {
+    if (tensor.Dimension(1) != amb_dim) {
+        throw std::runtime_error("tensorRows: Tensor column count " + std::to_string(tensor.Dimension(1)) +
+                                 " does not match ambient dimension " + std::to_string(amb_dim));
+    }
+    return VertexSpan(reinterpret_cast<const std::array<Real, amb_dim>*>(tensor.data()),
+                      static_cast<size_t>(tensor.Dimension(0)));
+}
+
 Tensors::Tensor2<Real, Int> vecArrayToTensor(const std::vector<std::array<Real, amb_dim>>& vecArray) {
     Int nRows = static_cast<Int>(vecArray.size());
     Tensors::Tensor2<Real, Int> tensor(nRows, amb_dim);
@@ -61,6 +74,40 @@ Tensors::Tensor2<Real, Int> vecArrayToTensor(const std::vector<std::array<Real,
     return tensor;
 }
 
+void ensureShape(Tensors::Tensor2<Real, Int>& tensor, Int rows, Int cols) {
+    if (tensor.Dimension(0) != rows || tensor.Dimension(1) != cols) {
+        tensor = Tensors::Tensor2<Real, Int>(rows, cols);
+    }
+}
+
+void copyInto(Tensors::Tensor2<Real, Int>& dst, const Real* src, Int rows, Int cols) {
+    ensureShape(dst, rows, cols);
+    if (rows > 0 && cols > 0) {
+        std::copy_n(src, static_cast<size_t>(rows) * static_cast<size_t>(cols), dst.data());
+    }
+}
+
+void copyInto(Tensors::Tensor2<Real, Int>& dst, const Tensors::Tensor2<Real, Int>& src) {
+    if (&dst != &src) {
+        copyInto(dst, src.data(), src.Dimension(0), src.Dimension(1));
+    }
+}
+
+Real maxRowNorm(const Tensors::Tensor2<Real, Int>& tensor) {
+    const Int rows = tensor.Dimension(0);
+    const Int cols = tensor.Dimension(1);
+    const Real* data = tensor.data();
+    Real maxSquared = 0.0;
+    for (Int i = 0; i < rows; ++i) {
+        Real squared = 0.0;
+        for (Int j = 0; j < cols; ++j) {
+            squared += data[i * cols + j] * data[i * cols + j];
+        }
+        maxSquared = std::max(maxSquared, squared);
+    }
+    return std::sqrt(maxSquared);
+}
+
 std::vector<glm::vec3> tensorToGlmVec3(const Tensors::Tensor2<Real, Int>& T) {
     int n = T.Dimension(0);
     int m = T.Dimension(1);
@@ -123,15 +170,4 @@ std::vector<glm::vec3> scaleVectorsForVisualization(const std::vector<glm::vec3>
     return scaledVectors;
 }
 
-// --- UI Helpers ---
-void HelpMarker(const char* desc) {
-    ImGui::TextDisabled("(?)");
-    if (ImGui::BeginItemTooltip()) {
-        ImGui::PushTextWrapPos(ImGui::GetFontSize() * 35.0f);
-        ImGui::TextUnformatted(desc);
-        ImGui::PopTextWrapPos();
-        ImGui::EndTooltip();
-    }
-}
-
 }  // namespace Utils
\ No newline at end of file
@@ -2,29 +2,41 @@
 #define HELPERS_H
 
 #include <array>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <glm/gtc/epsilon.hpp>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "GlobalTypes.h"
 #include "Repulsor/submodules/Tensors/Tensors.hpp"
 
-namespace polyscope {
-class Structure;
-}
-
 namespace Utils {
 
+// Read-only view of xyz-interleaved vertices. Vertex vectors and row-major N x 3 coordinate tensors share this layout.
+using VertexSpan = std::span<const std::array<Real, amb_dim>>;
+static_assert(sizeof(std::array<Real, amb_dim>) == amb_dim * sizeof(Real), "Vertices must be tightly packed");
+
 // --- Geometry / Math ---
-std::vector<std::array<Real, amb_dim>> applyTransform(const std::vector<std::array<Real, amb_dim>>& originalVerts,
-                                                      const glm::mat4& transform);
+std::vector<std::array<Real, amb_dim>> applyTransform(VertexSpan originalVerts, const glm::mat4& transform);
+// Same as applyTransform, but writes into a caller-owned buffer of originalVerts.size() entries.
+// Both run the double-precision batch kernel from TransformKernels.h.
+void applyTransformInto(VertexSpan originalVerts, const glm::mat4& transform, std::array<Real, amb_dim>* out);
 
 bool matricesAreClose(const glm::mat4& m1, const glm::mat4& m2, float epsilon = 1e-6f);
 
 // --- Tensor Conversions ---
 std::vector<std::array<Real, amb_dim>> tensorToVecArray(const Tensors::Tensor2<Real, Int>& tensor);
+// Rows of an N x amb_dim coordinate tensor as vertices, without copying. Valid while the tensor is alive.
+VertexSpan tensorRows(const Tensors::Tensor2<Real, Int>& tensor);
 Tensors::Tensor2<Real, Int> vecArrayToTensor(const std::vector<std::array<Real, amb_dim>>& vecArray);
+// Gives `tensor` the shape rows x cols, reallocating only if it differs. Contents are unspecified afterwards.
+void ensureShape(Tensors::Tensor2<Real, Int>& tensor, Int rows, Int cols);
+// dst = the row-major rows x cols block at src, reusing dst's buffer when the shape already matches.
+void copyInto(Tensors::Tensor2<Real, Int>& dst, const Real* src, Int rows, Int cols);
+void copyInto(Tensors::Tensor2<Real, Int>& dst, const Tensors::Tensor2<Real, Int>& src);
+Real maxRowNorm(const Tensors::Tensor2<Real, Int>& tensor);  // Largest Euclidean norm of a row, 0 if empty
 std::vector<glm::vec3> tensorToGlmVec3(const Tensors::Tensor2<Real, Int>& T);
 
 // --- Visualization Scaling ---
@@ -32,20 +44,38 @@ std::vector<glm::vec3> scaleVectorsForVisualization(const std::vector<glm::vec3>
                                                     float linearScaleFactor, float targetMaxLog);
 
 // --- Obstacle Combination Data Structure ---
+// Built on scene load and rebuilt only when distance culling changes the source set. Otherwise
+// combined_world_vertices is rewritten in place, source by source, when sources move or deform.
 struct CombinedObstacleGeometry {
+    static constexpr std::uint64_t kNotWritten = ~std::uint64_t{0};
+
     std::vector<std::array<Real, 3>> combined_world_vertices;
     std::vector<std::array<Int, 3>> combined_simplices;
+    std::vector<int> source_ids;             // Runtime object ids, in concatenation order
+    std::vector<Int> source_vertex_offsets;  // First combined vertex of each source, plus total count
     bool success = false;
+    bool layoutChanged = false;  // Source set changed since the obstacle mesh was built; it must be recreated
+    // What each source's block of combined_world_vertices was last written from: the source's coordinate version
+    // and transform. Sources that match are skipped; if none changed, the obstacle mesh needs no refit either.
+    std::vector<std::uint64_t> source_versions;
+    std::vector<glm::mat4> source_transforms;
+    bool coordinatesChanged = false;  // Set by the last write
+    std::vector<Real> source_drift_at_build;  // Each source's cluster tree drift when the obstacle mesh was built
 };
 
-// --- Physics Step Data Structure ---
-struct IterationData {
-    Tensors::Tensor2<Real, Int> world_displacement;
-    bool updated = false;
-};
+// --- Metric Solver State (per object, carried between evaluations) ---
+struct SolverState {
+    Tensors::Tensor2<Real, Int> lastGradient;  // Initial guess for the next metric solve
+    Tensors::Tensor2<Real, Int> residual;      // Warm-start defect d - A g0; scratch, kept to reuse its buffer
+    Real referenceDiffNorm = 0.0;              // Largest differential norm seen, drives the tolerance schedule
 
-// --- UI Helpers ---
-void HelpMarker(const char* desc);
+    // Statistics of the most recent solve, for the UI
+    Real lastTolerance = 0.0;
+    Real lastWarmStartResidual = 1.0;  // ||d - A g0|| / ||d||; 1 means a cold start
+    int lastIterationCap = 0;
+    bool lastSkipped = false;  // Warm start already met the tolerance, no iterations ran
+    long long solveCount = 0;
+};
 
 }  // namespace Utils
 
@@ -0,0 +1,189 @@
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace Log {
+
+namespace detail {
+std::atomic<int> minLevel{static_cast<int>(Level::Info)};
+}
+
+namespace {
+std::mutex g_mutex;  // Guards the sink and serializes delivery
+Sink g_sink;
+
+struct Entry {
+    Level level = Level::Info;
+    std::string message;
+};
+
+// Ring of queued messages; g_queueMutex guards everything in this block.
+std::mutex g_queueMutex;
+bool g_queued = false;
+std::vector<Entry> g_ring;
+std::size_t g_head = 0;  // Oldest entry
+std::size_t g_count = 0;
+std::size_t g_overwritten = 0;
+
+std::mutex g_drainMutex;        // One drain at a time
+std::vector<Entry> g_draining;  // Entries being delivered, swapped out of the ring
+
+void deliver(Level level, const std::string& message) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_sink) {
+        g_sink(level, message);
+        return;
+    }
+
+    switch (level) {
+    case Level::Debug:
+        std::clog << "[debug] " << message << std::endl;
+        break;
+    case Level::Info:
+        std::clog << "[info] " << message << std::endl;
+        break;
+    case Level::Warning:
+        std::cerr << "[warning] " << message << std::endl;
+        break;
+    case Level::Error:
+        std::cerr << "[error] " << message << std::endl;
+        break;
+    }
+}
+
+// False if the message was not queued and must be delivered directly
+bool enqueue(Level level, const std::string& message) {
+    std::lock_guard<std::mutex> lock(g_queueMutex);
+    if (!g_queued) {
+        return false;
+    }
+    if (g_count == g_ring.size()) {
+        g_head = (g_head + 1) % g_ring.size();
+        --g_count;
+        ++g_overwritten;
+    }
+    Entry& entry = g_ring[(g_head + g_count) % g_ring.size()];
+    entry.level = level;
+    entry.message.assign(message);  // Reuses the slot's buffer
+    ++g_count;
+    return true;
+}
+}  // namespace
+
+void setSink(Sink sink) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_sink = std::move(sink);
+}
+
+void setVerbosity(int verbosity) {
+    Level level = verbosity <= 0 ? Level::Error : verbosity == 1 ? Level::Info : Level::Debug;
+    detail::minLevel = static_cast<int>(level);
+}
+
+void write(Level level, const std::string& message) {
+    if (!enqueue(level, message)) {
+        deliver(level, message);
+    }
+}
+
+void debug(const std::string& message) {
+    if (enabled(Level::Debug)) {
+        write(Level::Debug, message);
+    }
+}
+
+void info(const std::string& message) {
+    if (enabled(Level::Info)) {
+        write(Level::Info, message);
+    }
+}
+
+void warning(const std::string& message) {
+    if (enabled(Level::Warning)) {
+        write(Level::Warning, message);
+    }
+}
+
+void error(const std::string& message) {
+    write(Level::Error, message);
+}
+
+namespace detail {
+void append(std::string& out, double value) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    out.append(buffer, static_cast<std::size_t>(std::max(length, 0)));
+}
+}  // namespace detail
+
+// --- Queued Delivery ---
+
+void startQueue(std::size_t capacity) {
+    std::lock_guard<std::mutex> drainLock(g_drainMutex);
+    std::lock_guard<std::mutex> lock(g_queueMutex);
+    if (g_queued) {
+        return;
+    }
+    g_ring.assign(std::max<std::size_t>(capacity, 1), Entry());
+    g_draining.assign(g_ring.size(), Entry());
+    g_head = 0;
+    g_count = 0;
+    g_overwritten = 0;
+    g_queued = true;
+}
+
+void stopQueue() {
+    drain();
+    std::lock_guard<std::mutex> drainLock(g_drainMutex);
+    std::lock_guard<std::mutex> lock(g_queueMutex);
+    g_queued = false;
+    // Messages queued between the drain and here are delivered directly, in order
+    for (std::size_t i = 0; i < g_count; ++i) {
+        const Entry& entry = g_ring[(g_head + i) % g_ring.size()];
+        deliver(entry.level, entry.message);
+    }
+    g_ring.clear();
+    g_draining.clear();
+    g_count = 0;
+}
+
+std::size_t drain() {
+    std::lock_guard<std::mutex> drainLock(g_drainMutex);
+    std::size_t count = 0;
+    std::size_t overwritten = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_queueMutex);
+        if (!g_queued) {
+            return 0;
+        }
+        // Swapping keeps both sets of string buffers alive for reuse
+        for (; count < g_count; ++count) {
+            Entry& entry = g_ring[(g_head + count) % g_ring.size()];
+            std::swap(g_draining[count].message, entry.message);
+            g_draining[count].level = entry.level;
+        }
+        overwritten = g_overwritten;
+        g_head = 0;
+        g_count = 0;
+        g_overwritten = 0;
+    }
+
+    if (overwritten > 0) {
+        deliver(Level::Warning, "Log: " + std::to_string(overwritten) + " message(s) dropped, queue full");
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        deliver(g_draining[i].level, g_draining[i].message);
+    }
+    return count;
+}
+
+bool isQueued() {
+    std::lock_guard<std::mutex> lock(g_queueMutex);
+    return g_queued;
+}
+
+}  // namespace Log
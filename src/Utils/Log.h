@@ -0,0 +1,108 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Logging for code shared by the GUI and headless builds. Messages go to the installed sink;
+// without one they are written to stderr, so stdout stays free for results.
+//
+// Hot paths log through the TPE_LOG_* macros: their arguments are only formatted when the level passes both the
+// runtime verbosity and TPE_LOG_MIN_LEVEL, so a filtered call costs one relaxed atomic load, and calls below the
+// compile-time level are not executed at all.
+//
+//     TPE_LOG_DEBUG("Repulsor state updated for ", object.GetUniqueName());
+namespace Log {
+
+enum class Level { Debug, Info, Warning, Error };
+using Sink = std::function<void(Level level, const std::string& message)>;
+
+void setSink(Sink sink);           // nullptr restores the console sink
+void setVerbosity(int verbosity);  // 0: errors only, 1: info and above (default), 2: everything. Applies to any sink
+
+namespace detail {
+extern std::atomic<int> minLevel;
+}
+
+// False if a message at this level would be dropped, so hot paths can skip building it.
+inline bool enabled(Level level) {
+    return static_cast<int>(level) >= detail::minLevel.load(std::memory_order_relaxed);
+}
+
+void write(Level level, const std::string& message);  // Unfiltered; prefer the functions and macros below
+void debug(const std::string& message);
+void info(const std::string& message);
+void warning(const std::string& message);
+void error(const std::string& message);
+
+// --- Queued Delivery ---
+// Messages go into a fixed ring of `capacity` entries and reach the sink only when drain() runs, on the draining
+// thread. Logging then never waits on the sink, and any thread may log to a sink that is only safe on one thread,
+// like Polyscope's console. When the ring is full the oldest message is overwritten; drain() reports how many were.
+// Entries keep their string buffers, so steady-state logging does not allocate for messages of similar length.
+void startQueue(std::size_t capacity = 1024);
+void stopQueue();     // Drains, then delivers directly again
+std::size_t drain();  // Delivers the queued messages in order; returns how many
+bool isQueued();
+
+// --- Lazy Formatting ---
+namespace detail {
+inline void append(std::string& out, std::string_view text) {
+    out.append(text);
+}
+inline void append(std::string& out, const char* text) {
+    out.append(text);
+}
+inline void append(std::string& out, char c) {
+    out.push_back(c);
+}
+inline void append(std::string& out, bool value) {
+    out.append(value ? "true" : "false");
+}
+template <typename T>
+    requires(std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+void append(std::string& out, T value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+void append(std::string& out, double value);  // %g, like the C++ streams
+inline void append(std::string& out, float value) {
+    append(out, static_cast<double>(value));
+}
+}  // namespace detail
+
+// Concatenates strings, characters and numbers into one message.
+template <typename... Args>
+std::string format(const Args&... args) {
+    std::string out;
+    (detail::append(out, args), ...);
+    return out;
+}
+
+}  // namespace Log
+
+// Compile-time floor: 0 debug, 1 info, 2 warning, 3 error. Release builds may raise it to drop debug logging.
+#ifndef TPE_LOG_MIN_LEVEL
+#define TPE_LOG_MIN_LEVEL 0
+#endif
+
+#define TPE_LOG(level, ...)                                                         \
+    do {                                                                            \
+        if constexpr (static_cast<int>(::Log::Level::level) >= TPE_LOG_MIN_LEVEL) { \
+            if (::Log::enabled(::Log::Level::level)) {                              \
+                ::Log::write(::Log::Level::level, ::Log::format(__VA_ARGS__));      \
+            }                                                                       \
+        }                                                                           \
+    } while (false)
+#define TPE_LOG_DEBUG(...) TPE_LOG(Debug, __VA_ARGS__)
+#define TPE_LOG_INFO(...) TPE_LOG(Info, __VA_ARGS__)
+#define TPE_LOG_WARNING(...) TPE_LOG(Warning, __VA_ARGS__)
+#define TPE_LOG_ERROR(...) TPE_LOG(Error, __VA_ARGS__)
+
+#endif  // LOG_H
@@ -0,0 +1,345 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace Profiler {
+
+namespace {
+
+constexpr std::size_t kMaxTraceEvents = std::size_t(1) << 20;  // 32 MB of samples
+
+// Last kWindowFrames values pushed, in no particular order
+struct Window {
+    std::array<double, kWindowFrames> values{};
+    std::size_t next = 0;
+    std::size_t size = 0;
+
+    void push(double value) {
+        values[next] = value;
+        next = (next + 1) % kWindowFrames;
+        size = std::min(size + 1, kWindowFrames);
+    }
+    double mean() const {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < size; ++i) {
+            sum += values[i];
+        }
+        return size > 0 ? sum / static_cast<double>(size) : 0.0;
+    }
+};
+
+struct FrameTotals {
+    std::array<std::int64_t, kZoneCount> ns{};
+    std::array<int, kZoneCount> calls{};
+
+    void add(const FrameTotals& other) {
+        for (std::size_t z = 0; z < kZoneCount; ++z) {
+            ns[z] += other.ns[z];
+            calls[z] += other.calls[z];
+        }
+    }
+};
+
+struct ZoneHistory {
+    Window window;
+    double lastMs = 0.0;
+    int lastCalls = 0;
+};
+
+struct ObjectHistory {
+    FrameTotals frame;
+    std::array<Window, kZoneCount> windows;
+};
+
+struct TraceEvent {
+    Zone zone;
+    int objectId;
+    int thread;
+    std::int64_t startNs;
+    std::int64_t durationNs;
+};
+
+// Samples of one thread since the last merge. Only its own thread records into it, so its lock is contended only
+// while endFrame, reset or the trace functions merge it.
+struct ThreadBuffer {
+    std::mutex mutex;
+    int thread = 0;
+    FrameTotals frame;
+    std::map<int, FrameTotals> objects;  // Keys are kept across frames, so recording does not allocate once warm
+    std::vector<TraceEvent> trace;
+};
+
+std::mutex g_mutex;  // Guards everything below except the atomics; taken before any buffer's lock
+std::atomic<bool> g_enabled{true};
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;  // Never shrinks: buffers outlive their threads
+std::array<ZoneHistory, kZoneCount> g_zones;
+std::map<int, ObjectHistory> g_objects;
+
+std::atomic<bool> g_tracing{false};
+std::atomic<std::size_t> g_traceEvents{0};  // Reserved across all buffers, so the cap holds without a global lock
+std::atomic<std::size_t> g_droppedEvents{0};
+
+std::atomic<int> g_nextThread{0};
+thread_local int t_objectId = kNoObject;
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer& threadBuffer() {
+    if (!t_buffer) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->thread = g_nextThread++;
+        std::lock_guard<std::mutex> lock(g_mutex);
+        t_buffer = g_buffers.emplace_back(std::move(buffer)).get();
+    }
+    return *t_buffer;
+}
+
+double toMs(std::int64_t ns) {
+    return static_cast<double>(ns) * 1e-6;
+}
+
+// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+}  // namespace
+
+const char* zoneName(Zone zone) {
+    switch (zone) {
+    case Zone::PhysicsStep:
+        return "PhysicsStep";
+    case Zone::InitializeMesh:
+        return "InitializeRepulsorMesh";
+    case Zone::UpdateMeshState:
+        return "UpdateRepulsorMeshState";
+    case Zone::CreateObstacleMesh:
+        return "CreateObstacleMesh";
+    case Zone::LoadObstacle:
+        return "LoadObstacle";
+    case Zone::Energy:
+        return "Energy";
+    case Zone::Differential:
+        return "Differential";
+    case Zone::SelfEnergy:
+        return "SelfEnergy";
+    case Zone::Solve:
+        return "Solve";
+    case Zone::MaximumSafeStepSize:
+        return "MaximumSafeStepSize";
+    case Zone::LineSearch:
+        return "LineSearch";
+    case Zone::ApplyTransform:
+        return "ApplyTransform";
+    case Zone::VisualizationUpdate:
+        return "VisualizationUpdate";
+    case Zone::WorkerLockWait:
+        return "WorkerLockWait";
+    case Zone::Count:
+        break;
+    }
+    return "Unknown";
+}
+
+void setEnabled(bool enabled) {
+    g_enabled = enabled;
+}
+
+bool isEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void record(Zone zone, std::int64_t startNs, std::int64_t durationNs) {
+    const std::size_t z = static_cast<std::size_t>(zone);
+    const int objectId = t_objectId;
+    ThreadBuffer& buffer = threadBuffer();
+
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.frame.ns[z] += durationNs;
+    ++buffer.frame.calls[z];
+    if (objectId != kNoObject) {
+        FrameTotals& objectFrame = buffer.objects[objectId];
+        objectFrame.ns[z] += durationNs;
+        ++objectFrame.calls[z];
+    }
+    if (g_tracing.load(std::memory_order_relaxed)) {
+        if (g_traceEvents.fetch_add(1, std::memory_order_relaxed) < kMaxTraceEvents) {
+            buffer.trace.push_back({zone, objectId, buffer.thread, startNs, durationNs});
+        } else {
+            g_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void endFrame() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    FrameTotals frame;
+    for (const auto& buffer : g_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        frame.add(buffer->frame);
+        buffer->frame = FrameTotals();
+        for (auto& [id, totals] : buffer->objects) {
+            g_objects[id].frame.add(totals);
+            totals = FrameTotals();
+        }
+    }
+
+    for (std::size_t z = 0; z < kZoneCount; ++z) {
+        if (frame.calls[z] > 0) {
+            g_zones[z].lastMs = toMs(frame.ns[z]);
+            g_zones[z].lastCalls = frame.calls[z];
+            g_zones[z].window.push(g_zones[z].lastMs);
+        }
+    }
+
+    for (auto& [id, object] : g_objects) {
+        for (std::size_t z = 0; z < kZoneCount; ++z) {
+            if (object.frame.calls[z] > 0) {
+                object.windows[z].push(toMs(object.frame.ns[z]));
+            }
+        }
+        object.frame = FrameTotals();
+    }
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (const auto& buffer : g_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->frame = FrameTotals();
+        buffer->objects.clear();
+    }
+    g_zones = {};
+    g_objects.clear();
+}
+
+std::vector<ZoneStats> zoneStats() {
+    std::vector<ZoneStats> stats(kZoneCount);
+    std::vector<double> sorted;
+    sorted.reserve(kWindowFrames);
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (std::size_t z = 0; z < kZoneCount; ++z) {
+        const ZoneHistory& history = g_zones[z];
+        ZoneStats& s = stats[z];
+        s.zone = static_cast<Zone>(z);
+        s.frames = static_cast<int>(history.window.size);
+        if (s.frames == 0) {
+            continue;
+        }
+        sorted.assign(history.window.values.begin(), history.window.values.begin() + history.window.size);
+        std::sort(sorted.begin(), sorted.end());
+        s.lastMs = history.lastMs;
+        s.lastCalls = history.lastCalls;
+        s.meanMs = history.window.mean();
+        s.p50Ms = percentile(sorted, 0.50);
+        s.p95Ms = percentile(sorted, 0.95);
+        s.maxMs = sorted.back();
+    }
+    return stats;
+}
+
+std::vector<ObjectStats> objectStats() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    std::vector<ObjectStats> stats;
+    stats.reserve(g_objects.size());
+    for (const auto& [id, object] : g_objects) {
+        ObjectStats& s = stats.emplace_back();
+        s.objectId = id;
+        for (std::size_t z = 0; z < kZoneCount; ++z) {
+            s.meanMs[z] = object.windows[z].mean();
+        }
+        for (Zone zone : {Zone::Energy, Zone::Differential, Zone::SelfEnergy, Zone::Solve, Zone::MaximumSafeStepSize,
+                          Zone::LineSearch}) {
+            s.evaluationMeanMs += s.meanMs[static_cast<std::size_t>(zone)];
+        }
+    }
+    return stats;
+}
+
+// --- Chrome Trace ---
+
+void beginTrace() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (const auto& buffer : g_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->trace.clear();
+    }
+    g_traceEvents = 0;
+    g_droppedEvents = 0;
+    g_tracing = true;
+}
+
+bool isTracing() {
+    return g_tracing;
+}
+
+bool writeTrace(const std::string& path, std::string& error) {
+    std::vector<TraceEvent> events;
+    std::size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_tracing = false;
+        for (const auto& buffer : g_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            events.insert(events.end(), buffer->trace.begin(), buffer->trace.end());
+            buffer->trace = std::vector<TraceEvent>();  // Releases the recording's memory
+        }
+        dropped = g_droppedEvents;
+    }
+
+    std::ofstream out(path);
+    if (!out) {
+        error = "Cannot open '" + path + "' for writing";
+        return false;
+    }
+
+    std::int64_t origin = events.empty() ? 0 : events.front().startNs;
+    for (const TraceEvent& e : events) {
+        origin = std::min(origin, e.startNs);
+    }
+
+    // Complete ("X") events with microsecond timestamps, see the Trace Event Format
+    out << "{\"displayTimeUnit\": \"ms\", \"otherData\": {\"droppedEvents\": " << dropped << "},\n"
+        << "\"traceEvents\": [";
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const TraceEvent& e = events[i];
+        out << (i == 0 ? "\n" : ",\n") << "{\"name\": \"" << zoneName(e.zone) << "\", \"cat\": \"tpe\", \"ph\": \"X\""
+            << ", \"pid\": 1, \"tid\": " << e.thread << ", \"ts\": " << static_cast<double>(e.startNs - origin) * 1e-3
+            << ", \"dur\": " << static_cast<double>(e.durationNs) * 1e-3;
+        if (e.objectId != kNoObject) {
+            out << ", \"args\": {\"object\": " << e.objectId << "}";
+        }
+        out << "}";
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        error = "Failed to write '" + path + "'";
+        return false;
+    }
+    return true;
+}
+
+// --- Object Attribution ---
+
+ObjectScope::ObjectScope(int objectId) : m_previous(t_objectId) {
+    t_objectId = objectId;
+}
+
+ObjectScope::~ObjectScope() {
+    t_objectId = m_previous;
+}
+
+}  // namespace Profiler
@@ -0,0 +1,129 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scoped timers around the hot paths. Samples are summed per frame, per zone and per object; the UI reads rolling
+// statistics over recent frames, and a recording can be written as a Chrome trace (chrome://tracing, Perfetto).
+// Instrument code with the TPE_PROFILE_* macros only: without TPE_PROFILING (CMake option TPE_ENABLE_PROFILING)
+// they expand to nothing, and nothing below is called from the hot paths.
+namespace Profiler {
+
+enum class Zone : std::uint8_t {
+    PhysicsStep,
+    InitializeMesh,
+    UpdateMeshState,
+    CreateObstacleMesh,
+    LoadObstacle,
+    Energy,
+    Differential,
+    SelfEnergy,  // Self-repulsion of an object, when it is not reused from the cache
+    Solve,
+    MaximumSafeStepSize,
+    LineSearch,  // Trial energies of a line search step
+    ApplyTransform,
+    VisualizationUpdate,
+    WorkerLockWait,  // Waiting for RepulsorEngine's energy/metric lock
+    Count
+};
+constexpr std::size_t kZoneCount = static_cast<std::size_t>(Zone::Count);
+constexpr int kNoObject = -1;
+constexpr std::size_t kWindowFrames = 120;  // Frames kept for the rolling statistics
+
+const char* zoneName(Zone zone);
+
+// Per-frame totals of one zone, over the last kWindowFrames frames in which it ran.
+struct ZoneStats {
+    Zone zone = Zone::PhysicsStep;
+    int frames = 0;  // Frames in the window; 0 if the zone has not run
+    double lastMs = 0.0;
+    int lastCalls = 0;
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+// Mean per-frame time of every zone that ran on behalf of one object, over the same windows. Zones nest (mesh
+// updates include ApplyTransform), so they are not summed; evaluationMeanMs covers Energy through MaximumSafeStepSize.
+struct ObjectStats {
+    int objectId = kNoObject;
+    std::array<double, kZoneCount> meanMs{};
+    double evaluationMeanMs = 0.0;
+};
+
+void setEnabled(bool enabled);  // Runtime switch; timers do nothing but one check while disabled
+bool isEnabled();
+
+// Closes the current frame: its totals enter the rolling windows and a new frame starts.
+void endFrame();
+void reset();  // Drops all statistics
+std::vector<ZoneStats> zoneStats();
+std::vector<ObjectStats> objectStats();  // Sorted by object id
+
+// --- Chrome Trace ---
+// Every sample between beginTrace and writeTrace becomes a trace event, up to a fixed cap.
+void beginTrace();
+bool isTracing();
+bool writeTrace(const std::string& path, std::string& error);  // Ends the recording
+
+// --- Recording (use the macros) ---
+inline std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+// Lands in the calling thread's own buffer; endFrame and writeTrace merge the buffers of all threads.
+void record(Zone zone, std::int64_t startNs, std::int64_t durationNs);
+
+class ScopedTimer {
+  public:
+    explicit ScopedTimer(Zone zone) : m_zone(zone), m_start(isEnabled() ? now() : -1) {
+    }
+    ~ScopedTimer() {
+        if (m_start >= 0) {
+            record(m_zone, m_start, now() - m_start);
+        }
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  private:
+    Zone m_zone;
+    std::int64_t m_start;
+};
+
+// Attributes the samples taken on this thread to an object while in scope.
+class ObjectScope {
+  public:
+    explicit ObjectScope(int objectId);
+    ~ObjectScope();
+    ObjectScope(const ObjectScope&) = delete;
+    ObjectScope& operator=(const ObjectScope&) = delete;
+
+  private:
+    int m_previous;
+};
+
+}  // namespace Profiler
+
+#define TPE_PROFILE_CONCAT_INNER(a, b) a##b
+#define TPE_PROFILE_CONCAT(a, b) TPE_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef TPE_PROFILING
+#define TPE_PROFILE_SCOPE(zone) \
+    ::Profiler::ScopedTimer TPE_PROFILE_CONCAT(tpeProfileTimer, __LINE__)(::Profiler::Zone::zone)
+#define TPE_PROFILE_OBJECT(objectId) \
+    ::Profiler::ObjectScope TPE_PROFILE_CONCAT(tpeProfileObject, __LINE__)(objectId)
+#define TPE_PROFILE_END_FRAME() ::Profiler::endFrame()
+#else
+#define TPE_PROFILE_SCOPE(zone) ((void)0)
+#define TPE_PROFILE_OBJECT(objectId) ((void)0)
+#define TPE_PROFILE_END_FRAME() ((void)0)
+#endif
+
+#endif  // PROFILER_H
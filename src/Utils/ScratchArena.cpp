@@ -0,0 +1,76 @@
+#include "ScratchArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Utils {
+
+namespace {
+constexpr std::size_t kMinBlockBytes = 4096;
+}  // namespace
+
+ScratchArena::ScratchArena(std::size_t initialBytes) {
+    if (initialBytes > 0) {
+        m_blocks.push_back({std::unique_ptr<std::byte[]>(new std::byte[initialBytes]), initialBytes});
+        ++m_blockAllocations;
+    }
+}
+
+void ScratchArena::Rewind(const Mark& mark) {
+    m_current = mark.block;
+    m_offset = mark.offset;
+    m_usedBefore = 0;
+    for (std::size_t b = 0; b < m_current && b < m_blocks.size(); ++b) {
+        m_usedBefore += m_blocks[b].size;
+    }
+}
+
+std::size_t ScratchArena::GetCapacity() const {
+    std::size_t capacity = 0;
+    for (const Block& block : m_blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+void* ScratchArena::AllocateBytes(std::size_t bytes, std::size_t alignment) {
+    auto tryBump = [&](Block& block) -> void* {
+        const auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+        const std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+        const std::size_t start = static_cast<std::size_t>(aligned - base);
+        if (start + bytes > block.size) {
+            return nullptr;
+        }
+        m_offset = start + bytes;
+        m_highWater = std::max(m_highWater, m_usedBefore + m_offset);
+        return block.data.get() + start;
+    };
+
+    // Blocks kept from earlier, larger steps are reused in order; whatever a block cannot fit stays unused
+    // until the next rewind.
+    while (m_current < m_blocks.size()) {
+        if (void* p = tryBump(m_blocks[m_current])) {
+            return p;
+        }
+        if (m_current + 1 == m_blocks.size()) {
+            break;
+        }
+        m_usedBefore += m_blocks[m_current].size;
+        ++m_current;
+        m_offset = 0;
+    }
+
+    // Out of space: append a block at least twice the size of the last one.
+    const std::size_t size =
+        std::max(bytes + alignment, m_blocks.empty() ? kMinBlockBytes : 2 * m_blocks.back().size);
+    if (!m_blocks.empty()) {
+        m_usedBefore += m_blocks[m_current].size;
+    }
+    m_blocks.push_back({std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+    ++m_blockAllocations;
+    m_current = m_blocks.size() - 1;
+    m_offset = 0;
+    return tryBump(m_blocks.back());
+}
+
+}  // namespace Utils
@@ -0,0 +1,93 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Utils {
+
+// Bump allocator for short-lived scratch arrays, e.g. the per-step temporaries of a physics step.
+// Memory is only handed back in bulk: Rewind(mark) releases everything allocated since the mark, Reset() everything.
+// Blocks are kept across rewinds, so once the arena has grown to a step's peak usage, later steps do not allocate.
+// Not thread-safe; give each thread its own arena.
+class ScratchArena {
+  public:
+    struct Mark {
+        std::size_t block = 0;
+        std::size_t offset = 0;
+    };
+
+    // Rewinds the arena to where it was at construction when it goes out of scope.
+    class Scope {
+      public:
+        explicit Scope(ScratchArena& arena) : m_arena(arena), m_mark(arena.GetMark()) {
+        }
+        ~Scope() {
+            m_arena.Rewind(m_mark);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        ScratchArena& m_arena;
+        Mark m_mark;
+    };
+
+    explicit ScratchArena(std::size_t initialBytes = 64 * 1024);
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // `count` value-initialized elements, valid until the arena is rewound past this call.
+    template <typename T>
+    std::span<T> Allocate(std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena memory is released without running destructors");
+        if (count == 0) {
+            return {};
+        }
+        T* data = static_cast<T*>(AllocateBytes(count * sizeof(T), alignof(T)));
+        std::uninitialized_value_construct_n(data, count);
+        return {data, count};
+    }
+
+    Mark GetMark() const {
+        return {m_current, m_offset};
+    }
+    void Rewind(const Mark& mark);
+    void Reset() {
+        Rewind(Mark());
+    }
+
+    // --- Statistics ---
+    std::size_t GetCapacity() const;  // Bytes held over all blocks
+    // Most bytes in use at once since construction
+    std::size_t GetHighWater() const {
+        return m_highWater;
+    }
+    // Heap allocations made by the arena so far
+    long long GetBlockAllocations() const {
+        return m_blockAllocations;
+    }
+
+  private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size = 0;
+    };
+
+    void* AllocateBytes(std::size_t bytes, std::size_t alignment);
+
+    std::vector<Block> m_blocks;
+    std::size_t m_current = 0;     // Block currently bumped into
+    std::size_t m_offset = 0;      // First free byte in the current block
+    std::size_t m_usedBefore = 0;  // Bytes of the blocks before m_current, counted in full
+    std::size_t m_highWater = 0;
+    long long m_blockAllocations = 0;
+};
+
+}  // namespace Utils
+
+#endif  // SCRATCH_ARENA_H
@@ -0,0 +1,74 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Utils {
+
+// Bounded lock-free queue between exactly one producer thread and one consumer thread. The slots are constructed
+// once and reused: the producer fills the slot returned by BeginPush in place and publishes it with CommitPush, the
+// consumer reads Front() and releases it with Pop(). Slots keep their buffers, so once they have grown to a
+// message's size neither side allocates.
+template <typename T>
+class SpscQueue {
+  public:
+    explicit SpscQueue(std::size_t capacity) : m_slots(capacity > 0 ? capacity : 1) {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    std::size_t Capacity() const {
+        return m_slots.size();
+    }
+
+    // --- Producer ---
+    // The next free slot, or nullptr if the queue is full. Never blocks.
+    T* BeginPush() {
+        const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == m_slots.size()) {
+            return nullptr;
+        }
+        return &m_slots[head % m_slots.size()];
+    }
+    void CommitPush() {
+        m_head.fetch_add(1, std::memory_order_release);
+        m_head.notify_one();
+    }
+
+    // --- Consumer ---
+    // The oldest published slot, or nullptr if the queue is empty.
+    T* Front() {
+        const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head.load(std::memory_order_acquire) == tail) {
+            return nullptr;
+        }
+        return &m_slots[tail % m_slots.size()];
+    }
+    void Pop() {
+        m_tail.fetch_add(1, std::memory_order_release);
+    }
+    // Blocks until the queue holds at least one slot
+    void WaitForData() {
+        const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        std::uint64_t head = m_head.load(std::memory_order_acquire);
+        while (head == tail) {
+            m_head.wait(head, std::memory_order_acquire);
+            head = m_head.load(std::memory_order_acquire);
+        }
+    }
+
+  private:
+    std::vector<T> m_slots;
+    // Monotonic counters; the slot index is the counter modulo the capacity. Kept on separate cache lines so the
+    // two threads do not contend on the same line.
+    alignas(64) std::atomic<std::uint64_t> m_head{0};  // Written by the producer
+    alignas(64) std::atomic<std::uint64_t> m_tail{0};  // Written by the consumer
+};
+
+}  // namespace Utils
+
+#endif  // SPSC_QUEUE_H
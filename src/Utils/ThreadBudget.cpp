@@ -0,0 +1,68 @@
+#include "ThreadBudget.h"
+
+#include <algorithm>
+
+namespace Utils {
+
+namespace {
+// Threads a mesh of this size can keep busy, within the budget
+int usefulThreads(std::size_t vertexCount, int budget) {
+    const std::size_t useful = (vertexCount + kMinVerticesPerMeshThread - 1) / kMinVerticesPerMeshThread;
+    return static_cast<int>(std::clamp<std::size_t>(useful, 1, static_cast<std::size_t>(budget)));
+}
+}  // namespace
+
+int ThreadSplit::MeshThreadsFor(std::size_t vertexCount) const {
+    if (fixedMeshThreads > 0) {
+        return fixedMeshThreads;
+    }
+    const int useful = usefulThreads(vertexCount, budget);
+    if (objectWorkers < objectCount || totalVertices == 0) {
+        return std::min(useful, meshShare);  // Objects are queued, so every running one gets the even share
+    }
+
+    // All objects run at once: one thread each, the rest by vertex count. Rounding down keeps the sum in budget.
+    const std::size_t spare = static_cast<std::size_t>(std::max(0, budget - objectCount));
+    const int extra = static_cast<int>(spare * vertexCount / totalVertices);
+    return std::min(useful, 1 + extra);
+}
+
+int ThreadSplit::SharedMeshThreadsFor(std::size_t vertexCount) const {
+    if (fixedMeshThreads > 0) {
+        return fixedMeshThreads;
+    }
+    return std::min(usefulThreads(vertexCount, budget), meshShare);
+}
+
+int ThreadSplit::StandaloneMeshThreadsFor(std::size_t vertexCount) const {
+    if (fixedMeshThreads > 0) {
+        return fixedMeshThreads;
+    }
+    return usefulThreads(vertexCount, budget);
+}
+
+ThreadSplit splitThreadBudget(int budget, std::span<const std::size_t> vertexCounts, int fixedObjectWorkers,
+                              int fixedMeshThreads) {
+    ThreadSplit split;
+    split.budget = std::max(1, budget);
+    split.objectCount = static_cast<int>(vertexCounts.size());
+    split.fixedMeshThreads = std::max(0, fixedMeshThreads);
+    for (std::size_t count : vertexCounts) {
+        split.totalVertices += count;
+    }
+    const int objects = std::max(1, split.objectCount);
+
+    if (fixedObjectWorkers > 0) {
+        split.objectWorkers = fixedObjectWorkers;
+    } else if (split.fixedMeshThreads > 0) {
+        split.objectWorkers = std::clamp(split.budget / split.fixedMeshThreads, 1, objects);
+    } else {
+        // Objects first: independent objects scale almost perfectly, Repulsor's inner parallelism does not.
+        // Threads beyond one per object go to the meshes through MeshThreadsFor.
+        split.objectWorkers = std::min(objects, split.budget);
+    }
+    split.meshShare = std::max(1, split.budget / split.objectWorkers);
+    return split;
+}
+
+}  // namespace Utils
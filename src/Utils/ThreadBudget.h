@@ -0,0 +1,43 @@
+#ifndef THREAD_BUDGET_H
+#define THREAD_BUDGET_H
+
+#include <cstddef>
+#include <span>
+
+namespace Utils {
+
+// --- Thread Budget ---
+// How the machine's threads are divided between evaluating objects in parallel and Repulsor's parallelism inside
+// one mesh. At most `objectWorkers` objects run at once and their mesh threads add up to at most `budget`, so the
+// two levels never oversubscribe the machine, however many objects the scene has.
+struct ThreadSplit {
+    int budget = 1;
+    int objectWorkers = 1;  // Objects evaluated at once
+    int meshShare = 1;      // budget / objectWorkers: threads for a mesh evaluated alongside others
+
+    // Repulsor threads for the mesh of a planned object. While every object runs at once, the threads left after
+    // one per object go to the large meshes, in proportion to their vertex counts. Never more than the mesh can
+    // use (see kMinVerticesPerMeshThread).
+    int MeshThreadsFor(std::size_t vertexCount) const;
+    // Same, for meshes evaluated as part of another object's work, e.g. obstacles: capped at the even share.
+    int SharedMeshThreadsFor(std::size_t vertexCount) const;
+    // Same, for a mesh evaluated on its own, e.g. the shared scene mesh: may use the whole budget.
+    int StandaloneMeshThreadsFor(std::size_t vertexCount) const;
+
+    // Plan inputs
+    int objectCount = 0;
+    std::size_t totalVertices = 0;
+    int fixedMeshThreads = 0;  // > 0: user override, every mesh gets exactly this many
+};
+
+// Below this many vertices per thread, Repulsor's overhead outweighs what an extra thread inside one mesh gains.
+constexpr std::size_t kMinVerticesPerMeshThread = 1024;
+
+// Splits `budget` threads for objects with the given vertex counts. fixedObjectWorkers / fixedMeshThreads > 0 pin
+// that level (user settings); the other level then gets what is left.
+ThreadSplit splitThreadBudget(int budget, std::span<const std::size_t> vertexCounts, int fixedObjectWorkers = 0,
+                              int fixedMeshThreads = 0);
+
+}  // namespace Utils
+
+#endif  // THREAD_BUDGET_H
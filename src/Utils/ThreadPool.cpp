@@ -0,0 +1,200 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Utils {
+
+namespace {
+
+#ifdef __linux__
+// Parses a sysfs CPU list such as "0-3,8-11".
+std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        const size_t dash = range.find('-');
+        try {
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            // Malformed entry (e.g. trailing newline only); skip it
+        }
+    }
+    return cpus;
+}
+
+bool pinThread(std::thread& thread, int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+}
+#endif
+
+}  // namespace
+
+ThreadPool::ThreadPool(int threadCount, bool pinThreads) : m_threadCount(std::max(1, threadCount)) {
+    m_workers.reserve(m_threadCount - 1);
+    for (int workerId = 1; workerId < m_threadCount; ++workerId) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this, workerId);
+    }
+
+#ifdef __linux__
+    if (pinThreads) {
+        const std::vector<int> cpus = PlacementOrder();
+        for (size_t k = 0; k < m_workers.size() && !cpus.empty(); ++k) {
+            m_pinnedCount += pinThread(m_workers[k], cpus[(k + 1) % cpus.size()]) ? 1 : 0;  // Worker id k + 1
+        }
+    }
+#else
+    (void)pinThreads;
+#endif
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+int ThreadPool::HardwareThreadCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+std::vector<int> ThreadPool::PlacementOrder() {
+    std::vector<int> order;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return order;
+    }
+
+    // NUMA nodes in id order, each with its CPUs; CPUs outside the process affinity mask are left out.
+    std::map<int, std::vector<int>> nodes;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        std::getline(file, list);
+        nodes[std::stoi(name.substr(4))] = parseCpuList(list);
+    }
+
+    std::set<int> placed;
+    for (const auto& [node, cpus] : nodes) {
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed) && placed.insert(cpu).second) {
+                order.push_back(cpu);
+            }
+        }
+    }
+    // Without NUMA information (or for CPUs it does not list) fall back to plain CPU order.
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed) && !placed.count(cpu)) {
+            order.push_back(cpu);
+        }
+    }
+#endif
+    return order;
+}
+
+void ThreadPool::Dispatch(std::size_t count, TaskRef task, int maxWorkers) {
+    if (count == 0) {
+        return;
+    }
+    int participants = maxWorkers > 0 ? std::min(maxWorkers, m_threadCount) : m_threadCount;
+    participants = static_cast<int>(std::min<std::size_t>(participants, count));
+
+    // Nothing to gain from waking workers for a single item or a single participant.
+    if (participants <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task.call(task.fn, i, 0);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> dispatchLock(m_dispatchMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = task;
+        m_taskCount = count;
+        m_nextIndex.store(0, std::memory_order_relaxed);
+        m_participants = participants;
+        m_activeWorkers = static_cast<int>(m_workers.size());
+        ++m_generation;
+    }
+    m_wakeCondition.notify_all();
+
+    RunTasks(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_activeWorkers == 0; });
+    m_task = TaskRef();
+    m_taskCount = 0;
+}
+
+void ThreadPool::WorkerLoop(int workerId) {
+    std::size_t seenGeneration = 0;
+    while (true) {
+        bool participate = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCondition.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping) {
+                return;
+            }
+            seenGeneration = m_generation;
+            participate = workerId < m_participants;
+        }
+
+        if (participate) {
+            RunTasks(workerId);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeWorkers;
+        }
+        m_doneCondition.notify_one();
+    }
+}
+
+void ThreadPool::RunTasks(int workerId) {
+    while (true) {
+        std::size_t index = m_nextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (index >= m_taskCount) {
+            break;
+        }
+        m_task.call(m_task.fn, index, workerId);
+    }
+}
+
+}  // namespace Utils
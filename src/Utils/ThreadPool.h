@@ -0,0 +1,83 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Utils {
+
+// Fixed-size worker pool for fork/join style loops over independent items.
+// The calling thread participates as worker 0, so a pool of size 1 runs everything inline.
+// With pinThreads, worker k > 0 is bound to the k-th CPU of PlacementOrder(). CPUs are ordered node by node, so the
+// low worker ids that a partial ParallelFor uses stay on as few NUMA nodes as possible. The caller is never pinned.
+class ThreadPool {
+  public:
+    explicit ThreadPool(int threadCount, bool pinThreads = false);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int GetThreadCount() const {
+        return m_threadCount;
+    }
+    int GetPinnedCount() const {  // Workers actually bound to a CPU
+        return m_pinnedCount;
+    }
+
+    // Runs task(i, workerId) for every i in [0, count) and blocks until all are done.
+    // workerId is in [0, GetThreadCount()) and is unique among concurrently running tasks.
+    // Tasks must not throw. Calls are serialized; calling ParallelFor from inside a task is not supported.
+    // The task is only referenced, never copied, so dispatching a capturing lambda does not allocate.
+    // maxWorkers > 0 limits the workers taking part (ids 0 .. maxWorkers - 1); the others stay idle.
+    template <typename Fn>
+    void ParallelFor(std::size_t count, Fn&& task, int maxWorkers = 0) {
+        using F = std::remove_reference_t<Fn>;
+        TaskRef ref;
+        ref.fn = const_cast<void*>(static_cast<const void*>(std::addressof(task)));
+        ref.call = [](void* fn, std::size_t index, int workerId) { (*static_cast<F*>(fn))(index, workerId); };
+        Dispatch(count, ref, maxWorkers);
+    }
+
+    static int HardwareThreadCount();
+    // CPUs this process may run on, grouped by NUMA node. Empty where the platform does not report them.
+    static std::vector<int> PlacementOrder();
+
+  private:
+    // Type-erased, non-owning reference to the task of the running ParallelFor
+    struct TaskRef {
+        void* fn = nullptr;
+        void (*call)(void* fn, std::size_t index, int workerId) = nullptr;
+    };
+
+    void Dispatch(std::size_t count, TaskRef task, int maxWorkers);
+    void WorkerLoop(int workerId);
+    void RunTasks(int workerId);
+
+    int m_threadCount = 1;
+    int m_pinnedCount = 0;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_dispatchMutex;  // Serializes ParallelFor callers
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_doneCondition;
+
+    TaskRef m_task;
+    std::size_t m_taskCount = 0;
+    int m_participants = 0;  // Workers of the running ParallelFor that take tasks
+    std::atomic<std::size_t> m_nextIndex{0};
+    std::size_t m_generation = 0;
+    int m_activeWorkers = 0;
+    bool m_stopping = false;
+};
+
+}  // namespace Utils
+
+#endif  // THREAD_POOL_H
@@ -0,0 +1,181 @@
+#include "TransformKernels.h"
+
+#include <cmath>
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define TPE_TRANSFORM_KERNELS_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace Utils {
+
+// --- Affine Transforms ---
+AffineTransform AffineTransform::FromMat4(const glm::mat4& mat) {
+    AffineTransform t;
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            t.m[4 * r + c] = static_cast<Real>(mat[c][r]);  // glm is column-major
+        }
+    }
+    return t;
+}
+
+AffineTransform AffineTransform::Inverse() const {
+    const Real a = m[0], b = m[1], c = m[2];
+    const Real d = m[4], e = m[5], f = m[6];
+    const Real g = m[8], h = m[9], i = m[10];
+
+    const Real c00 = e * i - f * h, c01 = c * h - b * i, c02 = b * f - c * e;
+    const Real c10 = f * g - d * i, c11 = a * i - c * g, c12 = c * d - a * f;
+    const Real c20 = d * h - e * g, c21 = b * g - a * h, c22 = a * e - b * d;
+    const Real invDet = 1.0 / (a * c00 + b * c10 + c * c20);
+
+    AffineTransform inv;
+    inv.m = {c00 * invDet, c01 * invDet, c02 * invDet, 0.0, c10 * invDet, c11 * invDet,
+             c12 * invDet, 0.0,          c20 * invDet, c21 * invDet, c22 * invDet, 0.0};
+    for (int r = 0; r < 3; ++r) {
+        inv.m[4 * r + 3] = -(inv.m[4 * r] * m[3] + inv.m[4 * r + 1] * m[7] + inv.m[4 * r + 2] * m[11]);
+    }
+    return inv;
+}
+
+// --- Batch Kernels ---
+namespace {
+
+inline void transformPoint(const AffineTransform& t, const Real* p, Real* out) {
+    const Real x = p[0], y = p[1], z = p[2];
+    out[0] = t.m[0] * x + t.m[1] * y + t.m[2] * z + t.m[3];
+    out[1] = t.m[4] * x + t.m[5] * y + t.m[6] * z + t.m[7];
+    out[2] = t.m[8] * x + t.m[9] * y + t.m[10] * z + t.m[11];
+}
+
+inline void addLinear(const AffineTransform& t, const Real* v, Real* inOut) {
+    const Real x = v[0], y = v[1], z = v[2];
+    inOut[0] += t.m[0] * x + t.m[1] * y + t.m[2] * z;
+    inOut[1] += t.m[4] * x + t.m[5] * y + t.m[6] * z;
+    inOut[2] += t.m[8] * x + t.m[9] * y + t.m[10] * z;
+}
+
+#ifdef TPE_TRANSFORM_KERNELS_AVX2
+// Four interleaved points (three registers) to and from one register per coordinate.
+inline void load4(const Real* p, __m256d& x, __m256d& y, __m256d& z) {
+    const __m256d a = _mm256_loadu_pd(p);      // x0 y0 z0 x1
+    const __m256d b = _mm256_loadu_pd(p + 4);  // y1 z1 x2 y2
+    const __m256d c = _mm256_loadu_pd(p + 8);  // z2 x3 y3 z3
+    const __m256d xy02 = _mm256_permute2f128_pd(a, b, 0x30);  // x0 y0 x2 y2
+    const __m256d zx13 = _mm256_permute2f128_pd(a, c, 0x21);  // z0 x1 z2 x3
+    const __m256d yz13 = _mm256_permute2f128_pd(b, c, 0x30);  // y1 z1 y3 z3
+    x = _mm256_shuffle_pd(xy02, zx13, 0b1010);
+    y = _mm256_shuffle_pd(xy02, yz13, 0b0101);
+    z = _mm256_shuffle_pd(zx13, yz13, 0b1010);
+}
+
+inline void store4(Real* p, __m256d x, __m256d y, __m256d z) {
+    const __m256d xy02 = _mm256_shuffle_pd(x, y, 0b0000);
+    const __m256d zx13 = _mm256_shuffle_pd(z, x, 0b1010);
+    const __m256d yz13 = _mm256_shuffle_pd(y, z, 0b1111);
+    _mm256_storeu_pd(p, _mm256_permute2f128_pd(xy02, zx13, 0x20));
+    _mm256_storeu_pd(p + 4, _mm256_permute2f128_pd(yz13, xy02, 0x30));
+    _mm256_storeu_pd(p + 8, _mm256_permute2f128_pd(zx13, yz13, 0x31));
+}
+
+struct Rows {
+    __m256d m[12];
+    explicit Rows(const AffineTransform& t) {
+        for (int k = 0; k < 12; ++k) {
+            m[k] = _mm256_set1_pd(t.m[k]);
+        }
+    }
+    // Row r of (linear part * v), plus `add`
+    __m256d Row(int r, __m256d x, __m256d y, __m256d z, __m256d add) const {
+        return _mm256_fmadd_pd(m[4 * r + 2], z, _mm256_fmadd_pd(m[4 * r + 1], y, _mm256_fmadd_pd(m[4 * r], x, add)));
+    }
+};
+#endif
+
+}  // namespace
+
+void transformPoints(const AffineTransform& transform, const Real* in, Real* out, size_t count) {
+    size_t i = 0;
+#ifdef TPE_TRANSFORM_KERNELS_AVX2
+    const Rows t(transform);
+    for (; i + 4 <= count; i += 4) {
+        __m256d x, y, z;
+        load4(in + 3 * i, x, y, z);
+        store4(out + 3 * i, t.Row(0, x, y, z, t.m[3]), t.Row(1, x, y, z, t.m[7]), t.Row(2, x, y, z, t.m[11]));
+    }
+#endif
+    for (; i < count; ++i) {
+        transformPoint(transform, in + 3 * i, out + 3 * i);
+    }
+}
+
+void applyWorldDisplacement(const AffineTransform& transform, const AffineTransform& inverse, const Real* worldDelta,
+                            Real* local, Real* world, size_t count) {
+    size_t i = 0;
+#ifdef TPE_TRANSFORM_KERNELS_AVX2
+    const Rows t(transform);
+    const Rows inv(inverse);
+    for (; i + 4 <= count; i += 4) {
+        __m256d dx, dy, dz, x, y, z;
+        load4(worldDelta + 3 * i, dx, dy, dz);
+        load4(local + 3 * i, x, y, z);
+        x = inv.Row(0, dx, dy, dz, x);
+        y = inv.Row(1, dx, dy, dz, y);
+        z = inv.Row(2, dx, dy, dz, z);
+        store4(local + 3 * i, x, y, z);
+        store4(world + 3 * i, t.Row(0, x, y, z, t.m[3]), t.Row(1, x, y, z, t.m[7]), t.Row(2, x, y, z, t.m[11]));
+    }
+#endif
+    for (; i < count; ++i) {
+        addLinear(inverse, worldDelta + 3 * i, local + 3 * i);
+        transformPoint(transform, local + 3 * i, world + 3 * i);
+    }
+}
+
+void addTransformedVectors(const AffineTransform& transform, const Real* in, Real* inOut, size_t count) {
+    size_t i = 0;
+#ifdef TPE_TRANSFORM_KERNELS_AVX2
+    const Rows t(transform);
+    for (; i + 4 <= count; i += 4) {
+        __m256d vx, vy, vz, x, y, z;
+        load4(in + 3 * i, vx, vy, vz);
+        load4(inOut + 3 * i, x, y, z);
+        store4(inOut + 3 * i, t.Row(0, vx, vy, vz, x), t.Row(1, vx, vy, vz, y), t.Row(2, vx, vy, vz, z));
+    }
+#endif
+    for (; i < count; ++i) {
+        addLinear(transform, in + 3 * i, inOut + 3 * i);
+    }
+}
+
+bool rigidChange(const AffineTransform& from, const AffineTransform& to, AffineTransform& change, Real tolerance) {
+    const AffineTransform inv = from.Inverse();
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            change.m[4 * r + c] =
+                to.m[4 * r] * inv.m[c] + to.m[4 * r + 1] * inv.m[4 + c] + to.m[4 * r + 2] * inv.m[8 + c];
+        }
+        change.m[4 * r + 3] = 0.0;
+    }
+    for (int a = 0; a < 3; ++a) {
+        for (int b = a; b < 3; ++b) {
+            const Real dot = change.m[a] * change.m[b] + change.m[4 + a] * change.m[4 + b] +
+                             change.m[8 + a] * change.m[8 + b];
+            if (!(std::abs(dot - (a == b ? 1.0 : 0.0)) <= tolerance)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool transformKernelsVectorized() {
+#ifdef TPE_TRANSFORM_KERNELS_AVX2
+    return true;
+#else
+    return false;
+#endif
+}
+
+}  // namespace Utils
@@ -0,0 +1,46 @@
+#ifndef TRANSFORM_KERNELS_H
+#define TRANSFORM_KERNELS_H
+
+#include <array>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "GlobalTypes.h"
+
+namespace Utils {
+
+// --- Affine Transforms ---
+// Row-major 3x4 affine map in double precision. Built once per object and call, so coordinates never
+// round-trip through float the way glm::mat4 * glm::vec4 does.
+struct AffineTransform {
+    std::array<Real, 12> m{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0};  // Row r is m[4r .. 4r + 3]
+
+    static AffineTransform FromMat4(const glm::mat4& mat);
+    AffineTransform Inverse() const;  // Assumes an invertible linear part
+};
+
+// --- Batch Kernels ---
+// Buffers hold `count` xyz-interleaved points (stride 3), i.e. the layout of std::vector<std::array<Real, 3>>
+// and of row-major Tensor2 coordinates. Built with TPE_ENABLE_AVX2, four points are processed per iteration.
+
+// out[i] = transform * in[i]. in and out may be the same buffer.
+void transformPoints(const AffineTransform& transform, const Real* in, Real* out, size_t count);
+
+// Fused physics update in one pass: local[i] += linear(inverse) * worldDelta[i], then world[i] = transform * local[i].
+void applyWorldDisplacement(const AffineTransform& transform, const AffineTransform& inverse, const Real* worldDelta,
+                            Real* local, Real* world, size_t count);
+
+// inOut[i] += linear(transform) * in[i]: moves vectors (differentials, directions) into another frame and adds them.
+void addTransformedVectors(const AffineTransform& transform, const Real* in, Real* inOut, size_t count);
+
+// If `to` differs from `from` by a rigid motion (rotation or reflection, plus any translation), sets `change` to the
+// linear map taking vectors of the `from` frame to the `to` frame and returns true. False if the motion also
+// scales or shears, beyond `tolerance` in the entries of change^T * change - I.
+bool rigidChange(const AffineTransform& from, const AffineTransform& to, AffineTransform& change,
+                 Real tolerance = 1e-5);
+
+bool transformKernelsVectorized();  // True if the AVX2 path was compiled in
+
+}  // namespace Utils
+
+#endif  // TRANSFORM_KERNELS_H